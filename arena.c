@@ -0,0 +1,170 @@
+#include "arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "errors.h"
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+#define ALIGN_UP(_n) (((_n) + (ARENA_ALIGNMENT - 1)) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+
+/* A chunk of memory the arena hands out allocations from */
+typedef struct arena_block_t {
+    struct arena_block_t *next;
+    size_t size;
+    size_t used;
+    char *data;
+} *ArenaBlock;
+
+/* A region allocator - everything allocated from it is released at once by arenaReset or arenaDestroy. The blocks are
+ * kept on reset, so an arena that is reused does not go back to malloc. */
+struct arena_t {
+    ArenaBlock head;
+    ArenaBlock current;
+
+    size_t bytes_used;
+    size_t high_water_mark;
+};
+
+/**
+ * It allocates a new block of at least the given size.
+ *
+ * @param min_size The size of the allocation the block must fit.
+ */
+static ArenaBlock arenaBlockCreate(size_t min_size) {
+    size_t size = min_size > ARENA_BLOCK_SIZE ? min_size : ARENA_BLOCK_SIZE;
+
+    ArenaBlock block = malloc(sizeof(*block));
+    if (!block)
+        memoryAllocationError();
+
+    block->data = malloc(size);
+    if (!block->data)
+        memoryAllocationError();
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+/**
+ * It creates an empty arena.
+ */
+Arena arenaCreate(void) {
+    Arena arena = malloc(sizeof(*arena));
+    if (!arena)
+        memoryAllocationError();
+
+    arena->head = arenaBlockCreate(ARENA_BLOCK_SIZE);
+    arena->current = arena->head;
+    arena->bytes_used = 0;
+    arena->high_water_mark = 0;
+    return arena;
+}
+
+/**
+ * It allocates memory from the arena. The memory is valid until the arena is reset or destroyed.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ */
+void *arenaAlloc(Arena arena, size_t size) {
+    size = ALIGN_UP(size ? size : 1);
+
+    /* Moving on to the next block (kept from before a reset, or a new one) when the current one is full. */
+    while (arena->current->size - arena->current->used < size) {
+        if (!arena->current->next) {
+            arena->current->next = arenaBlockCreate(size);
+        }
+        arena->current = arena->current->next;
+    }
+
+    void *p = arena->current->data + arena->current->used;
+    arena->current->used += size;
+
+    arena->bytes_used += size;
+    if (arena->bytes_used > arena->high_water_mark) {
+        arena->high_water_mark = arena->bytes_used;
+    }
+    return p;
+}
+
+/**
+ * It copies the string into the arena.
+ *
+ * @param arena The arena to allocate from.
+ * @param s The string to copy.
+ */
+char *arenaStrdup(Arena arena, const char *s) {
+    return arenaStrndup(arena, s, strlen(s));
+}
+
+/**
+ * It copies at most n characters of the string into the arena.
+ *
+ * @param arena The arena to allocate from.
+ * @param s The string to copy.
+ * @param n The number of characters to copy.
+ */
+char *arenaStrndup(Arena arena, const char *s, size_t n) {
+    size_t len = 0;
+    while (len < n && s[len] != '\0')
+        len++;
+
+    char *p = arenaAlloc(arena, len + 1);
+    memcpy(p, s, len);
+    p[len] = '\0';
+    return p;
+}
+
+/**
+ * It releases everything allocated from the arena in one go, keeping the blocks for reuse.
+ *
+ * @param arena The arena to reset.
+ */
+void arenaReset(Arena arena) {
+    for (ArenaBlock block = arena->head; block; block = block->next) {
+        block->used = 0;
+    }
+    arena->current = arena->head;
+    arena->bytes_used = 0;
+}
+
+/**
+ * It returns the largest number of bytes that were allocated from the arena at the same time.
+ *
+ * @param arena The arena.
+ */
+size_t arenaGetHighWaterMark(Arena arena) {
+    return arena->high_water_mark;
+}
+
+/**
+ * It starts measuring the high-water mark of the arena again, from what is allocated from it now.
+ *
+ * @param arena The arena.
+ */
+void arenaResetHighWaterMark(Arena arena) {
+    arena->high_water_mark = arena->bytes_used;
+}
+
+/**
+ * It destroys the arena and everything allocated from it.
+ *
+ * @param arena The arena to destroy.
+ */
+void arenaDestroy(Arena arena) {
+    if (!arena)
+        return;
+
+    while (arena->head) {
+        ArenaBlock to_delete = arena->head;
+        arena->head = arena->head->next;
+        free(to_delete->data);
+        free(to_delete);
+    }
+    free(arena);
+}
@@ -0,0 +1,24 @@
+#ifndef ASSEMBLER_ARENA_H
+#define ASSEMBLER_ARENA_H
+
+#include <stddef.h>
+
+typedef struct arena_t *Arena;
+
+Arena arenaCreate(void);
+
+void *arenaAlloc(Arena arena, size_t size);
+
+char *arenaStrdup(Arena arena, const char *s);
+
+char *arenaStrndup(Arena arena, const char *s, size_t n);
+
+void arenaReset(Arena arena);
+
+size_t arenaGetHighWaterMark(Arena arena);
+
+void arenaResetHighWaterMark(Arena arena);
+
+void arenaDestroy(Arena arena);
+
+#endif //ASSEMBLER_ARENA_H
@@ -0,0 +1,543 @@
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include "assembler.h"
+#include "assembly_context.h"
+#include "pre_assembly.h"
+#include "first_pass.h"
+#include "second_pass.h"
+#include "incremental.h"
+#include "const_tables.h"
+#include "base_conversion.h"
+#include "str_utils.h"
+#include "errors.h"
+
+
+/* The result of assembling a file, and the state of the passes that produced it. */
+struct assembly_result_t {
+    /* The arena the results live in, and the diagnostics. */
+    AssemblyContext ctx;
+    AssemblyStatus status;
+
+    /* The state of the passes - released as soon as the file is assembled, or an allocation fails. */
+    Vector statements;
+    Symtab symtab;
+    Vector entry_statements;
+    Fixups fixups;
+
+    MachineCode machine_code;
+    MemoryCode memory_code;
+    SymbolList entry_symbols;
+    SymbolList extern_uses;
+    StrBuffer am;
+};
+
+/* A file that is assembled again and again as it is edited. The state of the passes of its last assembly is kept, with
+ * an index of what each line of the source became, so that an edit only has the lines it changed assembled again. */
+struct assembly_session_t {
+    char *filename;
+    AssemblyOptions options;
+    struct assembly_result_t result;
+
+    IncrementalIndex index; // NULL unless the last assembly succeeded
+    size_t full_high_water_mark; // of the last full assembly
+    bool incremental; // whether the last assembly was incremental
+};
+
+
+/**
+ * It runs the whole pipeline (pre-assembly, first-pass and second-pass) for a single file, stopping at the first stage
+ * that fails. Everything it creates is recorded in the result as soon as it is created, so it can be released even if
+ * an allocation fails midway.
+ *
+ * @param result The result to fill - empty, or with the context of an earlier assembly of the file, reset.
+ * @param filename The name of the file (without suffix), for the diagnostics.
+ * @param source The content of the .as file.
+ * @param size The size of the content.
+ * @param options The options to assemble the file with.
+ * @param index The index to record what the passes made of the source in, or NULL.
+ */
+static void runPipeline(AssemblyResult result, const char *filename, const char *source, size_t size,
+                        const AssemblyOptions *options, IncrementalIndex index) {
+    if (!result->ctx)
+        result->ctx = assemblyContextCreate(filename, options);
+    AssemblyContext ctx = result->ctx;
+    Diagnostics diags = assemblyContextGetDiagnostics(ctx);
+    assemblyContextSetSourceFile(ctx, sourceFileCreate(source, size));
+
+    if (!run_pre_assembly(ctx, &result->am, &result->statements, index)) {
+        result->status = ASSEMBLY_PRE_ASSEMBLY_FAILED;
+        return;
+    }
+
+    diagnosticsSetStage(diags, STAGE_FIRST_PASS);
+    if (!run_first_pass(ctx, result->statements, &result->symtab, &result->machine_code, &result->memory_code,
+                        &result->entry_statements, &result->fixups, index)) {
+        result->status = ASSEMBLY_FIRST_PASS_FAILED;
+        return;
+    }
+
+    diagnosticsSetStage(diags, STAGE_SECOND_PASS);
+    if (!run_second_pass(ctx, result->symtab, result->machine_code, result->entry_statements, result->fixups,
+                         &result->entry_symbols, &result->extern_uses)) {
+        result->status = ASSEMBLY_SECOND_PASS_FAILED;
+        return;
+    }
+    result->status = ASSEMBLY_SUCCESS;
+}
+
+/**
+ * It releases the source file of the assembly, which is only borrowed for the duration of the assembly.
+ *
+ * @param result The result.
+ */
+static void releaseSourceFile(AssemblyResult result) {
+    if (result->ctx) {
+        sourceFileDestroy(assemblyContextGetSourceFile(result->ctx));
+        assemblyContextSetSourceFile(result->ctx, NULL);
+    }
+}
+
+/**
+ * It releases the state of the passes, which the results don't need.
+ *
+ * @param result The result.
+ */
+static void releasePasses(AssemblyResult result) {
+    vectorDestroy(result->statements);
+    symtabDestroy(result->symtab);
+    vectorDestroy(result->entry_statements);
+    fixupsDestroy(result->fixups);
+    result->statements = NULL;
+    result->symtab = NULL;
+    result->entry_statements = NULL;
+    result->fixups = NULL;
+    releaseSourceFile(result);
+}
+
+/**
+ * It releases everything in the result, leaving it empty.
+ *
+ * @param result The result.
+ */
+static void clearResult(AssemblyResult result) {
+    releasePasses(result);
+    machineCodeDestroy(result->machine_code);
+    memoryCodeDestroy(result->memory_code);
+    strBufferFree(&result->am);
+    assemblyContextDestroy(result->ctx);
+    memset(result, 0, sizeof(*result));
+}
+
+/**
+ * It releases everything in the result but its context, which is reset for another assembly of the same file - so the
+ * blocks of its arena are reused instead of allocated again.
+ *
+ * @param result The result.
+ */
+static void resetResult(AssemblyResult result) {
+    AssemblyContext ctx = result->ctx;
+    releasePasses(result);
+    result->ctx = NULL;
+    clearResult(result);
+    if (ctx)
+        assemblyContextReset(ctx);
+    result->ctx = ctx;
+}
+
+/**
+ * It assembles a source held in memory. Nothing is read or written to the file system - the .am text and the content
+ * of the output files are in the result. It can be called concurrently from any number of threads.
+ *
+ * @param filename The name of the file (without suffix), for the diagnostics.
+ * @param source The content of the .as file, which only has to be valid for the duration of the call.
+ * @param size The size of the content.
+ * @param options The options to assemble the file with.
+ *
+ * @return The result, to be destroyed with assemblyResultDestroy, or NULL if there isn't even memory for it. If
+ * another allocation fails, the status of the result is ASSEMBLY_OUT_OF_MEMORY.
+ */
+AssemblyResult assemble(const char *filename, const char *source, size_t size, const AssemblyOptions *options) {
+    AssemblyResult result = calloc(1, sizeof(*result));
+    if (!result)
+        return NULL;
+
+    jmp_buf recovery_point;
+    jmp_buf *previous_recovery_point = errorsSetRecoveryPoint(&recovery_point);
+    if (setjmp(recovery_point) == 0) {
+        runPipeline(result, filename, source, size, options, NULL);
+    } else {
+        /* An allocation failed - only what is certainly consistent, the context, is kept. */
+        result->status = ASSEMBLY_OUT_OF_MEMORY;
+        machineCodeDestroy(result->machine_code);
+        memoryCodeDestroy(result->memory_code);
+        strBufferFree(&result->am);
+        result->machine_code = NULL;
+        result->memory_code = NULL;
+        memset(&result->entry_symbols, 0, sizeof(result->entry_symbols));
+        memset(&result->extern_uses, 0, sizeof(result->extern_uses));
+    }
+    errorsSetRecoveryPoint(previous_recovery_point);
+
+    releasePasses(result);
+    return result;
+}
+
+/**
+ * It destroys the result of an assembly, and everything in it.
+ *
+ * @param result The result to destroy.
+ */
+void assemblyResultDestroy(AssemblyResult result) {
+    if (!result)
+        return;
+
+    clearResult(result);
+    free(result);
+}
+
+/**
+ * It creates a session for assembling a file again and again as it is edited.
+ *
+ * @param filename The name of the file (without suffix), for the diagnostics.
+ * @param options The options to assemble the file with.
+ *
+ * @return The session, to be destroyed with assemblySessionDestroy, or NULL if there isn't memory for it.
+ */
+AssemblySession assemblySessionCreate(const char *filename, const AssemblyOptions *options) {
+    AssemblySession session = calloc(1, sizeof(*session));
+    if (!session)
+        return NULL;
+
+    session->filename = malloc(strlen(filename) + 1);
+    if (!session->filename) {
+        free(session);
+        return NULL;
+    }
+    strcpy(session->filename, filename);
+    session->options = *options;
+    return session;
+}
+
+/**
+ * It destroys a session, and the result of its last assembly.
+ *
+ * @param session The session to destroy.
+ */
+void assemblySessionDestroy(AssemblySession session) {
+    if (!session)
+        return;
+
+    clearResult(&session->result);
+    incrementalIndexDestroy(session->index);
+    free(session->filename);
+    free(session);
+}
+
+/**
+ * It assembles the source of the session's file in full, in the arena of its last assembly, keeping the state of the
+ * passes and the index of the source if the assembly succeeds.
+ *
+ * @param session The session.
+ * @param source The source.
+ * @param size The size of the source.
+ */
+static void assembleSessionInFull(AssemblySession session, const char *source, size_t size) {
+    AssemblyResult result = &session->result;
+    resetResult(result);
+    incrementalIndexDestroy(session->index);
+    session->index = NULL;
+
+    /* The statements borrow their text from the source, so the copy in the index is the one assembled. */
+    session->index = incrementalIndexCreate(source, size);
+    runPipeline(result, session->filename, incrementalIndexGetSource(session->index), size, &session->options,
+                session->index);
+    releaseSourceFile(result);
+    if (result->status == ASSEMBLY_SUCCESS) {
+        session->full_high_water_mark = assemblyContextGetHighWaterMark(result->ctx);
+    } else {
+        releasePasses(result);
+        incrementalIndexDestroy(session->index);
+        session->index = NULL;
+    }
+}
+
+/**
+ * It assembles the current source of the session's file. If the last assembly succeeded, only the lines that changed
+ * since are assembled again, unless the edit is one the passes have to see all of - a change to a macro, to which
+ * symbols are defined where, or one that has errors - and then the file is assembled in full, with the same result.
+ * The statements of the edits live in the arena along with the old ones, so the file is also assembled in full once
+ * they double the arena.
+ *
+ * @param session The session.
+ * @param source The content of the .as file, which only has to be valid for the duration of the call.
+ * @param size The size of the content.
+ *
+ * @return The result, which belongs to the session and is valid until its next assembly. If an allocation fails, the
+ * status of the result is ASSEMBLY_OUT_OF_MEMORY, and the next assembly is a full one.
+ */
+AssemblyResult assemblySessionAssemble(AssemblySession session, const char *source, size_t size) {
+    AssemblyResult result = &session->result;
+
+    jmp_buf recovery_point;
+    jmp_buf *previous_recovery_point = errorsSetRecoveryPoint(&recovery_point);
+    if (setjmp(recovery_point) == 0) {
+        session->incremental = session->index &&
+                               assemblyContextGetHighWaterMark(result->ctx) <= 2 * session->full_high_water_mark &&
+                               incrementalReassemble(session->index, result->ctx, source, size, result->statements,
+                                                     result->symtab, result->machine_code, result->memory_code,
+                                                     session->options.keep_am ? &result->am : NULL,
+                                                     &result->entry_symbols, &result->extern_uses);
+        if (!session->incremental)
+            assembleSessionInFull(session, source, size);
+    } else {
+        clearResult(result);
+        result->status = ASSEMBLY_OUT_OF_MEMORY;
+        incrementalIndexDestroy(session->index);
+        session->index = NULL;
+        session->incremental = false;
+    }
+    errorsSetRecoveryPoint(previous_recovery_point);
+    return result;
+}
+
+/**
+ * It returns the words whose lines in the object file the last assembly of the session changed, if it was incremental.
+ * The words are numbered from the first word of the code, and the data follows the code - so the line of word i is line
+ * i + 1 of the object file, after the header line.
+ *
+ * @param session The session.
+ * @param first Set to the first changed word.
+ * @param end Set to one past the last changed word - the range is empty if nothing changed.
+ *
+ * @return false if the last assembly was a full one, so every line may have changed, true otherwise.
+ */
+bool assemblySessionGetChangedWords(AssemblySession session, size_t *first, size_t *end) {
+    if (!session->incremental)
+        return false;
+
+    incrementalIndexGetChangedWords(session->index, first, end);
+    return true;
+}
+
+/**
+ * It returns how far the assembly got.
+ *
+ * @param result The result of the assembly.
+ */
+AssemblyStatus assemblyResultGetStatus(AssemblyResult result) {
+    return result->status;
+}
+
+/**
+ * It returns the number of errors found in the source.
+ *
+ * @param result The result of the assembly.
+ */
+int assemblyResultGetDiagnosticsCount(AssemblyResult result) {
+    return result->ctx ? diagnosticsCount(assemblyContextGetDiagnostics(result->ctx)) : 0;
+}
+
+/**
+ * It returns an error found in the source, in the order the errors were found.
+ *
+ * @param result The result of the assembly.
+ * @param index The index of the error.
+ */
+const AssemblyDiagnostic *assemblyResultGetDiagnosticAt(AssemblyResult result, int index) {
+    return diagnosticsGetAt(assemblyContextGetDiagnostics(result->ctx), index);
+}
+
+/**
+ * It returns the words of the code, loaded from START_ADDRESS_OFFSET. They are final only if the assembly succeeded.
+ *
+ * @param result The result of the assembly.
+ * @param size Set to the number of words.
+ */
+const unsigned short *assemblyResultGetCode(AssemblyResult result, size_t *size) {
+    *size = result->machine_code ? machineCodeGetSize(result->machine_code) : 0;
+    return result->machine_code ? machineCodeGetWords(result->machine_code) : NULL;
+}
+
+/**
+ * It returns the words of the data, loaded right after the code.
+ *
+ * @param result The result of the assembly.
+ * @param size Set to the number of words.
+ */
+const unsigned short *assemblyResultGetData(AssemblyResult result, size_t *size) {
+    *size = result->memory_code ? memoryCodeGetSize(result->memory_code) : 0;
+    return result->memory_code ? memoryCodeGetWords(result->memory_code) : NULL;
+}
+
+/**
+ * It returns the number of .entry symbols.
+ *
+ * @param result The result of the assembly.
+ */
+int assemblyResultGetEntriesCount(AssemblyResult result) {
+    return result->entry_symbols.count;
+}
+
+/**
+ * It returns an .entry symbol and its address, in the order the symbols were defined.
+ *
+ * @param result The result of the assembly.
+ * @param index The index of the symbol.
+ */
+const AssemblySymbol *assemblyResultGetEntryAt(AssemblyResult result, int index) {
+    return &result->entry_symbols.symbols[index];
+}
+
+/**
+ * It returns the number of operands that use extern symbols.
+ *
+ * @param result The result of the assembly.
+ */
+int assemblyResultGetExternUsesCount(AssemblyResult result) {
+    return result->extern_uses.count;
+}
+
+/**
+ * It returns an extern symbol and the address of the word that uses it, by the order of the addresses.
+ *
+ * @param result The result of the assembly.
+ * @param index The index of the use.
+ */
+const AssemblySymbol *assemblyResultGetExternUseAt(AssemblyResult result, int index) {
+    return &result->extern_uses.symbols[index];
+}
+
+/**
+ * It returns the macro-expanded source, the content of the .am file. It is only kept if the keep_am option is set.
+ *
+ * @param result The result of the assembly.
+ * @param size Set to the size of the text.
+ */
+const char *assemblyResultGetAm(AssemblyResult result, size_t *size) {
+    *size = result->am.length;
+    return result->am.data ? result->am.data : "";
+}
+
+/**
+ * It returns the peak memory the assembly allocated from its arena.
+ *
+ * @param result The result of the assembly.
+ */
+size_t assemblyResultGetHighWaterMark(AssemblyResult result) {
+    return result->ctx ? assemblyContextGetHighWaterMark(result->ctx) : 0;
+}
+
+/**
+ * It renders the object file - the header line, "ic dc\n", and then a line per word of the code and the data.
+ *
+ * @param result The result of the assembly.
+ * @param size Set to the size of the content.
+ *
+ * @return The content, to be freed with free, or NULL if it can't be allocated.
+ */
+char *assemblyResultRenderObjectFile(AssemblyResult result, size_t *size) {
+    size_t code_size, data_size;
+    assemblyResultGetCode(result, &code_size);
+    assemblyResultGetData(result, &data_size);
+    return assemblyResultRenderObjectLines(result, 0, 1 + code_size + data_size, size);
+}
+
+/**
+ * It renders a range of the lines of the object file. Every line is the same size, so the lines can be written over
+ * those of an object file with the same lines before them.
+ *
+ * @param result The result of the assembly.
+ * @param first The first line - line 0 is the header line, and line i is the line of word i - 1.
+ * @param end One past the last line.
+ * @param size Set to the size of the content.
+ *
+ * @return The content, to be freed with free, or NULL if it can't be allocated.
+ */
+char *assemblyResultRenderObjectLines(AssemblyResult result, size_t first, size_t end, size_t *size) {
+    size_t code_size, data_size;
+    const unsigned short *code = assemblyResultGetCode(result, &code_size);
+    const unsigned short *data = assemblyResultGetData(result, &data_size);
+
+    char *buf = malloc((end - first) * BASE32_LINE_SIZE + 1);
+    if (!buf)
+        return NULL;
+    char *out = buf;
+
+    if (first == 0 && end > 0) {
+        /* The header line - the terminator decimalToBase32Word writes is overwritten by the next character. */
+        decimalToBase32Word(code_size, out);
+        out[BASE32_WORD_SIZE] = ' ';
+        decimalToBase32Word(data_size, out + BASE32_WORD_SIZE + 1);
+        out[BASE32_LINE_SIZE - 1] = '\n';
+        out += BASE32_LINE_SIZE;
+        first = 1;
+    }
+
+    /* The words of the code, and then those of the data, which is loaded right after the code. */
+    size_t word = first - 1, end_word = end - 1;
+    if (word < code_size && word < end_word) {
+        size_t count = (end_word < code_size ? end_word : code_size) - word;
+        out += base32RenderWords(out, START_ADDRESS_OFFSET + (int) word, code + word, count);
+        word += count;
+    }
+    if (word < end_word)
+        out += base32RenderWords(out, START_ADDRESS_OFFSET + (int) word, data + (word - code_size), end_word - word);
+    *size = out - buf;
+    return buf;
+}
+
+/**
+ * It renders a list of symbols as the lines of an .ent or .ext file, "name address\n".
+ *
+ * @param symbols The symbols.
+ * @param size Set to the size of the content.
+ *
+ * @return The content, to be freed with free, or NULL if it can't be allocated.
+ */
+static char *renderSymbolsFile(const SymbolList *symbols, size_t *size) {
+    size_t buf_size = 0;
+    for (int i = 0; i < symbols->count; ++i) {
+        buf_size += strlen(symbols->symbols[i].name) + BASE32_WORD_SIZE + 2;
+    }
+
+    char *buf = malloc(buf_size + 1); // +1 for the terminator decimalToBase32Word writes
+    if (!buf)
+        return NULL;
+    char *end = buf;
+    for (int i = 0; i < symbols->count; ++i) {
+        size_t name_len = strlen(symbols->symbols[i].name);
+        memcpy(end, symbols->symbols[i].name, name_len);
+        end[name_len] = ' ';
+        decimalToBase32Word(symbols->symbols[i].address, end + name_len + 1);
+        end[name_len + 1 + BASE32_WORD_SIZE] = '\n';
+        end += name_len + BASE32_WORD_SIZE + 2;
+    }
+    *size = buf_size;
+    return buf;
+}
+
+/**
+ * It renders the .ent file - a line per .entry symbol. It is empty if there are none.
+ *
+ * @param result The result of the assembly.
+ * @param size Set to the size of the content.
+ *
+ * @return The content, to be freed with free, or NULL if it can't be allocated.
+ */
+char *assemblyResultRenderEntriesFile(AssemblyResult result, size_t *size) {
+    return renderSymbolsFile(&result->entry_symbols, size);
+}
+
+/**
+ * It renders the .ext file - a line per operand that uses an extern symbol. It is empty if there are none.
+ *
+ * @param result The result of the assembly.
+ * @param size Set to the size of the content.
+ *
+ * @return The content, to be freed with free, or NULL if it can't be allocated.
+ */
+char *assemblyResultRenderExternalFile(AssemblyResult result, size_t *size) {
+    return renderSymbolsFile(&result->extern_uses, size);
+}
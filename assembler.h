@@ -0,0 +1,93 @@
+#ifndef ASSEMBLER_ASSEMBLER_H
+#define ASSEMBLER_ASSEMBLER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/* libassembler - assembles a source held in memory into its object words, .entry symbols, extern uses and
+ * diagnostics, without touching the file system. It never exits the process and holds no global state, so sources can
+ * be assembled concurrently on any number of threads, each with its own results. */
+
+#define LIBASSEMBLER_VERSION "1.1.0" // of the output - changed whenever the same source can assemble differently
+
+/* The options that affect how a file is assembled. */
+typedef struct {
+    bool keep_am; // keep the macro-expanded source, the content of the .am file
+} AssemblyOptions;
+
+/* How far the assembly of a file got. */
+typedef enum {
+    ASSEMBLY_SUCCESS,
+    ASSEMBLY_PRE_ASSEMBLY_FAILED,
+    ASSEMBLY_FIRST_PASS_FAILED,
+    ASSEMBLY_SECOND_PASS_FAILED,
+    ASSEMBLY_OUT_OF_MEMORY
+} AssemblyStatus;
+
+/* The stages of the assembly, in the order they run. */
+typedef enum {
+    STAGE_PRE_ASSEMBLY,
+    STAGE_FIRST_PASS,
+    STAGE_SECOND_PASS
+} AssemblyStage;
+
+/* An error found in the source. */
+typedef struct {
+    AssemblyStage stage;
+    int line_num; // in the .as file - the line of the invocation for a line of a macro body
+    const char *message; // the whole message, e.g. "Error in prog.as line 3: Label is too long"
+} AssemblyDiagnostic;
+
+/* A symbol and its address, e.g. an .entry symbol or the word of an operand that uses an extern symbol. */
+typedef struct {
+    const char *name;
+    int address;
+} AssemblySymbol;
+
+typedef struct assembly_result_t *AssemblyResult;
+
+typedef struct assembly_session_t *AssemblySession;
+
+AssemblyResult assemble(const char *filename, const char *source, size_t size, const AssemblyOptions *options);
+
+void assemblyResultDestroy(AssemblyResult result);
+
+AssemblyStatus assemblyResultGetStatus(AssemblyResult result);
+
+int assemblyResultGetDiagnosticsCount(AssemblyResult result);
+
+const AssemblyDiagnostic *assemblyResultGetDiagnosticAt(AssemblyResult result, int index);
+
+const unsigned short *assemblyResultGetCode(AssemblyResult result, size_t *size);
+
+const unsigned short *assemblyResultGetData(AssemblyResult result, size_t *size);
+
+int assemblyResultGetEntriesCount(AssemblyResult result);
+
+const AssemblySymbol *assemblyResultGetEntryAt(AssemblyResult result, int index);
+
+int assemblyResultGetExternUsesCount(AssemblyResult result);
+
+const AssemblySymbol *assemblyResultGetExternUseAt(AssemblyResult result, int index);
+
+const char *assemblyResultGetAm(AssemblyResult result, size_t *size);
+
+size_t assemblyResultGetHighWaterMark(AssemblyResult result);
+
+char *assemblyResultRenderObjectFile(AssemblyResult result, size_t *size);
+
+char *assemblyResultRenderObjectLines(AssemblyResult result, size_t first, size_t end, size_t *size);
+
+char *assemblyResultRenderEntriesFile(AssemblyResult result, size_t *size);
+
+char *assemblyResultRenderExternalFile(AssemblyResult result, size_t *size);
+
+AssemblySession assemblySessionCreate(const char *filename, const AssemblyOptions *options);
+
+void assemblySessionDestroy(AssemblySession session);
+
+AssemblyResult assemblySessionAssemble(AssemblySession session, const char *source, size_t size);
+
+bool assemblySessionGetChangedWords(AssemblySession session, size_t *first, size_t *end);
+
+#endif //ASSEMBLER_ASSEMBLER_H
@@ -0,0 +1,156 @@
+#include <stdlib.h>
+#include <string.h>
+#include "assembly_context.h"
+#include "errors.h"
+
+
+/* Everything that lives exactly as long as the assembly of one source file */
+struct assembly_context_t {
+    const char *filename;
+    AssemblyOptions options;
+    /* The source file, once it is opened - its lines are borrowed by the statements. */
+    SourceFile source_file;
+    /* The errors found in the file. */
+    Diagnostics diagnostics;
+
+    /* Statements, symbols, macros, machine and memory codes - released when the file is done. */
+    Arena arena;
+    /* The identifiers of the file, which live in the file arena. */
+    InternPool intern_pool;
+};
+
+/**
+ * It creates the assembly context of a source file.
+ *
+ * @param filename The name of the source file (without suffix), which the context copies.
+ * @param options The options to assemble the file with.
+ */
+AssemblyContext assemblyContextCreate(const char *filename, const AssemblyOptions *options) {
+    AssemblyContext ctx = malloc(sizeof(*ctx));
+    if (!ctx)
+        memoryAllocationError();
+
+    ctx->options = *options;
+    ctx->source_file = NULL;
+    ctx->arena = arenaCreate();
+    ctx->filename = arenaStrdup(ctx->arena, filename);
+    ctx->intern_pool = internPoolCreate(ctx->arena);
+    ctx->diagnostics = diagnosticsCreate(ctx->arena);
+    return ctx;
+}
+
+/**
+ * It destroys the assembly context, releasing everything that was allocated for the file in one go.
+ *
+ * @param ctx The context to destroy.
+ */
+void assemblyContextDestroy(AssemblyContext ctx) {
+    if (!ctx)
+        return;
+
+    diagnosticsDestroy(ctx->diagnostics);
+    internPoolDestroy(ctx->intern_pool);
+    arenaDestroy(ctx->arena);
+    sourceFileDestroy(ctx->source_file);
+    free(ctx);
+}
+
+/**
+ * It empties the context for another assembly of the same file, as if it was just created - but the blocks of its
+ * arena are kept, so assembling the file again doesn't go back to malloc for them.
+ *
+ * @param ctx The context to reset.
+ */
+void assemblyContextReset(AssemblyContext ctx) {
+    char *filename = malloc(strlen(ctx->filename) + 1);
+    if (!filename)
+        memoryAllocationError();
+    strcpy(filename, ctx->filename); // it lives in the arena
+
+    diagnosticsDestroy(ctx->diagnostics);
+    internPoolDestroy(ctx->intern_pool);
+    sourceFileDestroy(ctx->source_file);
+    ctx->diagnostics = NULL;
+    ctx->intern_pool = NULL;
+    ctx->source_file = NULL;
+    arenaReset(ctx->arena);
+    arenaResetHighWaterMark(ctx->arena);
+
+    ctx->filename = arenaStrdup(ctx->arena, filename);
+    free(filename);
+    ctx->intern_pool = internPoolCreate(ctx->arena);
+    ctx->diagnostics = diagnosticsCreate(ctx->arena);
+}
+
+/**
+ * It returns the name of the source file (without suffix).
+ *
+ * @param ctx The assembly context.
+ */
+const char *assemblyContextGetFilename(AssemblyContext ctx) {
+    return ctx->filename;
+}
+
+/**
+ * It returns the options the file is assembled with.
+ *
+ * @param ctx The assembly context.
+ */
+const AssemblyOptions *assemblyContextGetOptions(AssemblyContext ctx) {
+    return &ctx->options;
+}
+
+/**
+ * It returns the source file, or NULL if it wasn't opened yet.
+ *
+ * @param ctx The assembly context.
+ */
+SourceFile assemblyContextGetSourceFile(AssemblyContext ctx) {
+    return ctx->source_file;
+}
+
+/**
+ * It sets the source file of the context. The context takes ownership of it, and destroys it when it is destroyed.
+ *
+ * @param ctx The assembly context.
+ * @param source_file The source file.
+ */
+void assemblyContextSetSourceFile(AssemblyContext ctx, SourceFile source_file) {
+    ctx->source_file = source_file;
+}
+
+/**
+ * It returns the errors found in the file so far.
+ *
+ * @param ctx The assembly context.
+ */
+Diagnostics assemblyContextGetDiagnostics(AssemblyContext ctx) {
+    return ctx->diagnostics;
+}
+
+/**
+ * It returns the arena of the allocations that live until the file is done.
+ *
+ * @param ctx The assembly context.
+ */
+Arena assemblyContextGetArena(AssemblyContext ctx) {
+    return ctx->arena;
+}
+
+/**
+ * It returns the intern pool of the identifiers of the file.
+ *
+ * @param ctx The assembly context.
+ */
+InternPool assemblyContextGetInternPool(AssemblyContext ctx) {
+    return ctx->intern_pool;
+}
+
+/**
+ * It returns the high-water mark of the file's arena.
+ *
+ * @param ctx The assembly context.
+ */
+size_t assemblyContextGetHighWaterMark(AssemblyContext ctx) {
+    return arenaGetHighWaterMark(ctx->arena);
+}
@@ -0,0 +1,35 @@
+#ifndef ASSEMBLER_ASSEMBLY_CONTEXT_H
+#define ASSEMBLER_ASSEMBLY_CONTEXT_H
+
+#include <stddef.h>
+#include "assembler.h"
+#include "arena.h"
+#include "source_file.h"
+#include "intern_pool.h"
+#include "diagnostics.h"
+
+typedef struct assembly_context_t *AssemblyContext;
+
+AssemblyContext assemblyContextCreate(const char *filename, const AssemblyOptions *options);
+
+void assemblyContextDestroy(AssemblyContext ctx);
+
+void assemblyContextReset(AssemblyContext ctx);
+
+const char *assemblyContextGetFilename(AssemblyContext ctx);
+
+const AssemblyOptions *assemblyContextGetOptions(AssemblyContext ctx);
+
+SourceFile assemblyContextGetSourceFile(AssemblyContext ctx);
+
+void assemblyContextSetSourceFile(AssemblyContext ctx, SourceFile source_file);
+
+Diagnostics assemblyContextGetDiagnostics(AssemblyContext ctx);
+
+Arena assemblyContextGetArena(AssemblyContext ctx);
+
+InternPool assemblyContextGetInternPool(AssemblyContext ctx);
+
+size_t assemblyContextGetHighWaterMark(AssemblyContext ctx);
+
+#endif //ASSEMBLER_ASSEMBLY_CONTEXT_H
@@ -5,13 +5,16 @@
 #ifndef ASSEMBLER_BASE_CONVERSION_H
 #define ASSEMBLER_BASE_CONVERSION_H
 
+#include <stddef.h>
+
 #define BASE32_WORD_SIZE 2
 #define BINARY_WORD_SIZE 10
 
-int binaryToDecimal(const char *binary, int num_bits);
+/* An object file line, an address and a word in base32: "aa ww\n". */
+#define BASE32_LINE_SIZE (2 * BASE32_WORD_SIZE + 2)
 
-char *decimalToBinary(int p_val, char *buf, size_t num_bits);
+char *decimalToBase32Word(int value, char *base32_word);
 
-char *binaryToBase32Word(const char *binary, char *base32_word);
+size_t base32RenderWords(char *buf, int start_address, const unsigned short *words, size_t num_words);
 
 #endif //ASSEMBLER_BASE_CONVERSION_H
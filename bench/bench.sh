@@ -0,0 +1,29 @@
+#!/bin/sh
+# Measures the assembler on generated sources of growing size - the wall time, the number of allocations and the arena
+# high-water mark of assembling each one - and the keyword lookups against the strcmp loops they replaced.
+#
+# usage: bench.sh <build dir> [statements...]    (default: 10000 100000 1000000)
+
+build=$(cd "$1" && pwd) || exit 1
+shift
+[ $# -gt 0 ] || set -- 10000 100000 1000000
+
+work=$(mktemp -d) || exit 1
+trap 'rm -rf "$work"' EXIT
+cd "$work" || exit 1
+
+printf '%-12s %10s %14s %14s\n' statements "time (s)" mallocs "arena (bytes)"
+for n in "$@"; do
+    "$build/gen_source" "$n" > "gen$n.as"
+    start=$(date +%s%N)
+    "$build/assembler" "gen$n" > /dev/null
+    end=$(date +%s%N)
+    mallocs=$(LD_PRELOAD="$build/libmalloc_count.so" "$build/assembler" "gen$n" 2>&1 > /dev/null |
+              sed -n 's/.*malloc=\([0-9]*\).*/\1/p')
+    arena=$("$build/assembler" --arena-stats "gen$n" | sed -n 's/.*high-water mark.*: \([0-9]*\) bytes/\1/p')
+    printf '%-12s %10s %14s %14s\n' "$n" "$(echo "$start $end" | awk '{printf "%.2f", ($2 - $1) / 1e9}')" \
+           "$mallocs" "$arena"
+done
+
+echo
+"$build/keyword_bench"
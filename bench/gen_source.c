@@ -0,0 +1,38 @@
+/*
+ * Generates a source of n statements for the benchmarks - labeled code, a macro invoked every 10 statements, data,
+ * .struct and .string directives, externals and entries - so the assembly time can be measured as it scales.
+ *
+ * usage: gen_source <statements> > file.as
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+int main(int argc, char **argv) {
+    if (argc != 2 || atoi(argv[1]) < 1) {
+        fprintf(stderr, "usage: %s <statements>\n", argv[0]);
+        return 1;
+    }
+    int n = atoi(argv[1]);
+
+    printf(".extern XT1\n.extern XT2\n");
+    printf("        macro mm\n            inc K0\n            mov r1, r2\n        endmacro\n");
+    for (int i = 0; i < n; ++i) {
+        int target = i + 18 < n - 1 ? i + 18 : n - 1;
+        switch (i % 10) {
+            case 0: printf("L%d:    mov S%d.1 ,K%d\n", i, i / 10, i / 10); break;
+            case 1: printf("        add r2,L%d\n", i - 1); break;
+            case 2: printf("        jmp L%d\n", target - target % 10); break;
+            case 3: printf("        mm\n"); break;
+            case 4: printf("        prn #-%d\n", i % 100); break;
+            case 5: printf("        sub r1 , XT1\n"); break;
+            case 6: printf("K%d:    .data %d,-9,15\n", i / 10, i % 50); break;
+            case 7: printf("S%d:    .struct 8, \"ab\"\n", i / 10); break;
+            case 8: printf("T%d:    .string \"abcdef\"\n", i / 10); break;
+            default: printf("; comment line\n.entry K%d\n", i / 10); break;
+        }
+    }
+    printf("        hlt\n");
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Measures the keyword lookups against the linear strcmp loops they replaced - the five questions the passes ask about
+ * a token (is it a directive, an instruction, its opcode, its number of operands, is it reserved), asked of a mix of
+ * keywords, labels and operands.
+ *
+ * usage: keyword_bench [iterations]    (default: 1000000)
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "const_tables.h"
+
+#define DEFAULT_ITERATIONS 1000000
+#define NOT_FOUND -1
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof(*(a)))
+
+/* The tables and the functions the keyword table replaced, as they were. */
+static const char *DIRECTIVES[] = {DIRECTIVE_DATA, DIRECTIVE_STRING, DIRECTIVE_STRUCT, DIRECTIVE_ENTRY,
+                                   DIRECTIVE_EXTERN};
+static const char *INSTRUCTIONS_2_OP[] = {"mov", "cmp", "add", "sub", "lea"};
+static const char *INSTRUCTIONS_1_OP[] = {"not", "clr", "inc", "dec", "jmp", "bne", "get", "prn", "jsr"};
+static const char *INSTRUCTIONS_0_OP[] = {"rts", "hlt"};
+static const char *INSTRUCTIONS_ALL[] = {"mov", "cmp", "add", "sub", "not", "clr", "lea", "inc",
+                                         "dec", "jmp", "bne", "get", "prn", "jsr", "rts", "hlt"};
+static const char *REGISTERS[] = {"r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7"};
+
+/* The words the lookups are asked about - about as many keywords as other words, as in a source. */
+static const char *WORDS[] = {"mov", "LOOP", "r3", ".data", "K12", "prn", "#-5", "hlt",
+                              "S1.2", ".entry", "jmp", "END", "string", "r9", "lea", "x"};
+
+
+static bool oldIsInList(const char *word, const char **list, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (strcmp(word, list[i]) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool oldIsDirective(const char *word) {
+    return oldIsInList(word, DIRECTIVES, ARRAY_SIZE(DIRECTIVES));
+}
+
+static bool oldIsInstruction(const char *word) {
+    return oldIsInList(word, INSTRUCTIONS_ALL, ARRAY_SIZE(INSTRUCTIONS_ALL));
+}
+
+static int oldGetInstructionCode(const char *word) {
+    for (size_t i = 0; i < ARRAY_SIZE(INSTRUCTIONS_ALL); i++) {
+        if (strcmp(word, INSTRUCTIONS_ALL[i]) == 0)
+            return (int) i;
+    }
+    return NOT_FOUND;
+}
+
+static int oldGetInstructionNumberOfOperands(const char *word) {
+    if (oldIsInList(word, INSTRUCTIONS_0_OP, ARRAY_SIZE(INSTRUCTIONS_0_OP))) {
+        return 0;
+    } else if (oldIsInList(word, INSTRUCTIONS_1_OP, ARRAY_SIZE(INSTRUCTIONS_1_OP))) {
+        return 1;
+    } else if (oldIsInList(word, INSTRUCTIONS_2_OP, ARRAY_SIZE(INSTRUCTIONS_2_OP))) {
+        return 2;
+    }
+    return NOT_FOUND;
+}
+
+static bool oldIsReservedWord(const char *word) {
+    for (size_t i = 0; i < ARRAY_SIZE(DIRECTIVES); i++) {
+        if (strcmp(word, DIRECTIVES[i] + 1) == 0) // +1 to skip the '.'
+            return true;
+    }
+    return oldIsInstruction(word) || oldIsInList(word, REGISTERS, ARRAY_SIZE(REGISTERS));
+}
+
+/**
+ * It asks the five questions of a word with the old functions.
+ *
+ * @return A checksum of the answers, so they aren't optimized away and can be compared.
+ */
+static long askOld(const char *word) {
+    return oldIsDirective(word) + 2 * oldIsInstruction(word) + 4 * oldGetInstructionCode(word) +
+           64 * oldGetInstructionNumberOfOperands(word) + 256 * oldIsReservedWord(word);
+}
+
+/**
+ * It asks the five questions of a word with the keyword table, a lookup per question as the passes do.
+ *
+ * @return A checksum of the answers, the same as askOld's.
+ */
+static long askTable(const char *word) {
+    const Keyword *keyword = getKeyword(word);
+    bool is_directive = keyword && keyword->kind == KEYWORD_DIRECTIVE;
+    const Instruction *instruction = getInstruction(word);
+    int code = instruction ? instruction->opcode : NOT_FOUND;
+    instruction = getInstruction(word);
+    int num_operands = instruction ? instruction->num_operands : NOT_FOUND;
+    return is_directive + 2 * (getInstruction(word) != NULL) + 4 * code + 64 * num_operands +
+           256 * isReservedWord(word);
+}
+
+/**
+ * It asks the five questions of a word with a single lookup.
+ *
+ * @return A checksum of the answers, the same as askOld's.
+ */
+static long askOnce(const char *word) {
+    const Keyword *keyword = getKeyword(word);
+    const Instruction *instruction = keyword && keyword->kind == KEYWORD_INSTRUCTION ? keyword->instruction : NULL;
+    bool reserved = keyword && keyword->kind != KEYWORD_DIRECTIVE && keyword->kind != KEYWORD_MACRO_START &&
+                    keyword->kind != KEYWORD_MACRO_END;
+    return (keyword && keyword->kind == KEYWORD_DIRECTIVE) + 2 * (instruction != NULL) +
+           4 * (instruction ? instruction->opcode : NOT_FOUND) +
+           64 * (instruction ? instruction->num_operands : NOT_FOUND) + 256 * reserved;
+}
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + (double) t.tv_nsec / 1e9;
+}
+
+/**
+ * It times a way of asking the questions over all the words.
+ *
+ * @return The checksum of all the answers.
+ */
+static long measure(const char *name, long (*ask)(const char *), long iterations) {
+    volatile long checksum = 0;
+    double start = now();
+    for (long i = 0; i < iterations; ++i) {
+        for (size_t j = 0; j < ARRAY_SIZE(WORDS); ++j) {
+            checksum += ask(WORDS[j]);
+        }
+    }
+    double elapsed = now() - start;
+    printf("%-20s %8.1f ns per word\n", name, elapsed * 1e9 / ((double) iterations * ARRAY_SIZE(WORDS)));
+    return checksum;
+}
+
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    long old = measure("old strcmp loops", askOld, iterations);
+    long table = measure("table functions", askTable, iterations);
+    long once = measure("one getKeyword()", askOnce, iterations);
+    if (old != table || old != once) {
+        fprintf(stderr, "the answers differ: %ld, %ld, %ld\n", old, table, once);
+        return 1;
+    }
+    return 0;
+}
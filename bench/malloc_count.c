@@ -0,0 +1,72 @@
+/*
+ * Counts the calls to the allocator of a process, and prints the counts to stderr when it exits. It is preloaded into
+ * the assembler by bench.sh (LD_PRELOAD) to measure how many allocations an assembly makes.
+ */
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BOOTSTRAP_SIZE 4096
+
+static unsigned long mallocs, callocs, reallocs, frees;
+static void *(*real_malloc)(size_t);
+static void *(*real_calloc)(size_t, size_t);
+static void *(*real_realloc)(void *, size_t);
+static void (*real_free)(void *);
+
+/* dlsym itself may call calloc while the real one is being found, so those allocations come from here. */
+static char bootstrap[BOOTSTRAP_SIZE];
+static size_t bootstrap_used;
+static bool resolving_calloc;
+
+
+void *malloc(size_t size) {
+    if (!real_malloc)
+        *(void **) &real_malloc = dlsym(RTLD_NEXT, "malloc");
+    mallocs++;
+    return real_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    if (!real_calloc) {
+        if (resolving_calloc) {
+            void *p = bootstrap + bootstrap_used;
+            bootstrap_used += (count * size + 15) & ~(size_t) 15;
+            return bootstrap_used <= sizeof(bootstrap) ? p : NULL;
+        }
+        resolving_calloc = true;
+        *(void **) &real_calloc = dlsym(RTLD_NEXT, "calloc");
+        resolving_calloc = false;
+    }
+    callocs++;
+    return real_calloc(count, size);
+}
+
+void *realloc(void *p, size_t size) {
+    if (!real_realloc)
+        *(void **) &real_realloc = dlsym(RTLD_NEXT, "realloc");
+    reallocs++;
+    return real_realloc(p, size);
+}
+
+void free(void *p) {
+    if ((char *) p >= bootstrap && (char *) p < bootstrap + sizeof(bootstrap))
+        return;
+    if (!real_free)
+        *(void **) &real_free = dlsym(RTLD_NEXT, "free");
+    if (p)
+        frees++;
+    real_free(p);
+}
+
+__attribute__((destructor)) static void printCounts(void) {
+    char msg[256];
+    int len = snprintf(msg, sizeof(msg), "allocations: malloc=%lu calloc=%lu realloc=%lu free=%lu\n", mallocs, callocs,
+                       reallocs, frees);
+    write(STDERR_FILENO, msg, len);
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "client.h"
+#include "protocol.h"
+#include "errors.h"
+#include "str_utils.h"
+
+
+/**
+ * It connects to the assembler server.
+ *
+ * @param socket_path The path of the server's socket.
+ *
+ * @return The connected socket.
+ */
+static int clientConnect(const char *socket_path) {
+    struct sockaddr_un addr;
+    int fd = protocolSocketAddress(socket_path, &addr) ? socket(AF_UNIX, SOCK_STREAM, 0) : -1;
+    if (fd == -1 || connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+        errorWithMsg("Can't connect to the assembler server! Start it with --server <socket>.");
+    }
+    return fd;
+}
+
+/**
+ * It has the server assemble a file, and prints the messages about it - the same messages, and the same output files,
+ * as assembling the file without the server.
+ *
+ * @param fd The socket of the server.
+ * @param filename The name of the file (without suffix).
+ * @param cwd The current directory, which the server resolves a relative name by.
+ * @param flags The flags of the request.
+ */
+static void clientAssembleFile(int fd, const char *filename, const char *cwd, uint32_t flags) {
+    /* The server runs in a directory of its own, so it is sent the path of the file as well as its name. */
+    const char *path = filename;
+    if (filename[0] != '/') {
+        const char *dir = strConcat(cwd, "/");
+        path = strConcat(dir, filename);
+        free((void *) dir);
+    }
+
+    Message request, response;
+    protocolMessageInit(&request, REQUEST_ASSEMBLE_FILE, flags);
+    protocolMessageAddBlob(&request, filename, strlen(filename));
+    protocolMessageAddBlob(&request, path, strlen(path));
+    if (!protocolSend(fd, &request) || !protocolReceive(fd, &response) || response.num_blobs < 1) {
+        errorWithMsg("Lost the connection to the assembler server!");
+    }
+    if (path != filename)
+        free((void *) path);
+
+    fwrite(response.blobs[0], 1, response.blob_sizes[0], stdout);
+    if (response.type == RESPONSE_FILE_NOT_FOUND && response.num_blobs == 2) {
+        fileNotFoundError(strConcat(filename, response.blobs[1]));
+    } else if (response.type == RESPONSE_OUT_OF_MEMORY) {
+        memoryAllocationError();
+    }
+    protocolMessageFree(&response);
+}
+
+/**
+ * It assembles files on the assembler server, one after another, printing the messages about each file as it is done.
+ *
+ * @param socket_path The path of the server's socket.
+ * @param files The names of the files to compile (without suffix).
+ * @param files_count The number of files.
+ * @param options The options to assemble the files with.
+ */
+void clientRun(const char *socket_path, const char **files, int files_count, const FileAssemblyOptions *options) {
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd))) {
+        errorWithMsg("Can't get the current directory!");
+    }
+
+    int fd = clientConnect(socket_path);
+    uint32_t flags = protocolOptionsToFlags(options);
+    for (int i = 0; i < files_count; ++i) {
+        clientAssembleFile(fd, files[i], cwd, flags);
+    }
+    close(fd);
+}
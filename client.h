@@ -0,0 +1,8 @@
+#ifndef ASSEMBLER_CLIENT_H
+#define ASSEMBLER_CLIENT_H
+
+#include "file_assembly.h"
+
+void clientRun(const char *socket_path, const char **files, int files_count, const FileAssemblyOptions *options);
+
+#endif //ASSEMBLER_CLIENT_H
@@ -8,115 +8,167 @@
 #include "str_utils.h"
 #include "types_utils.h"
 
-#define NOT_FOUND -1
+#define NO_REGISTER -1
 
 #define IMMEDIATE_ADDRESSING_PREFIX '#'
 #define REGISTER_PREFIX 'r'
+#define STRUCT_FIELD_DELIM '.'
 
+#define ANY_ADDRESSING (ADDRESSING_MODE_BIT(IMMEDIATE_ADDRESSING) | ADDRESSING_MODE_BIT(DIRECT_ADDRESSING) | \
+                        ADDRESSING_MODE_BIT(STRUCT_ADDRESSING) | ADDRESSING_MODE_BIT(REGISTER_ADDRESSING))
+#define NOT_IMMEDIATE_ADDRESSING (ANY_ADDRESSING & ~ADDRESSING_MODE_BIT(IMMEDIATE_ADDRESSING))
+#define LABEL_ADDRESSING (ADDRESSING_MODE_BIT(DIRECT_ADDRESSING) | ADDRESSING_MODE_BIT(STRUCT_ADDRESSING))
+#define NO_OPERAND 0
 
-const char *DIRECTIVES[] = {DIRECTIVE_DATA, DIRECTIVE_STRING, DIRECTIVE_STRUCT, DIRECTIVE_ENTRY, DIRECTIVE_EXTERN};
-const char *INSTRUCTIONS_2_OP[] = {"mov", "cmp", "add", "sub", "lea"};
-const char *INSTRUCTIONS_1_OP[] = {"not", "clr", "inc", "dec", "jmp", "bne", "get", "prn",
-                                   "jsr"};
-const char *INSTRUCTIONS_0_OP[] = {"rts", "hlt"};
-const char *INSTRUCTIONS_ALL[] = {"mov", "cmp", "add", "sub",
-                                  "not", "clr", "lea", "inc",
-                                  "dec", "jmp", "bne", "get",
-                                  "prn", "jsr", "rts", "hlt"};
-const char *REGISTERS[] = {"r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7"};
+/* The instruction set, indexed by opcode. */
+static const Instruction INSTRUCTIONS[INSTRUCTIONS_SIZE] = {
+        /* opcode, operands, source addressing, destination addressing */
+        {0, 2, ANY_ADDRESSING, NOT_IMMEDIATE_ADDRESSING},      // mov
+        {1, 2, ANY_ADDRESSING, ANY_ADDRESSING},                // cmp
+        {2, 2, ANY_ADDRESSING, NOT_IMMEDIATE_ADDRESSING},      // add
+        {3, 2, ANY_ADDRESSING, NOT_IMMEDIATE_ADDRESSING},      // sub
+        {4, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},          // not
+        {5, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},          // clr
+        {6, 2, LABEL_ADDRESSING, NOT_IMMEDIATE_ADDRESSING},    // lea
+        {7, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},          // inc
+        {8, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},          // dec
+        {9, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},          // jmp
+        {10, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},         // bne
+        {11, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},         // get
+        {12, 1, NO_OPERAND, ANY_ADDRESSING},                   // prn
+        {13, 1, NO_OPERAND, NOT_IMMEDIATE_ADDRESSING},         // jsr
+        {14, 0, NO_OPERAND, NO_OPERAND},                       // rts
+        {15, 0, NO_OPERAND, NO_OPERAND},                       // hlt
+};
+
+/* A perfect hash of the keywords, by their length and first, second and last characters. The constants were searched
+ * for so that no two keywords collide, so they have to be checked again when a keyword is added. */
+#define KEYWORDS_TABLE_SIZE 64
+#define KEYWORD_HASH(len, first, second, last) \
+    (((len) * 15 + (first) * 2 + (second) * 12 + (last) * 5) & (KEYWORDS_TABLE_SIZE - 1))
+
+#define INSTRUCTION_KEYWORD(name, c1, c2, c3, opcode) \
+    [KEYWORD_HASH(3, c1, c2, c3)] = {name, KEYWORD_INSTRUCTION, &INSTRUCTIONS[opcode], NO_REGISTER}
+#define REGISTER_KEYWORD(name, num) \
+    [KEYWORD_HASH(2, 'r', '0' + (num), '0' + (num))] = {name, KEYWORD_REGISTER, NULL, num}
+#define OTHER_KEYWORD(name, len, first, second, last, kind) \
+    [KEYWORD_HASH(len, first, second, last)] = {name, kind, NULL, NO_REGISTER}
+
+static const Keyword KEYWORDS[KEYWORDS_TABLE_SIZE] = {
+        INSTRUCTION_KEYWORD("mov", 'm', 'o', 'v', 0),
+        INSTRUCTION_KEYWORD("cmp", 'c', 'm', 'p', 1),
+        INSTRUCTION_KEYWORD("add", 'a', 'd', 'd', 2),
+        INSTRUCTION_KEYWORD("sub", 's', 'u', 'b', 3),
+        INSTRUCTION_KEYWORD("not", 'n', 'o', 't', 4),
+        INSTRUCTION_KEYWORD("clr", 'c', 'l', 'r', 5),
+        INSTRUCTION_KEYWORD("lea", 'l', 'e', 'a', 6),
+        INSTRUCTION_KEYWORD("inc", 'i', 'n', 'c', 7),
+        INSTRUCTION_KEYWORD("dec", 'd', 'e', 'c', 8),
+        INSTRUCTION_KEYWORD("jmp", 'j', 'm', 'p', 9),
+        INSTRUCTION_KEYWORD("bne", 'b', 'n', 'e', 10),
+        INSTRUCTION_KEYWORD("get", 'g', 'e', 't', 11),
+        INSTRUCTION_KEYWORD("prn", 'p', 'r', 'n', 12),
+        INSTRUCTION_KEYWORD("jsr", 'j', 's', 'r', 13),
+        INSTRUCTION_KEYWORD("rts", 'r', 't', 's', 14),
+        INSTRUCTION_KEYWORD("hlt", 'h', 'l', 't', 15),
+
+        OTHER_KEYWORD(DIRECTIVE_DATA, 5, '.', 'd', 'a', KEYWORD_DIRECTIVE),
+        OTHER_KEYWORD(DIRECTIVE_STRING, 7, '.', 's', 'g', KEYWORD_DIRECTIVE),
+        OTHER_KEYWORD(DIRECTIVE_STRUCT, 7, '.', 's', 't', KEYWORD_DIRECTIVE),
+        OTHER_KEYWORD(DIRECTIVE_ENTRY, 6, '.', 'e', 'y', KEYWORD_DIRECTIVE),
+        OTHER_KEYWORD(DIRECTIVE_EXTERN, 7, '.', 'e', 'n', KEYWORD_DIRECTIVE),
+
+        OTHER_KEYWORD(DIRECTIVE_DATA + 1, 4, 'd', 'a', 'a', KEYWORD_DIRECTIVE_NAME),
+        OTHER_KEYWORD(DIRECTIVE_STRING + 1, 6, 's', 't', 'g', KEYWORD_DIRECTIVE_NAME),
+        OTHER_KEYWORD(DIRECTIVE_STRUCT + 1, 6, 's', 't', 't', KEYWORD_DIRECTIVE_NAME),
+        OTHER_KEYWORD(DIRECTIVE_ENTRY + 1, 5, 'e', 'n', 'y', KEYWORD_DIRECTIVE_NAME),
+        OTHER_KEYWORD(DIRECTIVE_EXTERN + 1, 6, 'e', 'x', 'n', KEYWORD_DIRECTIVE_NAME),
+
+        REGISTER_KEYWORD("r0", 0),
+        REGISTER_KEYWORD("r1", 1),
+        REGISTER_KEYWORD("r2", 2),
+        REGISTER_KEYWORD("r3", 3),
+        REGISTER_KEYWORD("r4", 4),
+        REGISTER_KEYWORD("r5", 5),
+        REGISTER_KEYWORD("r6", 6),
+        REGISTER_KEYWORD("r7", 7),
+
+        OTHER_KEYWORD(START_MACRO_STR, 5, 'm', 'a', 'o', KEYWORD_MACRO_START),
+        OTHER_KEYWORD(END_MACRO_STR, 8, 'e', 'n', 'o', KEYWORD_MACRO_END),
+};
 
 
 /**
- * It checks if the word is a reserved word.
+ * It finds the keyword of the first len characters of word, with a single lookup in the keywords table.
  *
- * @param word The word to check
+ * @param word The word to look up, doesn't have to be null-terminated.
+ * @param len The length of the word.
+ *
+ * @return The keyword, or NULL if the word is not a keyword.
  */
-bool isReservedWord(const char *word) {
-    for (int i = 0; i < DIRECTIVES_SIZE; i++) {
-        if (strcmp(word, DIRECTIVES[i] + 1) == 0) { // +1 to skip the '.'
-            return true;
-        }
-    }
-    for (int i = 0; i < INSTRUCTIONS_ALL_SIZE; i++) {
-        if (strcmp(word, INSTRUCTIONS_ALL[i]) == 0) {
-            return true;
-        }
-    }
-    for (int i = 0; i < REGISTERS_SIZE; i++) {
-        if (strcmp(word, REGISTERS[i]) == 0) {
-            return true;
-        }
-    }
-    return false;
+const Keyword *getKeywordOfLength(const char *word, size_t len) {
+    if (len == 0)
+        return NULL;
+
+    unsigned char second = len > 1 ? word[1] : '\0';
+    const Keyword *keyword = &KEYWORDS[KEYWORD_HASH(len, (unsigned char) word[0], second, (unsigned char) word[len - 1])];
+    if (!keyword->name || strncmp(keyword->name, word, len) != 0 || keyword->name[len] != '\0')
+        return NULL;
+    return keyword;
 }
 
 /**
- * It returns the instruction code for the given instruction.
+ * It finds the keyword of a word.
+ *
+ * @param word The word to look up.
  *
- * @param instruction The instruction to get the code for.
+ * @return The keyword, or NULL if the word is not a keyword.
  */
-int getInstructionCode(const char *instruction) {
-    for (int i = 0; i < INSTRUCTIONS_ALL_SIZE; i++) {
-        if (strcmp(instruction, INSTRUCTIONS_ALL[i]) == 0) {
-            return i;
-        }
-    }
-    return NOT_FOUND;
+const Keyword *getKeyword(const char *word) {
+    return getKeywordOfLength(word, strlen(word));
 }
 
 /**
- * It checks if the instruction is a 0 operand instruction.
+ * It finds the instruction set entry of a mnemonic.
+ *
+ * @param mnemonic The mnemonic to look up.
  *
- * @param instruction The instruction to check
+ * @return The instruction, or NULL if the mnemonic is not an instruction.
  */
-bool is0OperandInstruction(const char *instruction) {
-    for (int i = 0; i < INSTRUCTIONS_0_OP_SIZE; ++i) {
-        if (strcmp(instruction, INSTRUCTIONS_0_OP[i]) == 0)
-            return true;
-    }
-    return false;
+const Instruction *getInstruction(const char *mnemonic) {
+    const Keyword *keyword = getKeyword(mnemonic);
+    return keyword && keyword->kind == KEYWORD_INSTRUCTION ? keyword->instruction : NULL;
 }
 
 /**
- * It checks if the instruction is a 1 operand instruction.
+ * It checks if the instruction's source operand may use the addressing mode.
  *
- * @param instruction The instruction to check
+ * @param instruction The instruction.
+ * @param mode The addressing mode of the source operand.
  */
-bool is1OperandInstruction(const char *instruction) {
-    for (int i = 0; i < INSTRUCTIONS_1_OP_SIZE; ++i) {
-        if (strcmp(instruction, INSTRUCTIONS_1_OP[i]) == 0)
-            return true;
-    }
-    return false;
+bool isValidSrcAddressing(const Instruction *instruction, AddressingMode mode) {
+    return (instruction->src_addressing_modes & ADDRESSING_MODE_BIT(mode)) != 0;
 }
 
 /**
- * It checks if the instruction is a 2 operand instruction.
+ * It checks if the instruction's destination operand may use the addressing mode.
  *
- * @param instruction The instruction to check
+ * @param instruction The instruction.
+ * @param mode The addressing mode of the destination operand.
  */
-bool is2OperandInstruction(const char *instruction) {
-    for (int i = 0; i < INSTRUCTIONS_2_OP_SIZE; ++i) {
-        if (strcmp(instruction, INSTRUCTIONS_2_OP[i]) == 0)
-            return true;
-    }
-    return false;
+bool isValidDstAddressing(const Instruction *instruction, AddressingMode mode) {
+    return (instruction->dst_addressing_modes & ADDRESSING_MODE_BIT(mode)) != 0;
 }
 
 /**
- * It returns the number of operands for a given instruction.
+ * It checks if the word is a reserved word.
  *
- * @param instruction The instruction to get the number of operands for.
+ * @param word The word to check
  */
-int getInstructionNumberOfOperands(const char *instruction) {
-    if (is0OperandInstruction(instruction)) {
-        return 0;
-    } else if (is1OperandInstruction(instruction)) {
-        return 1;
-    } else if (is2OperandInstruction(instruction)) {
-        return 2;
-    }
-    return -1;
+bool isReservedWord(const char *word) {
+    const Keyword *keyword = getKeyword(word);
+    return keyword && (keyword->kind == KEYWORD_INSTRUCTION || keyword->kind == KEYWORD_DIRECTIVE_NAME ||
+                       keyword->kind == KEYWORD_REGISTER);
 }
 
 /**
@@ -137,17 +189,15 @@ AddressingMode getAddressingMode(const char *operand) {
         return INVALID_ADDRESSING;
     } else if (isAlphaNumeric(operand)) {
         return DIRECT_ADDRESSING;
-    } else {
-        List split_operand = strSplit(operand, ".");
-        const char *before_delim = listGetDataAt(split_operand, 0);
-        const char *after_delim = listGetDataAt(split_operand, 1);
-
-        if (listLength(split_operand) == 2 && (strcmp(after_delim, "1") == 0 ||
-                                               strcmp(after_delim, "2") == 0) &&
-            strlen(before_delim) > 1 && isAlphaNumeric(before_delim)) {
-            return STRUCT_ADDRESSING;
-        } else {
+    }
+
+    /* A struct field - the label of the struct, a '.' and the number of the field, checked in place. */
+    const char *delim = strchr(operand, STRUCT_FIELD_DELIM);
+    if (!delim || delim - operand < 2 || (delim[1] != '1' && delim[1] != '2') || delim[2] != '\0')
+        return INVALID_ADDRESSING;
+    for (const char *c = operand; c < delim; ++c) {
+        if (!isalnum((unsigned char) *c))
             return INVALID_ADDRESSING;
-        }
     }
+    return STRUCT_ADDRESSING;
 }
@@ -6,14 +6,7 @@
 #define ASSEMBLER_CONST_TABLES_H
 
 #include <stdbool.h>
-#include "linkedlist.h"
-
-#define DIRECTIVES_SIZE 5
-#define INSTRUCTIONS_2_OP_SIZE 5
-#define INSTRUCTIONS_1_OP_SIZE 9
-#define INSTRUCTIONS_0_OP_SIZE 2
-#define INSTRUCTIONS_ALL_SIZE INSTRUCTIONS_2_OP_SIZE + INSTRUCTIONS_1_OP_SIZE + INSTRUCTIONS_0_OP_SIZE
-#define REGISTERS_SIZE 8
+#include <stddef.h>
 
 #define A 0
 #define E 1
@@ -25,6 +18,12 @@
 #define DIRECTIVE_ENTRY ".entry"
 #define DIRECTIVE_EXTERN ".extern"
 
+/* The address the code is loaded at. */
+#define START_ADDRESS_OFFSET 100
+
+#define START_MACRO_STR "macro"
+#define END_MACRO_STR "endmacro"
+
 typedef enum {
     IMMEDIATE_ADDRESSING,
     DIRECT_ADDRESSING,
@@ -34,24 +33,46 @@ typedef enum {
     EMPTY_ADDRESSING
 } AddressingMode;
 
-extern const char *DIRECTIVES[];
-extern const char *INSTRUCTIONS_2_OP[];
-extern const char *INSTRUCTIONS_1_OP[];
-extern const char *INSTRUCTIONS_0_OP[];
-extern const char *INSTRUCTIONS_ALL[];
+typedef enum {
+    KEYWORD_INSTRUCTION,
+    KEYWORD_DIRECTIVE,
+    KEYWORD_DIRECTIVE_NAME, // a directive without its '.', reserved so it can't be used as a label
+    KEYWORD_REGISTER,
+    KEYWORD_MACRO_START,
+    KEYWORD_MACRO_END
+} KeywordKind;
 
-int getInstructionCode(const char *instruction);
+#define INSTRUCTIONS_SIZE 16
 
-int getInstructionNumberOfOperands(const char *instruction);
+/* The addressing modes an operand of an instruction may use, as a bitmask of ADDRESSING_MODE_BIT(mode). */
+#define ADDRESSING_MODE_BIT(mode) (1u << (mode))
 
-AddressingMode getAddressingMode(const char *operand);
+typedef struct {
+    int opcode;
+    int num_operands;
+    unsigned int src_addressing_modes; // the operand of a 1 operand instruction is a destination operand
+    unsigned int dst_addressing_modes;
+} Instruction;
 
-bool isReservedWord(const char *word);
+typedef struct {
+    const char *name;
+    KeywordKind kind;
+    const Instruction *instruction;  // instructions only
+    int register_num;  // registers only
+} Keyword;
 
-bool is0OperandInstruction(const char *instruction);
+const Keyword *getKeyword(const char *word);
 
-bool is1OperandInstruction(const char *instruction);
+const Keyword *getKeywordOfLength(const char *word, size_t len);
 
-bool is2OperandInstruction(const char *instruction);
+const Instruction *getInstruction(const char *mnemonic);
+
+bool isValidSrcAddressing(const Instruction *instruction, AddressingMode mode);
+
+bool isValidDstAddressing(const Instruction *instruction, AddressingMode mode);
+
+AddressingMode getAddressingMode(const char *operand);
+
+bool isReservedWord(const char *word);
 
 #endif //ASSEMBLER_CONST_TABLES_H
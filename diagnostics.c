@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "diagnostics.h"
+#include "errors.h"
+
+#define DIAGNOSTICS_INITIAL_CAPACITY 16
+
+
+/* The errors found in a file, in the order they were found, each tagged with the stage that found it. */
+struct diagnostics_t {
+    Arena arena; // the messages are allocated from it
+    AssemblyStage stage;
+
+    AssemblyDiagnostic *diagnostics;
+    int size;
+    int capacity;
+};
+
+/**
+ * It creates an empty list of diagnostics, starting at the pre-assembly stage.
+ *
+ * @param arena The arena to allocate the messages from.
+ */
+Diagnostics diagnosticsCreate(Arena arena) {
+    Diagnostics diags = malloc(sizeof(*diags));
+    if (!diags)
+        memoryAllocationError();
+
+    diags->arena = arena;
+    diags->stage = STAGE_PRE_ASSEMBLY;
+    diags->size = 0;
+    diags->capacity = DIAGNOSTICS_INITIAL_CAPACITY;
+    diags->diagnostics = malloc(diags->capacity * sizeof(*diags->diagnostics));
+    if (!diags->diagnostics)
+        memoryAllocationError();
+    return diags;
+}
+
+/**
+ * It destroys the list of diagnostics. The messages live in the arena.
+ *
+ * @param diags The diagnostics to destroy.
+ */
+void diagnosticsDestroy(Diagnostics diags) {
+    if (!diags)
+        return;
+
+    free(diags->diagnostics);
+    free(diags);
+}
+
+/**
+ * It sets the stage the next diagnostics are reported by.
+ *
+ * @param diags The diagnostics.
+ * @param stage The stage that is starting.
+ */
+void diagnosticsSetStage(Diagnostics diags, AssemblyStage stage) {
+    diags->stage = stage;
+}
+
+/**
+ * It reports an error, formatting its message like printf does.
+ *
+ * @param diags The diagnostics to add the error to.
+ * @param line_num The line number of the error.
+ * @param format The format of the message, without a trailing newline.
+ */
+void diagnosticsReport(Diagnostics diags, int line_num, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    char *message = arenaAlloc(diags->arena, len + 1);
+    va_start(args, format);
+    vsnprintf(message, len + 1, format, args);
+    va_end(args);
+
+    if (diags->size == diags->capacity) {
+        diags->capacity *= 2;
+        diags->diagnostics = realloc(diags->diagnostics, diags->capacity * sizeof(*diags->diagnostics));
+        if (!diags->diagnostics)
+            memoryAllocationError();
+    }
+    AssemblyDiagnostic *diag = &diags->diagnostics[diags->size++];
+    diag->stage = diags->stage;
+    diag->line_num = line_num;
+    diag->message = message;
+}
+
+/**
+ * It returns the number of errors reported.
+ *
+ * @param diags The diagnostics.
+ */
+int diagnosticsCount(Diagnostics diags) {
+    return diags->size;
+}
+
+/**
+ * It returns an error, in the order the errors were reported.
+ *
+ * @param diags The diagnostics.
+ * @param index The index of the error.
+ */
+const AssemblyDiagnostic *diagnosticsGetAt(Diagnostics diags, int index) {
+    return &diags->diagnostics[index];
+}
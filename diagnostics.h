@@ -0,0 +1,21 @@
+#ifndef ASSEMBLER_DIAGNOSTICS_H
+#define ASSEMBLER_DIAGNOSTICS_H
+
+#include "arena.h"
+#include "assembler.h"
+
+typedef struct diagnostics_t *Diagnostics;
+
+Diagnostics diagnosticsCreate(Arena arena);
+
+void diagnosticsDestroy(Diagnostics diags);
+
+void diagnosticsSetStage(Diagnostics diags, AssemblyStage stage);
+
+void diagnosticsReport(Diagnostics diags, int line_num, const char *format, ...);
+
+int diagnosticsCount(Diagnostics diags);
+
+const AssemblyDiagnostic *diagnosticsGetAt(Diagnostics diags, int index);
+
+#endif //ASSEMBLER_DIAGNOSTICS_H
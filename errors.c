@@ -10,7 +10,14 @@
 #define FILE_NOT_FOUND_ERROR -3
 
 
+/* Where an allocation failure on this thread returns to, instead of exiting - set while a file is being assembled. */
+static __thread jmp_buf *thread_recovery_point;
+
+
 void memoryAllocationError(void) {
+    if (thread_recovery_point)
+        longjmp(*thread_recovery_point, 1);
+
     printf("Memory Allocation ERROR :(");
     exit(MEMORY_ALLOCATION_ERROR);
 }
@@ -24,3 +31,17 @@ void errorWithMsg(const char *msg) {
     printf("%s", msg);
     exit(-1);
 }
+
+/**
+ * It sets where memoryAllocationError returns to on the calling thread, so a failed allocation unwinds to the caller
+ * instead of exiting the process.
+ *
+ * @param recovery_point The point set by setjmp to return to, or NULL to exit on failure again.
+ *
+ * @return The previous recovery point of the thread, to restore when the caller is done.
+ */
+jmp_buf *errorsSetRecoveryPoint(jmp_buf *recovery_point) {
+    jmp_buf *previous = thread_recovery_point;
+    thread_recovery_point = recovery_point;
+    return previous;
+}
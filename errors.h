@@ -5,9 +5,13 @@
 #ifndef ASSEMBLER_ERRORS_H
 #define ASSEMBLER_ERRORS_H
 
+#include <setjmp.h>
+
 
 void memoryAllocationError(void);
 void fileNotFoundError(const char *filename);
 void errorWithMsg(const char *msg);
 
+jmp_buf *errorsSetRecoveryPoint(jmp_buf *recovery_point);
+
 #endif //ASSEMBLER_ERRORS_H
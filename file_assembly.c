@@ -0,0 +1,425 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+
+#include "file_assembly.h"
+#include "errors.h"
+#include "file_utils.h"
+#include "base_conversion.h"
+
+
+struct incremental_file_t {
+    AssemblySession session;
+    FileStamp object_stamp;
+    bool object_written; // the object file is that of the last assembly, as stamped
+};
+
+/**
+ * It prints the errors a stage of the assembly found.
+ *
+ * @param result The result of the assembly.
+ * @param stage The stage.
+ * @param log The stream to print the errors to.
+ */
+static void printDiagnostics(AssemblyResult result, AssemblyStage stage, FILE *log) {
+    for (int i = 0; i < assemblyResultGetDiagnosticsCount(result); ++i) {
+        const AssemblyDiagnostic *diag = assemblyResultGetDiagnosticAt(result, i);
+        if (diag->stage == stage) {
+            fprintf(log, "%s\n", diag->message);
+        }
+    }
+}
+
+/**
+ * It writes an output file, and records it for the cache.
+ *
+ * @param path The path of the file (without suffix).
+ * @param suffix The suffix of the output file.
+ * @param content The content of the output file.
+ * @param size The size of the content.
+ * @param record The record of the output files, or NULL if the file isn't cached.
+ *
+ * @return false if the file can't be opened or written in full, true otherwise - only a file that was written is
+ * recorded.
+ */
+static bool writeRecordedFile(const char *path, const char *suffix, const char *content, size_t size,
+                              OutputRecord *record) {
+    if (!writeFileWithSuffix(path, suffix, content, size))
+        return false;
+    if (record)
+        outputRecordAdd(record, false, suffix, content, size);
+    return true;
+}
+
+/**
+ * It removes an output file, and records it for the cache.
+ *
+ * @param path The path of the file (without suffix).
+ * @param suffix The suffix of the output file.
+ * @param record The record of the output files, or NULL if the file isn't cached.
+ */
+static void removeRecordedFile(const char *path, const char *suffix, OutputRecord *record) {
+    removeFileWithSuffix(path, suffix);
+    if (record)
+        outputRecordAdd(record, true, suffix, NULL, 0);
+}
+
+/**
+ * It writes an output file that is only created if it isn't empty - otherwise the file left from an earlier assembly
+ * of the file is removed.
+ *
+ * @param filename The name of the file (without suffix), for the log.
+ * @param path The path of the file (without suffix).
+ * @param suffix The suffix of the output file.
+ * @param content The content of the output file, which is freed.
+ * @param size The size of the content.
+ * @param log The stream to report the created file to.
+ * @param record The record of the output files, or NULL if the file isn't cached.
+ *
+ * @return false if the file can't be opened, true otherwise.
+ */
+static bool writeOutputFile(const char *filename, const char *path, const char *suffix, char *content, size_t size,
+                            FILE *log, OutputRecord *record) {
+    if (!content)
+        memoryAllocationError();
+
+    bool success = true;
+    if (size == 0) {
+        removeRecordedFile(path, suffix, record);
+    } else if ((success = writeRecordedFile(path, suffix, content, size, record))) {
+        fprintf(log, "%s%s file created\n", filename, suffix);
+    }
+    free(content);
+    return success;
+}
+
+/**
+ * It writes the object file of a file that is assembled incrementally. If only some of the words changed since the
+ * object file was last written, and nothing else changed the file since, only the header line and the lines of the
+ * changed words are written over it - every line is the same size, so the lines of the other words stay where they
+ * are. Otherwise the file is written in full.
+ *
+ * @param file The file.
+ * @param result The result of its last assembly.
+ * @param path The path of the file (without suffix).
+ *
+ * @return false if the object file can't be opened, true otherwise.
+ */
+static bool writeObjectFileIncrementally(IncrementalFile file, AssemblyResult result, const char *path) {
+    size_t code_size, data_size, first, end;
+    assemblyResultGetCode(result, &code_size);
+    assemblyResultGetData(result, &data_size);
+    size_t object_size = (1 + code_size + data_size) * BASE32_LINE_SIZE;
+
+    if (file->object_written && assemblySessionGetChangedWords(file->session, &first, &end)) {
+        FilePatch patches[2];
+        size_t size;
+        char *header = assemblyResultRenderObjectLines(result, 0, 1, &size);
+        patches[0] = (FilePatch) {header, size, 0};
+        char *lines = assemblyResultRenderObjectLines(result, 1 + first, 1 + end, &size);
+        patches[1] = (FilePatch) {lines, size, (1 + first) * BASE32_LINE_SIZE};
+        if (!header || !lines) {
+            free(header);
+            free(lines);
+            memoryAllocationError();
+        }
+        bool patched = patchFileWithSuffix(path, OBJECT_FILE_SUFFIX, patches, 2, object_size, &file->object_stamp);
+        free(header);
+        free(lines);
+        if (patched)
+            return true;
+    }
+
+    file->object_written = false;
+    size_t size;
+    char *content = assemblyResultRenderObjectFile(result, &size);
+    if (!content)
+        memoryAllocationError();
+    bool written = writeFileWithSuffix(path, OBJECT_FILE_SUFFIX, content, size);
+    free(content);
+    if (written)
+        file->object_written = stampFileWithSuffix(path, OBJECT_FILE_SUFFIX, &file->object_stamp);
+    return written;
+}
+
+/**
+ * It writes the output files of the second pass. If the second pass failed nothing is rendered or written, and only the
+ * output files left from an earlier assembly of the file are removed.
+ *
+ * @param result The result of the assembly.
+ * @param filename The name of the file (without suffix), for the log.
+ * @param path The path of the file (without suffix).
+ * @param log The stream to print the messages to.
+ * @param record The record of the output files, or NULL if the file isn't cached.
+ * @param file The file if it is assembled incrementally, or NULL.
+ * @param failed_suffix Set to the suffix of the output file that can't be opened, if there is one.
+ *
+ * @return false if an output file can't be opened, true otherwise.
+ */
+static bool writeSecondPassFiles(AssemblyResult result, const char *filename, const char *path, FILE *log,
+                                 OutputRecord *record, IncrementalFile file, const char **failed_suffix) {
+    if (assemblyResultGetStatus(result) == ASSEMBLY_SECOND_PASS_FAILED) {
+        fprintf(log, "Second-pass for %s failed. cleaning up artifacts..\n", filename);
+        removeRecordedFile(path, OBJECT_FILE_SUFFIX, record);
+        removeRecordedFile(path, ENTRIES_FILE_SUFFIX, record);
+        removeRecordedFile(path, EXTERNAL_FILE_SUFFIX, record);
+        if (file)
+            file->object_written = false;
+        return true;
+    }
+
+    size_t size;
+    char *content;
+    bool written;
+    if (file) {
+        written = writeObjectFileIncrementally(file, result, path);
+    } else {
+        content = assemblyResultRenderObjectFile(result, &size);
+        if (!content)
+            memoryAllocationError();
+        written = writeRecordedFile(path, OBJECT_FILE_SUFFIX, content, size, record);
+        free(content);
+    }
+    if (!written) {
+        *failed_suffix = OBJECT_FILE_SUFFIX;
+        return false;
+    }
+
+    content = assemblyResultRenderEntriesFile(result, &size);
+    if (!writeOutputFile(filename, path, ENTRIES_FILE_SUFFIX, content, size, log, record)) {
+        *failed_suffix = ENTRIES_FILE_SUFFIX;
+        return false;
+    }
+    content = assemblyResultRenderExternalFile(result, &size);
+    if (!writeOutputFile(filename, path, EXTERNAL_FILE_SUFFIX, content, size, log, record)) {
+        *failed_suffix = EXTERNAL_FILE_SUFFIX;
+        return false;
+    }
+
+    fprintf(log, "Second-pass for %s succeeded. %s%s file created\n", filename, filename, OBJECT_FILE_SUFFIX);
+    return true;
+}
+
+/**
+ * It prints the messages about each stage of an assembly, and writes and removes its output files.
+ *
+ * @param result The result of the assembly.
+ * @param filename The name of the file (without suffix), for the log.
+ * @param path The path of the file (without suffix).
+ * @param options The options the file was assembled with.
+ * @param log The stream to print the messages to.
+ * @param record The record of the output files, or NULL if the file isn't cached.
+ * @param file The file if it is assembled incrementally, or NULL.
+ * @param failed_suffix Set to the suffix of the output file that can't be opened, if there is one.
+ *
+ * @return false if an output file can't be opened, true otherwise.
+ */
+static bool reportAssembly(AssemblyResult result, const char *filename, const char *path,
+                           const FileAssemblyOptions *options, FILE *log, OutputRecord *record, IncrementalFile file,
+                           const char **failed_suffix) {
+    AssemblyStatus status = assemblyResultGetStatus(result);
+
+    printDiagnostics(result, STAGE_PRE_ASSEMBLY, log);
+    if (status == ASSEMBLY_PRE_ASSEMBLY_FAILED) {
+        fprintf(log, "Pre-assembly for %s failed. cleaning up and skipping first-pass", filename);
+        if (options->assembly.keep_am)
+            removeRecordedFile(path, AFTER_MACRO_SUFFIX, record);
+        return true;
+    }
+
+    if (options->assembly.keep_am) {
+        size_t am_size;
+        const char *am = assemblyResultGetAm(result, &am_size);
+        if (!writeRecordedFile(path, AFTER_MACRO_SUFFIX, am, am_size, record)) {
+            *failed_suffix = AFTER_MACRO_SUFFIX;
+            return false;
+        }
+        fprintf(log, "Pre-assembly for %s succeeded. %s%s file created\n", filename, filename, AFTER_MACRO_SUFFIX);
+    } else {
+        fprintf(log, "Pre-assembly for %s succeeded\n", filename);
+    }
+
+    fprintf(log, "2. Run first-pass for %s\n", filename);
+    printDiagnostics(result, STAGE_FIRST_PASS, log);
+    if (status == ASSEMBLY_FIRST_PASS_FAILED) {
+        fprintf(log, "First-pass for %s failed. skipping second-pass\n", filename);
+        return true;
+    }
+
+    fprintf(log, "3. Run second-pass for %s\n", filename);
+    printDiagnostics(result, STAGE_SECOND_PASS, log);
+    return writeSecondPassFiles(result, filename, path, log, record, file, failed_suffix);
+}
+
+/**
+ * It assembles the source of a file, and writes the output files and the messages about each stage.
+ *
+ * @param filename The name of the file (without suffix), for the log.
+ * @param path The path of the file (without suffix).
+ * @param source The source of the file, which is freed as soon as it is assembled, unless it is kept.
+ * @param keep_source Whether the caller still needs the source, and frees it itself.
+ * @param options The options to assemble the file with.
+ * @param log The stream to print the messages to.
+ * @param record The record of the output files, or NULL if the file isn't cached.
+ * @param failed_suffix Set to the suffix of the output file that can't be opened, if there is one.
+ *
+ * @return false if an output file can't be opened, true otherwise.
+ */
+static bool assembleSource(const char *filename, const char *path, FileContent *source, bool keep_source,
+                           const FileAssemblyOptions *options, FILE *log, OutputRecord *record,
+                           const char **failed_suffix) {
+    AssemblyResult result = assemble(filename, source->data, source->size, &options->assembly);
+    if (!keep_source)
+        fileContentFree(source);
+    if (!result || assemblyResultGetStatus(result) == ASSEMBLY_OUT_OF_MEMORY) {
+        assemblyResultDestroy(result);
+        memoryAllocationError();
+    }
+
+    bool success = reportAssembly(result, filename, path, options, log, record, NULL, failed_suffix);
+    if (success && options->arena_stats) {
+        fprintf(log, "Arena high-water mark for %s: %zu bytes\n", filename, assemblyResultGetHighWaterMark(result));
+    }
+    assemblyResultDestroy(result);
+    return success;
+}
+
+/**
+ * It assembles the source of a file through the output cache - on a hit, the output files and the messages are
+ * restored without assembling the file, and on a miss the file is assembled and its outputs are stored.
+ *
+ * @param filename The name of the file (without suffix), for the log.
+ * @param path The path of the file (without suffix).
+ * @param source The source of the file, which is freed.
+ * @param options The options to assemble the file with, with the cache.
+ * @param log The stream to print the messages to.
+ * @param failed_suffix Set to the suffix of the output file that can't be opened, if there is one.
+ *
+ * @return false if an output file can't be opened, true otherwise.
+ */
+static bool assembleSourceCached(const char *filename, const char *path, FileContent *source,
+                                 const FileAssemblyOptions *options, FILE *log, const char **failed_suffix) {
+    unsigned cached_options = (options->assembly.keep_am ? 1u : 0) | (options->arena_stats ? 2u : 0);
+    OutputCacheInput input = {filename, cached_options, source->data, source->size};
+    if (outputCacheRestore(options->cache, &input, path, log)) {
+        fileContentFree(source);
+        return true;
+    }
+
+    /* The messages are buffered, to be stored as well. */
+    char *log_buf = NULL;
+    size_t log_size = 0;
+    FILE *cached_log = open_memstream(&log_buf, &log_size);
+    if (!cached_log)
+        memoryAllocationError();
+    OutputRecord record = {NULL, 0, 0};
+
+    /* The source is kept until the entry is stored, as the entry holds it to be compared on a hit. */
+    bool success = assembleSource(filename, path, source, true, options, cached_log, &record, failed_suffix);
+    fclose(cached_log);
+    fwrite(log_buf, 1, log_size, log);
+    if (success)
+        outputCacheStore(options->cache, &input, log_buf, log_size, &record);
+    fileContentFree(source);
+    outputRecordFree(&record);
+    free(log_buf);
+    return success;
+}
+
+/**
+ * It assembles a single file with libassembler, and writes the output files and the messages about each stage. A
+ * failed allocation goes to memoryAllocationError, but a file that can't be opened is returned to the caller, so a
+ * long-running caller can report it without exiting.
+ *
+ * @param filename The name of the file to compile (without suffix), for the log.
+ * @param path The path of the file (without suffix) - the same as the name, unless the file is given relative to
+ * another directory.
+ * @param options The options to assemble the file with.
+ * @param log The stream to print the messages to.
+ * @param failed_suffix Set to the suffix of the file that can't be opened, if there is one.
+ *
+ * @return false if a file can't be opened, true otherwise - even if the source has errors.
+ */
+bool assembleFileToLog(const char *filename, const char *path, const FileAssemblyOptions *options, FILE *log,
+                       const char **failed_suffix) {
+    fprintf(log, "============================================================================================\n");
+    fprintf(log, "1. Run pre-assembly for %s\n", filename);
+    FileContent source;
+    if (!readFileWithSuffix(path, SOURCE_FILE_SUFFIX, &source)) {
+        *failed_suffix = SOURCE_FILE_SUFFIX;
+        return false;
+    }
+    if (options->cache)
+        return assembleSourceCached(filename, path, &source, options, log, failed_suffix);
+    return assembleSource(filename, path, &source, false, options, log, NULL, failed_suffix);
+}
+
+/**
+ * It creates a file to assemble incrementally.
+ *
+ * @param filename The name of the file (without suffix), for its diagnostics.
+ * @param options The options to assemble the file with.
+ *
+ * @return The file, to be destroyed with incrementalFileDestroy.
+ */
+IncrementalFile incrementalFileCreate(const char *filename, const AssemblyOptions *options) {
+    IncrementalFile file = calloc(1, sizeof(*file));
+    if (!file)
+        memoryAllocationError();
+    if (!(file->session = assemblySessionCreate(filename, options))) {
+        free(file);
+        memoryAllocationError();
+    }
+    return file;
+}
+
+/**
+ * It destroys a file that is assembled incrementally.
+ *
+ * @param file The file to destroy.
+ */
+void incrementalFileDestroy(IncrementalFile file) {
+    if (!file)
+        return;
+    assemblySessionDestroy(file->session);
+    free(file);
+}
+
+/**
+ * It assembles a file again, reassembling only the lines that changed since its last assembly when it can, and writes
+ * the output files and the messages about each stage - the same messages and output files as assembleFileToLog. The
+ * object file is patched in place where only some of its words changed, and the other output files are written in
+ * full. The output cache isn't used, as the file keeps the state of its last assembly anyway. The arena high-water
+ * mark is that of the file's arena, which also holds the lines of the edits since its last full assembly.
+ *
+ * @param file The file.
+ * @param filename The name of the file (without suffix), for the log.
+ * @param path The path of the file (without suffix).
+ * @param options The options to assemble the file with - the same options the file was created with.
+ * @param log The stream to print the messages to.
+ * @param failed_suffix Set to the suffix of the file that can't be opened, if there is one.
+ *
+ * @return false if a file can't be opened, true otherwise - even if the source has errors.
+ */
+bool assembleFileIncrementally(IncrementalFile file, const char *filename, const char *path,
+                               const FileAssemblyOptions *options, FILE *log, const char **failed_suffix) {
+    fprintf(log, "============================================================================================\n");
+    fprintf(log, "1. Run pre-assembly for %s\n", filename);
+    FileContent source;
+    if (!readFileWithSuffix(path, SOURCE_FILE_SUFFIX, &source)) {
+        *failed_suffix = SOURCE_FILE_SUFFIX;
+        return false;
+    }
+    AssemblyResult result = assemblySessionAssemble(file->session, source.data, source.size);
+    fileContentFree(&source);
+    if (assemblyResultGetStatus(result) == ASSEMBLY_OUT_OF_MEMORY) {
+        file->object_written = false;
+        memoryAllocationError();
+    }
+
+    bool success = reportAssembly(result, filename, path, options, log, NULL, file, failed_suffix);
+    if (success && options->arena_stats) {
+        fprintf(log, "Arena high-water mark for %s: %zu bytes\n", filename, assemblyResultGetHighWaterMark(result));
+    }
+    return success;
+}
@@ -0,0 +1,38 @@
+#ifndef ASSEMBLER_FILE_ASSEMBLY_H
+#define ASSEMBLER_FILE_ASSEMBLY_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "assembler.h"
+#include "output_cache.h"
+
+#define SOURCE_FILE_SUFFIX ".as"
+#define AFTER_MACRO_SUFFIX ".am"
+#define OBJECT_FILE_SUFFIX ".ob"
+#define ENTRIES_FILE_SUFFIX ".ent"
+#define EXTERNAL_FILE_SUFFIX ".ext"
+
+/* The options of assembling a file - the options of the assembly itself, and what is reported about it. */
+typedef struct {
+    AssemblyOptions assembly;
+    bool arena_stats; // print the arena high-water mark when the file is done
+    OutputCache cache; // where the outputs are restored from and stored to, or NULL to always assemble the file
+    bool incremental; // keep the state of the file's last assembly, to reassemble only the lines that changed
+} FileAssemblyOptions;
+
+/* A file that is assembled again and again as it is edited - the session of its assembly, and what its object file
+ * looked like when it was last written, so that only the lines that changed are written again. */
+typedef struct incremental_file_t *IncrementalFile;
+
+bool assembleFileToLog(const char *filename, const char *path, const FileAssemblyOptions *options, FILE *log,
+                       const char **failed_suffix);
+
+IncrementalFile incrementalFileCreate(const char *filename, const AssemblyOptions *options);
+
+void incrementalFileDestroy(IncrementalFile file);
+
+bool assembleFileIncrementally(IncrementalFile file, const char *filename, const char *path,
+                               const FileAssemblyOptions *options, FILE *log, const char **failed_suffix);
+
+#endif //ASSEMBLER_FILE_ASSEMBLY_H
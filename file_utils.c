@@ -3,37 +3,239 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "file_utils.h"
 #include "str_utils.h"
 #include "errors.h"
 
+#define READ_CHUNK_SIZE 65536
+
+static bool mapping_disabled;
+
+
+/**
+ * It removes the file with the given suffix.
+ *
+ * @param filename The name of the file to remove.
+ * @param suffix The suffix of the file to be removed.
+ */
+void removeFileWithSuffix(const char *filename, const char *suffix) {
+    const char *filename_with_suffix = strConcat(filename, suffix);
+    remove(filename_with_suffix);
+    free((void *) filename_with_suffix);
+}
 
 /**
- * It opens a file with a suffix.
+ * It writes the whole buffer to the file with the given suffix, with a single write. A file that can't be written in
+ * full (the disk is full, or an I/O error) is removed, so a truncated file is never left behind as if it was written.
  *
- * @param filename The name of the file to open.
- * @param mode "r" for read, "w" for write, "a" for append, "r+" for read and write, "w+" for write and read, "a+" for
- * append and read
+ * @param filename The name of the file to write to.
  * @param suffix The suffix to append to the filename.
+ * @param buf The content of the file.
+ * @param size The size of the content.
+ *
+ * @return false if the file can't be opened or written, true otherwise.
  */
-FILE *openFileWithSuffix(const char *filename, const char *mode, const char *suffix) {
+bool writeFileWithSuffix(const char *filename, const char *suffix, const char *buf, size_t size) {
     const char *filename_with_suffix = strConcat(filename, suffix);
-    FILE *file = fopen(filename_with_suffix, mode);
+    FILE *file = fopen(filename_with_suffix, "w");
     if (!file) {
-        fileNotFoundError(filename_with_suffix);
+        free((void *) filename_with_suffix);
+        return false;
     }
+
+    /* Unbuffered, so the buffer is handed to the system as is instead of being copied in chunks. */
+    setvbuf(file, NULL, _IONBF, 0);
+    bool written = fwrite(buf, 1, size, file) == size;
+    written = fclose(file) == 0 && written;
+    if (!written)
+        remove(filename_with_suffix);
     free((void *) filename_with_suffix);
-    return file;
+    return written;
 }
 
 /**
- * It removes the file with the given suffix.
+ * It makes readFileWithSuffix read files rather than map them, for the rest of the process. A process that outlives
+ * many assemblies - the server, or watching the files - reads them, since a mapped file that is truncated while it is
+ * assembled (an editor saving the file in place) kills the process with SIGBUS. It must be called before the files are
+ * read from other threads.
+ */
+void fileUtilsDisableMapping(void) {
+    mapping_disabled = true;
+}
+
+/**
+ * It reads the whole content of a file, like a pipe or a file that isn't mapped.
  *
- * @param filename The name of the file to remove.
- * @param suffix The suffix of the file to be removed.
+ * @param fd The file descriptor to read from.
+ * @param size_hint The expected size of the content, or 0 if it isn't known.
+ * @param size_ptr Set to the size of the content.
+ *
+ * @return The content, allocated with malloc, or NULL if reading failed.
  */
-void removeFileWithSuffix(const char *filename, const char *suffix) {
+static char *readAll(int fd, size_t size_hint, size_t *size_ptr) {
+    /* One more byte than expected, so a file that didn't grow is read to its end without growing the buffer. */
+    size_t size = 0, capacity = size_hint + 1 > READ_CHUNK_SIZE ? size_hint + 1 : READ_CHUNK_SIZE;
+    char *data = malloc(capacity);
+    if (!data)
+        memoryAllocationError();
+
+    for (;;) {
+        if (size == capacity) {
+            capacity *= 2;
+            data = realloc(data, capacity);
+            if (!data)
+                memoryAllocationError();
+        }
+        ssize_t n = read(fd, data + size, capacity - size);
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1) {
+            free(data);
+            return NULL;
+        }
+        if (n == 0)
+            break;
+        size += n;
+    }
+    *size_ptr = size;
+    return data;
+}
+
+/**
+ * It reads the content of the file with the given suffix. The file is mapped into memory, or read if it can't be
+ * mapped or mapping is disabled.
+ *
+ * @param filename The name of the file to read.
+ * @param suffix The suffix to append to the filename.
+ * @param content Set to the content of the file, to be freed with fileContentFree.
+ *
+ * @return false if the file can't be opened or read, true otherwise.
+ */
+bool readFileWithSuffix(const char *filename, const char *suffix, FileContent *content) {
     const char *filename_with_suffix = strConcat(filename, suffix);
-    remove(filename_with_suffix);
+    int fd = open(filename_with_suffix, O_RDONLY);
     free((void *) filename_with_suffix);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    bool is_regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    content->data = NULL;
+    content->size = 0;
+    content->is_mapped = false;
+    if (is_regular && st.st_size > 0 && !mapping_disabled) {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            content->data = data;
+            content->size = st.st_size;
+            content->is_mapped = true;
+        }
+    }
+    bool read_ok = true;
+    if (!content->is_mapped && !(is_regular && st.st_size == 0)) { // pipes, and files that aren't mapped
+        content->data = readAll(fd, is_regular ? (size_t) st.st_size : 0, &content->size);
+        read_ok = content->data != NULL;
+    }
+    close(fd);
+    return read_ok;
+}
+
+/**
+ * It frees the content of a file, unmapping it if it was mapped.
+ *
+ * @param content The content to free.
+ */
+void fileContentFree(FileContent *content) {
+    if (content->is_mapped) {
+        munmap(content->data, content->size);
+    } else {
+        free(content->data);
+    }
+    content->data = NULL;
+    content->size = 0;
+}
+
+/**
+ * It records what a file looks like, to tell later if it was changed.
+ *
+ * @param st The status of the file.
+ * @param stamp Set to the stamp of the file.
+ */
+static void stampFromStat(const struct stat *st, FileStamp *stamp) {
+    stamp->dev = st->st_dev;
+    stamp->ino = st->st_ino;
+    stamp->size = st->st_size;
+    stamp->mtime_sec = st->st_mtim.tv_sec;
+    stamp->mtime_nsec = st->st_mtim.tv_nsec;
+}
+
+/**
+ * It records what the file with the given suffix looks like, right after it was written.
+ *
+ * @param filename The name of the file.
+ * @param suffix The suffix to append to the filename.
+ * @param stamp Set to the stamp of the file.
+ *
+ * @return false if the file doesn't exist, true otherwise.
+ */
+bool stampFileWithSuffix(const char *filename, const char *suffix, FileStamp *stamp) {
+    const char *filename_with_suffix = strConcat(filename, suffix);
+    struct stat st;
+    bool exists = stat(filename_with_suffix, &st) == 0;
+    free((void *) filename_with_suffix);
+    if (exists)
+        stampFromStat(&st, stamp);
+    return exists;
+}
+
+/**
+ * It overwrites ranges of the file with the given suffix in place, and truncates or extends it to its new size - but
+ * only if the file is still exactly as it was stamped, so that the ranges that aren't overwritten are known to be right.
+ *
+ * @param filename The name of the file to patch.
+ * @param suffix The suffix to append to the filename.
+ * @param patches The ranges to overwrite.
+ * @param count The number of ranges.
+ * @param size The new size of the file.
+ * @param stamp The stamp of the file when it was last written, updated to its stamp after it is patched.
+ *
+ * @return false if the file can't be patched - it doesn't exist, was changed since it was stamped, or a write failed -
+ * in which case it has to be written in full, true otherwise.
+ */
+bool patchFileWithSuffix(const char *filename, const char *suffix, const FilePatch *patches, int count, size_t size,
+                         FileStamp *stamp) {
+    const char *filename_with_suffix = strConcat(filename, suffix);
+    int fd = open(filename_with_suffix, O_WRONLY);
+    free((void *) filename_with_suffix);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    FileStamp current;
+    bool patched = fstat(fd, &st) == 0;
+    if (patched) {
+        stampFromStat(&st, &current);
+        patched = current.dev == stamp->dev && current.ino == stamp->ino && current.size == stamp->size &&
+                  current.mtime_sec == stamp->mtime_sec && current.mtime_nsec == stamp->mtime_nsec;
+    }
+    for (int i = 0; patched && i < count; ++i) {
+        size_t written = 0;
+        while (patched && written < patches[i].size) {
+            ssize_t n = pwrite(fd, patches[i].buf + written, patches[i].size - written,
+                               (off_t) (patches[i].offset + written));
+            patched = n > 0;
+            written += patched ? n : 0;
+        }
+    }
+    patched = patched && ftruncate(fd, (off_t) size) == 0 && fstat(fd, &st) == 0;
+    patched = close(fd) == 0 && patched;
+    if (patched)
+        stampFromStat(&st, stamp);
+    return patched;
 }
@@ -6,13 +6,48 @@
 #define ASSEMBLER_FILE_UTILS_H
 
 #include <stdio.h>
+#include <stdbool.h>
+#include <sys/types.h>
 
-#define MAX_LINE_LEN 80 + 1 + 1 // +1 for '\n' and +1 for '\0'
-#define LINE_BUFFER_LEN MAX_LINE_LEN + 1
+#define MAX_LINE_LEN 80 // not counting the '\n'
 
+/* The content of a file, mapped into memory (or read, if it can't be mapped). */
+typedef struct {
+    char *data;
+    size_t size;
+    bool is_mapped;
+} FileContent;
+
+/* What a file looked like right after it was written, to tell if anything else changed it since. */
+typedef struct {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    time_t mtime_sec;
+    long mtime_nsec;
+} FileStamp;
+
+/* A range of a file to overwrite. */
+typedef struct {
+    const char *buf;
+    size_t size;
+    size_t offset;
+} FilePatch;
 
-FILE *openFileWithSuffix(const char *filename, const char *mode, const char *suffix);
 
 void removeFileWithSuffix(const char *filename, const char *suffix);
 
+bool writeFileWithSuffix(const char *filename, const char *suffix, const char *buf, size_t size);
+
+void fileUtilsDisableMapping(void);
+
+bool readFileWithSuffix(const char *filename, const char *suffix, FileContent *content);
+
+void fileContentFree(FileContent *content);
+
+bool stampFileWithSuffix(const char *filename, const char *suffix, FileStamp *stamp);
+
+bool patchFileWithSuffix(const char *filename, const char *suffix, const FilePatch *patches, int count, size_t size,
+                         FileStamp *stamp);
+
 #endif //ASSEMBLER_FILE_UTILS_H
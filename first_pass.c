@@ -10,37 +10,48 @@
 #include "file_utils.h"
 #include "memory_code.h"
 #include "machine_code.h"
+#include "fixups.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
 
-#define SOURCE_FILE_SUFFIX ".am"
+#define SOURCE_FILE_SUFFIX ".as"
 
 
 /**
- * The function builds the symbol table.
+ * The function builds the symbol table and encodes the machine code and the data segment, patching the references to
+ * each symbol as soon as it is defined. The data symbols keep their offsets in the data segment, which is relocated
+ * after the code only when the addresses are written out.
  *
- * @param src_file The source file.
- * @param filename The name of the source file.
+ * @param statements The statements of the .am file.
+ * @param ctx The assembly context of the source file.
+ * @param index The index to record where each statement starts and the operands that refer to symbols in, or NULL.
  */
-bool run_first_pass_aux(FILE *src_file, const char *filename, List symtab, List machine_codes, List memory_codes) {
+bool run_first_pass_aux(Vector statements, AssemblyContext ctx, Symtab symtab, MachineCode machine_code,
+                        MemoryCode memory_code, Vector entries, Fixups fixups, IncrementalIndex index) {
+    const char *filename = assemblyContextGetFilename(ctx);
+    Diagnostics diags = assemblyContextGetDiagnostics(ctx);
+    Arena arena = assemblyContextGetArena(ctx);
+    InternPool names = assemblyContextGetInternPool(ctx);
+
     size_t ic = 0, dc = 0;
     bool is_label = false;
 
     bool success = true;
 
-    int line_num = 0;
-    char line[LINE_BUFFER_LEN];
-    while (fgets(line, LINE_BUFFER_LEN, src_file) != NULL) {
-        if (strlen(line) > MAX_LINE_LEN) {
+    for (VectorIterator it = vectorBegin(statements); it != vectorEnd(statements); ++it) {
+        Statement s = (Statement) *it;
+        int line_num = statementGetLineNum(s);
+        if (index)
+            incrementalIndexAddStatement(index, ic, dc, symtabSize(symtab));
+
+        if (statementGetLineLength(s) > MAX_LINE_LEN) {
             success = false;
-            printf("Error in %s.%s line %d: line too long, exceeds 80 characters\n",
-                   filename, SOURCE_FILE_SUFFIX, line_num);
+            diagnosticsReport(diags, line_num, "Error in %s.%s line %d: line too long, exceeds 80 characters", filename,
+                    SOURCE_FILE_SUFFIX, line_num);
         }
-        line_num++;
-        Statement s = parse(line, line_num);
-        if (!s || !statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX)) {
+        if (!statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX, diags)) {
             success = false;
             continue;
         }
@@ -52,25 +63,24 @@ bool run_first_pass_aux(FILE *src_file, const char *filename, List symtab, List
         if (statementGetLabel(s)) {
             is_label = true;
 
+            const char *label = statementGetLabel(s);
+            int label_id = internPoolIntern(names, label, strlen(label));
             SymtabEntry entry;
             if (statementGetType(s) == DIRECTIVE) {
-                const char *directive = statementGetMnemonic(s);
-                bool is_struct = strcmp(directive, DIRECTIVE_STRUCT) == 0;
-                entry = symtabEntryCreate(statementGetLabel(s), dc, false, is_struct, line_num, SYMBOL_DATA);
+                entry = symtabEntryCreate(arena, names, label_id, dc, false, line_num, SYMBOL_DATA);
             } else {  // INSTRUCTION
-                entry = symtabEntryCreate(statementGetLabel(s), ic, false, false, line_num, SYMBOL_CODE);
+                entry = symtabEntryCreate(arena, names, label_id, ic, false, line_num, SYMBOL_CODE);
             }
 
             SymtabEntry found_entry;
-            if (listFind(symtab, entry, (void **) &found_entry) == LIST_SUCCESS) {
+            if (symtabInsert(symtab, entry, &found_entry) == SYMTAB_DUPLICATE) {
                 success = false;
-                printf("Error in %s.%s line %d: duplicate label '%s' was previously defined on line %d\n",
-                       filename, SOURCE_FILE_SUFFIX, line_num, statementGetLabel(s),
-                       symtabEntryGetLineNum(found_entry));
+                diagnosticsReport(diags, line_num,
+                        "Error in %s.%s line %d: duplicate label '%s' was previously defined on line %d", filename,
+                        SOURCE_FILE_SUFFIX, line_num, label, symtabEntryGetLineNum(found_entry));
             } else {
-                listAppend(symtab, entry);
+                fixupsDefineSymbol(fixups, entry);
             }
-            symtabEntryDestroy(entry);
         } else {
             is_label = false;
         }
@@ -78,75 +88,66 @@ bool run_first_pass_aux(FILE *src_file, const char *filename, List symtab, List
         if (statementGetType(s) == DIRECTIVE) {
             const char *directive = statementGetMnemonic(s);
             if (is_label && isDataStoreDirective(directive)) {
-                MemoryCode mem_c = memoryCodeCreate(s, dc);
-
-                listAppend(memory_codes, mem_c);
-                dc += memoryCodeGetSize(mem_c);
-
-                memoryCodeDestroy(mem_c);
+                memoryCodeAppendDirective(memory_code, s);
+                dc = memoryCodeGetSize(memory_code);
 
             } else { // .extern or .entry
-                if (strcmp(directive, DIRECTIVE_EXTERN) == 0) {
-                    List extern_operands = statementGetOperands(s);
-                    assert(listLength(extern_operands) == 1);
+                if (strcmp(directive, DIRECTIVE_ENTRY) == 0) {
+                    /* The .entry symbols may be defined later on, so they are looked up in the second pass. */
+                    vectorAppendMove(entries, s);
+                } else if (strcmp(directive, DIRECTIVE_EXTERN) == 0) {
+                    assert(statementGetOperandsCount(s) == 1);
 
-                    const char *extern_operand = listGetDataAt(extern_operands, 0);
-                    SymtabEntry entry = symtabEntryCreate(extern_operand, 0, false, false, line_num, SYMBOL_EXTERN);
+                    const char *extern_operand = statementGetOperandAt(s, 0);
+                    int extern_id = internPoolIntern(names, extern_operand, strlen(extern_operand));
+                    SymtabEntry entry = symtabEntryCreate(arena, names, extern_id, 0, false, line_num, SYMBOL_EXTERN);
 
                     SymtabEntry found_entry;
-                    if (listFind(symtab, entry, (void **) &found_entry) == LIST_SUCCESS) {
+                    if (symtabInsert(symtab, entry, &found_entry) == SYMTAB_DUPLICATE) {
                         success = false;
-                        printf("Error in %s.%s line %d: duplicate extern label '%s' was previously defined on line %d\n",
-                               filename, SOURCE_FILE_SUFFIX, line_num, extern_operand,
-                               symtabEntryGetLineNum(found_entry));
+                        diagnosticsReport(diags, line_num,
+                                "Error in %s.%s line %d: duplicate extern label '%s' was previously defined on line %d",
+                                filename, SOURCE_FILE_SUFFIX, line_num, extern_operand,
+                                symtabEntryGetLineNum(found_entry));
                     } else {
-                        listAppend(symtab, entry);
+                        fixupsDefineSymbol(fixups, entry);
                     }
-                    symtabEntryDestroy(entry);
                 }
             }
         } else { // INSTRUCTION
-            MachineCode mc = machineCodeCreate(s, ic);
+            SymbolOperand symbol_operands[MAX_OPERANDS_COUNT];
+            int num_symbol_operands = machineCodeAppendInstruction(machine_code, names, s, symbol_operands);
+            fixupsAddInstruction(fixups, symbol_operands, num_symbol_operands, line_num, symtab);
+            if (index)
+                incrementalIndexAddSymbolOperands(index, symbol_operands, num_symbol_operands);
 
-            listAppend(machine_codes, mc);
-            ic += machineCodeGetSize(mc);
-
-            machineCodeDestroy(mc);
+            ic = machineCodeGetSize(machine_code);
         }
     }
-
-    /* Adding the IC to the data symbols addresses. */
-    for (int i = 0; i < listLength(symtab); i++) {
-        SymtabEntry entry = (SymtabEntry) listGetDataAt(symtab, i);
-        if (symtabEntryGetType(entry) == SYMBOL_DATA) {
-            symtabEntrySetValue(entry, symtabEntryGetValue(entry) + ic);
-        }
-    }
-    for (int i = 0; i < listLength(memory_codes); i++) {
-        MemoryCode mem_c = (MemoryCode) listGetDataAt(memory_codes, i);
-        memoryCodeSetStartAddress(mem_c, memoryCodeGetStartAddress(mem_c) + ic);
-    }
+    if (index)
+        incrementalIndexAddStatement(index, ic, dc, symtabSize(symtab));
     return success;
 }
 
 /**
  * It runs the first pass of the assembler.
  *
- * @param filename The name of the file to be read.
+ * @param ctx The assembly context of the file.
+ * @param statements The statements of the .am file.
+ * @param entries_ptr Set to the .entry statements, to be resolved in the second pass.
+ * @param fixups_ptr Set to the operands whose symbols weren't defined yet, to be resolved in the second pass.
+ * @param index The index to record where each statement starts in, or NULL.
  * @return The built symbol table.
  */
-bool run_first_pass(const char *filename, List *symtab_ptr, List *machine_codes_ptr, List *memory_codes_ptr) {
-    FILE *src_file = openFileWithSuffix(filename, "r", SOURCE_FILE_SUFFIX);
-
-    /* Building the symbol table and machine/memory codes. */
-    *symtab_ptr = listCreate((list_eq) symtabEntryCmp, (list_copy) symtabEntryCopy, (list_free) symtabEntryDestroy);
-    *machine_codes_ptr = listCreate((list_eq) machineCodeCmp, (list_copy) machineCodeCopy,
-                                    (list_free) machineCodeDestroy);
-    *memory_codes_ptr = listCreate((list_eq) memoryCodeCmp, (list_copy) memoryCodeCopy, (list_free) memoryCodeDestroy);
-
-    bool res = run_first_pass_aux(src_file, filename, *symtab_ptr, *machine_codes_ptr, *memory_codes_ptr);
-
-    fclose(src_file);
-
-    return res;
+bool run_first_pass(AssemblyContext ctx, Vector statements, Symtab *symtab_ptr, MachineCode *machine_code_ptr,
+                    MemoryCode *memory_code_ptr, Vector *entries_ptr, Fixups *fixups_ptr, IncrementalIndex index) {
+    /* Building the symbol table, the machine code and the data segment. */
+    *symtab_ptr = symtabCreate();
+    *machine_code_ptr = machineCodeCreate();
+    *memory_code_ptr = memoryCodeCreate();
+    *entries_ptr = vectorCreate(NULL);
+    *fixups_ptr = fixupsCreate(assemblyContextGetArena(ctx), assemblyContextGetInternPool(ctx), *machine_code_ptr);
+
+    return run_first_pass_aux(statements, ctx, *symtab_ptr, *machine_code_ptr, *memory_code_ptr, *entries_ptr,
+                              *fixups_ptr, index);
 }
@@ -5,8 +5,15 @@
 #ifndef ASSEMBLER_FIRST_PASS_H
 #define ASSEMBLER_FIRST_PASS_H
 
-#include "linkedlist.h"
+#include "vector.h"
+#include "symtab.h"
+#include "fixups.h"
+#include "machine_code.h"
+#include "memory_code.h"
+#include "assembly_context.h"
+#include "incremental.h"
 
-bool run_first_pass(const char *filename, List *symtab_ptr, List *machine_codes_ptr, List *memory_codes_ptr);
+bool run_first_pass(AssemblyContext ctx, Vector statements, Symtab *symtab_ptr, MachineCode *machine_code_ptr,
+                    MemoryCode *memory_code_ptr, Vector *entries_ptr, Fixups *fixups_ptr, IncrementalIndex index);
 
 #endif //ASSEMBLER_FIRST_PASS_H
@@ -0,0 +1,275 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "fixups.h"
+#include "const_tables.h"
+#include "vector.h"
+#include "errors.h"
+
+#define CHAINS_INITIAL_CAPACITY 64
+#define EXTERN_USES_INITIAL_CAPACITY 16
+
+
+/* An operand of an instruction that refers to a symbol, whose address isn't encoded yet. */
+typedef struct fixup_t *Fixup;
+
+struct fixup_t {
+    SymbolOperand operand;
+    int line_num;
+    SymtabEntry entry; // the symbol, once it is defined
+    bool is_resolved;
+    Fixup next; // the next fixup waiting for the same symbol
+};
+
+/* The operands that refer to symbols which weren't defined when their machine code was created. A forward reference is
+ * chained to its symbol and patched as soon as the symbol is defined. The addresses of the data symbols are only final
+ * once the size of the code is known, so their references are patched at the end of the file, and the references left
+ * without a symbol by then are to undefined symbols. */
+struct fixups_t {
+    Arena arena;
+    InternPool names;
+    MachineCode mc; // the machine code to patch
+
+    Fixup *chains; // the fixups waiting for each symbol, indexed by the ID of its name
+    int chains_capacity;
+
+    Vector pending; // the fixups in the order of their operands, to report the undefined symbols in that order
+
+    Fixup *extern_uses; // the operands that refer to extern symbols
+    int num_extern_uses;
+    int extern_uses_capacity;
+    bool extern_uses_sorted; // by address, unless an extern symbol was used before it was declared
+};
+
+/**
+ * It creates an empty set of fixups. The fixups are allocated from the arena.
+ *
+ * @param arena The arena to allocate the fixups from.
+ * @param names The intern pool of the file.
+ * @param mc The machine code the fixups patch.
+ */
+Fixups fixupsCreate(Arena arena, InternPool names, MachineCode mc) {
+    Fixups fixups = malloc(sizeof(*fixups));
+    if (!fixups)
+        memoryAllocationError();
+
+    fixups->arena = arena;
+    fixups->names = names;
+    fixups->mc = mc;
+    fixups->chains_capacity = CHAINS_INITIAL_CAPACITY;
+    fixups->chains = calloc(fixups->chains_capacity, sizeof(*fixups->chains));
+    fixups->pending = vectorCreate(NULL);
+    fixups->num_extern_uses = 0;
+    fixups->extern_uses_sorted = true;
+    fixups->extern_uses_capacity = EXTERN_USES_INITIAL_CAPACITY;
+    fixups->extern_uses = malloc(fixups->extern_uses_capacity * sizeof(*fixups->extern_uses));
+    if (!fixups->chains || !fixups->extern_uses)
+        memoryAllocationError();
+    return fixups;
+}
+
+/**
+ * It destroys the fixups.
+ *
+ * @param fixups The fixups to destroy.
+ */
+void fixupsDestroy(Fixups fixups) {
+    if (!fixups)
+        return;
+
+    free(fixups->chains);
+    vectorDestroy(fixups->pending);
+    free(fixups->extern_uses);
+    free(fixups);
+}
+
+/**
+ * It chains a fixup to the symbol it waits for.
+ *
+ * @param fixups The fixups.
+ * @param fixup The fixup to chain.
+ * @param symbol_id The ID of the name of the symbol.
+ */
+static void fixupsChain(Fixups fixups, Fixup fixup, int symbol_id) {
+    if (symbol_id >= fixups->chains_capacity) {
+        int old_capacity = fixups->chains_capacity;
+        while (symbol_id >= fixups->chains_capacity) {
+            fixups->chains_capacity *= 2;
+        }
+        fixups->chains = realloc(fixups->chains, fixups->chains_capacity * sizeof(*fixups->chains));
+        if (!fixups->chains)
+            memoryAllocationError();
+        memset(fixups->chains + old_capacity, 0, (fixups->chains_capacity - old_capacity) * sizeof(*fixups->chains));
+    }
+    fixup->next = fixups->chains[symbol_id];
+    fixups->chains[symbol_id] = fixup;
+}
+
+/**
+ * It records an operand that refers to an extern symbol, for the .ext file.
+ *
+ * @param fixups The fixups.
+ * @param fixup The operand.
+ */
+static void fixupsAddExternUse(Fixups fixups, Fixup fixup) {
+    if (fixups->num_extern_uses == fixups->extern_uses_capacity) {
+        fixups->extern_uses_capacity *= 2;
+        fixups->extern_uses = realloc(fixups->extern_uses,
+                                      fixups->extern_uses_capacity * sizeof(*fixups->extern_uses));
+        if (!fixups->extern_uses)
+            memoryAllocationError();
+    }
+    if (fixups->num_extern_uses > 0) {
+        Fixup last = fixups->extern_uses[fixups->num_extern_uses - 1];
+        if (last->operand.address > fixup->operand.address) {
+            fixups->extern_uses_sorted = false;
+        }
+    }
+    fixups->extern_uses[fixups->num_extern_uses++] = fixup;
+}
+
+/**
+ * It encodes the address of the symbol of a fixup.
+ *
+ * @param fixups The fixups.
+ * @param fixup The fixup to resolve.
+ * @param entry The symbol table entry of the symbol.
+ */
+static void fixupsResolve(Fixups fixups, Fixup fixup, SymtabEntry entry) {
+    machineCodeResolveSymbol(fixups->mc, fixup->operand.address, entry, START_ADDRESS_OFFSET);
+    fixup->is_resolved = true;
+    if (symtabEntryGetType(entry) == SYMBOL_EXTERN) {
+        fixupsAddExternUse(fixups, fixup);
+    }
+}
+
+/**
+ * It encodes the addresses of the symbols a new instruction refers to. The code and extern symbols that are already
+ * defined are encoded immediately, and the other operands are recorded as fixups.
+ *
+ * @param fixups The fixups.
+ * @param symbol_operands The operands of the instruction that refer to symbols.
+ * @param num_symbol_operands The number of the operands.
+ * @param line_num The line number of the instruction.
+ * @param symtab The symbol table, with the symbols defined so far.
+ */
+void fixupsAddInstruction(Fixups fixups, const SymbolOperand *symbol_operands, int num_symbol_operands, int line_num,
+                          Symtab symtab) {
+    for (int i = 0; i < num_symbol_operands; ++i) {
+        SymtabEntry entry = symtabFind(symtab, symbol_operands[i].symbol_id);
+        if (entry && symtabEntryGetType(entry) == SYMBOL_CODE) {
+            machineCodeResolveSymbol(fixups->mc, symbol_operands[i].address, entry, START_ADDRESS_OFFSET);
+            continue;
+        }
+
+        Fixup fixup = arenaAlloc(fixups->arena, sizeof(*fixup));
+        fixup->operand = symbol_operands[i];
+        fixup->line_num = line_num;
+        fixup->entry = entry;
+        fixup->is_resolved = false;
+        fixup->next = NULL;
+
+        if (entry && symtabEntryGetType(entry) == SYMBOL_EXTERN) {
+            fixupsResolve(fixups, fixup, entry);
+        } else {
+            vectorAppendMove(fixups->pending, fixup);
+            if (!entry)
+                fixupsChain(fixups, fixup, fixup->operand.symbol_id);
+        }
+    }
+}
+
+/**
+ * It patches the forward references to a symbol that was just defined. The references to a data symbol are only given
+ * the symbol, and are patched at the end of the file, when its address is final.
+ *
+ * @param fixups The fixups.
+ * @param entry The symbol table entry of the symbol.
+ */
+void fixupsDefineSymbol(Fixups fixups, SymtabEntry entry) {
+    int symbol_id = symtabEntryGetNameId(entry);
+    if (symbol_id >= fixups->chains_capacity)
+        return;
+
+    bool is_data = symtabEntryGetType(entry) == SYMBOL_DATA;
+    for (Fixup fixup = fixups->chains[symbol_id]; fixup; fixup = fixup->next) {
+        fixup->entry = entry;
+        if (!is_data)
+            fixupsResolve(fixups, fixup, entry);
+    }
+    fixups->chains[symbol_id] = NULL;
+}
+
+/**
+ * It compares extern uses by their address.
+ */
+static int fixupCmpByAddress(const void *a, const void *b) {
+    Fixup fixup_a = *(Fixup const *) a;
+    Fixup fixup_b = *(Fixup const *) b;
+    return fixup_a->operand.address - fixup_b->operand.address;
+}
+
+/**
+ * It patches the fixups that are left at the end of the file, once the addresses of the data symbols are final, and
+ * reports the symbols that were never defined.
+ *
+ * @param fixups The fixups.
+ * @param filename The name of the file being processed.
+ * @param filename_suffix The suffix of the file being processed.
+ * @param diags The diagnostics to report the undefined symbols to.
+ *
+ * @return true if all the symbols are defined, false otherwise.
+ */
+bool fixupsResolvePending(Fixups fixups, const char *filename, const char *filename_suffix, Diagnostics diags) {
+    bool success = true;
+    for (VectorIterator it = vectorBegin(fixups->pending); it != vectorEnd(fixups->pending); ++it) {
+        Fixup fixup = (Fixup) *it;
+        if (fixup->is_resolved)
+            continue;
+
+        if (!fixup->entry) {
+            success = false;
+            diagnosticsReport(diags, fixup->line_num, "Undefined symbol %s on line %d in file %s%s",
+                    internPoolGetString(fixups->names, fixup->operand.symbol_id), fixup->line_num, filename,
+                    filename_suffix);
+            continue;
+        }
+        fixupsResolve(fixups, fixup, fixup->entry);
+    }
+
+    /* The uses of extern symbols declared after them were recorded out of order. */
+    if (!fixups->extern_uses_sorted) {
+        qsort(fixups->extern_uses, fixups->num_extern_uses, sizeof(*fixups->extern_uses), fixupCmpByAddress);
+        fixups->extern_uses_sorted = true;
+    }
+    return success;
+}
+
+/**
+ * It returns the number of operands that refer to extern symbols.
+ *
+ * @param fixups The fixups.
+ */
+int fixupsGetExternUsesCount(Fixups fixups) {
+    return fixups->num_extern_uses;
+}
+
+/**
+ * It returns the operand of an extern use, as written in the source.
+ *
+ * @param fixups The fixups.
+ * @param index The index of the extern use, in the order of the addresses.
+ */
+const char *fixupsGetExternUseName(Fixups fixups, int index) {
+    return fixups->extern_uses[index]->operand.operand;
+}
+
+/**
+ * It returns the address of the word of an extern use, without the start address offset.
+ *
+ * @param fixups The fixups.
+ * @param index The index of the extern use, in the order of the addresses.
+ */
+int fixupsGetExternUseAddress(Fixups fixups, int index) {
+    return fixups->extern_uses[index]->operand.address;
+}
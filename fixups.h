@@ -0,0 +1,29 @@
+#ifndef ASSEMBLER_FIXUPS_H
+#define ASSEMBLER_FIXUPS_H
+
+#include "arena.h"
+#include "intern_pool.h"
+#include "symtab.h"
+#include "machine_code.h"
+#include "diagnostics.h"
+
+typedef struct fixups_t *Fixups;
+
+Fixups fixupsCreate(Arena arena, InternPool names, MachineCode mc);
+
+void fixupsDestroy(Fixups fixups);
+
+void fixupsAddInstruction(Fixups fixups, const SymbolOperand *symbol_operands, int num_symbol_operands, int line_num,
+                          Symtab symtab);
+
+void fixupsDefineSymbol(Fixups fixups, SymtabEntry entry);
+
+bool fixupsResolvePending(Fixups fixups, const char *filename, const char *filename_suffix, Diagnostics diags);
+
+int fixupsGetExternUsesCount(Fixups fixups);
+
+const char *fixupsGetExternUseName(Fixups fixups, int index);
+
+int fixupsGetExternUseAddress(Fixups fixups, int index);
+
+#endif //ASSEMBLER_FIXUPS_H
@@ -0,0 +1,804 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "incremental.h"
+#include "parser.h"
+#include "const_tables.h"
+#include "file_utils.h"
+#include "errors.h"
+
+#define SOURCE_FILE_SUFFIX ".as"
+#define ARRAY_INITIAL_CAPACITY 64
+#define COMPARE_BLOCK_SIZE 4096
+
+
+/* A growable array of items of a fixed size. */
+typedef struct {
+    void *items;
+    size_t item_size;
+    int length;
+    int capacity;
+} Array;
+
+/* A line of the source, and what the pre-assembly made of it. */
+typedef struct {
+    size_t start; // the offset of the line in the source
+    size_t am_offset; // the offset of the line's text in the .am text, if it is kept
+    int first_statement; // the index of the first statement the line produced, or would have produced
+    bool is_statement; // the line is a single statement, which isn't part of a macro definition or invocation
+    bool in_macro_definition; // a macro definition is open after the line
+} IndexedLine;
+
+/* Where the code and the data of a statement start. */
+typedef struct {
+    int ic;
+    int dc;
+    int first_symbol; // the index of the first symbol the statement defines, in the order of the symbol table
+} StatementPosition;
+
+struct incremental_index_t {
+    char *first_source; // the source of the full assembly, which its statements borrow their text from
+    char *source; // the source of the last assembly
+    size_t source_size;
+
+    size_t next_line_start; // while the lines are recorded
+    Array lines; // an IndexedLine per line of the source, and one past the last line
+    Array positions; // a StatementPosition per statement, and one past the last statement
+    Array references; // a SymbolOperand per operand that refers to a symbol, by the addresses of their words
+    Array macros; // the interned names of the macros
+
+    /* The lists of the last incremental assembly - those of a full assembly are in its arena. */
+    Array entry_symbols;
+    Array extern_uses;
+
+    /* The changed lines, while they are assembled. */
+    Array new_statements;
+    Array new_lines;
+    Array new_positions;
+    Array new_references;
+    Array entry_operands; // the operands of the .entry statements in the lines that changed
+    MachineCode new_code;
+    MemoryCode new_data;
+
+    /* The words whose lines in the object file the last incremental assembly changed, from the first code word. */
+    size_t changed_first;
+    size_t changed_end;
+};
+
+
+/**
+ * It initializes an empty array.
+ *
+ * @param a The array.
+ * @param item_size The size of an item.
+ */
+static void arrayInit(Array *a, size_t item_size) {
+    a->items = NULL;
+    a->item_size = item_size;
+    a->length = 0;
+    a->capacity = 0;
+}
+
+/**
+ * It makes room for a number of items in the array, doubling its capacity.
+ *
+ * @param a The array.
+ * @param length The number of items to make room for.
+ */
+static void arrayReserve(Array *a, int length) {
+    if (length <= a->capacity)
+        return;
+
+    int capacity = a->capacity ? a->capacity : ARRAY_INITIAL_CAPACITY;
+    while (length > capacity) {
+        capacity *= 2;
+    }
+    a->items = realloc(a->items, capacity * a->item_size);
+    if (!a->items)
+        memoryAllocationError();
+    a->capacity = capacity;
+}
+
+/**
+ * It appends an item to the end of the array.
+ *
+ * @param a The array.
+ * @param item The item, which is copied.
+ */
+static void arrayAppend(Array *a, const void *item) {
+    arrayReserve(a, a->length + 1);
+    memcpy((char *) a->items + a->length * a->item_size, item, a->item_size);
+    a->length++;
+}
+
+/**
+ * It replaces a range of the items of the array with all the items of another array, moving the items after it.
+ *
+ * @param a The array.
+ * @param index The index of the first item to replace.
+ * @param count The number of items to replace.
+ * @param replacement The array of the items to put instead.
+ */
+static void arraySplice(Array *a, int index, int count, const Array *replacement) {
+    arrayReserve(a, a->length - count + replacement->length);
+    char *items = a->items;
+    memmove(items + (index + replacement->length) * a->item_size, items + (index + count) * a->item_size,
+            (a->length - index - count) * a->item_size);
+    if (replacement->length)
+        memcpy(items + index * a->item_size, replacement->items, replacement->length * a->item_size);
+    a->length += replacement->length - count;
+}
+
+/**
+ * It creates an empty index for a source that is about to be assembled in full. The index keeps a copy of the source,
+ * which is the one to assemble, since the statements of the assembly borrow their text from it.
+ *
+ * @param source The source.
+ * @param size The size of the source.
+ */
+IncrementalIndex incrementalIndexCreate(const char *source, size_t size) {
+    IncrementalIndex index = calloc(1, sizeof(*index));
+    if (!index)
+        memoryAllocationError();
+
+    arrayInit(&index->lines, sizeof(IndexedLine));
+    arrayInit(&index->positions, sizeof(StatementPosition));
+    arrayInit(&index->references, sizeof(SymbolOperand));
+    arrayInit(&index->macros, sizeof(int));
+    arrayInit(&index->entry_symbols, sizeof(AssemblySymbol));
+    arrayInit(&index->extern_uses, sizeof(AssemblySymbol));
+    arrayInit(&index->new_statements, sizeof(Statement));
+    arrayInit(&index->new_lines, sizeof(IndexedLine));
+    arrayInit(&index->new_positions, sizeof(StatementPosition));
+    arrayInit(&index->new_references, sizeof(SymbolOperand));
+    arrayInit(&index->entry_operands, sizeof(const char *));
+
+    index->first_source = malloc(size + 1);
+    index->source = malloc(size + 1);
+    if (!index->first_source || !index->source)
+        memoryAllocationError();
+    memcpy(index->first_source, source, size);
+    memcpy(index->source, source, size);
+    index->source_size = size;
+    return index;
+}
+
+/**
+ * It destroys the index.
+ *
+ * @param index The index to destroy.
+ */
+void incrementalIndexDestroy(IncrementalIndex index) {
+    if (!index)
+        return;
+
+    Array *arrays[] = {&index->lines, &index->positions, &index->references, &index->macros, &index->entry_symbols,
+                       &index->extern_uses, &index->new_statements, &index->new_lines, &index->new_positions,
+                       &index->new_references, &index->entry_operands};
+    for (size_t i = 0; i < sizeof(arrays) / sizeof(*arrays); ++i) {
+        free(arrays[i]->items);
+    }
+    machineCodeDestroy(index->new_code);
+    memoryCodeDestroy(index->new_data);
+    free(index->first_source);
+    free(index->source);
+    free(index);
+}
+
+/**
+ * It returns the copy of the source the index was created for, to assemble in full.
+ *
+ * @param index The index.
+ */
+const char *incrementalIndexGetSource(IncrementalIndex index) {
+    return index->first_source;
+}
+
+/**
+ * It records what the pre-assembly made of the next line of the source.
+ *
+ * @param index The index.
+ * @param line_len The length of the line, including its '\n' if it has one.
+ * @param is_statement Whether the line became a single statement of its own, outside of any macro.
+ * @param in_macro_definition Whether a macro definition is open after the line.
+ * @param statement_index The number of statements before the line's.
+ * @param am_offset The length of the .am text before the line's.
+ */
+void incrementalIndexAddLine(IncrementalIndex index, size_t line_len, bool is_statement, bool in_macro_definition,
+                             int statement_index, size_t am_offset) {
+    IndexedLine line = {index->next_line_start, am_offset, statement_index, is_statement, in_macro_definition};
+    arrayAppend(&index->lines, &line);
+    index->next_line_start += line_len;
+}
+
+/**
+ * It records the end of the lines of the source, once the pre-assembly is done.
+ *
+ * @param index The index.
+ * @param num_statements The number of statements of the .am file.
+ * @param am_size The length of the .am text.
+ */
+void incrementalIndexEndLines(IncrementalIndex index, int num_statements, size_t am_size) {
+    IndexedLine end = {index->next_line_start, am_size, num_statements, false, false};
+    arrayAppend(&index->lines, &end);
+}
+
+/**
+ * It records the name of a macro the source defines.
+ *
+ * @param index The index.
+ * @param name_id The interned name of the macro.
+ */
+void incrementalIndexAddMacro(IncrementalIndex index, int name_id) {
+    arrayAppend(&index->macros, &name_id);
+}
+
+/**
+ * It records where the code and the data of the next statement start. The first pass also records where they end, as
+ * one more statement after the last one.
+ *
+ * @param index The index.
+ * @param ic The address of the statement's code.
+ * @param dc The offset of the statement's data.
+ * @param first_symbol The number of symbols defined before the statement.
+ */
+void incrementalIndexAddStatement(IncrementalIndex index, size_t ic, size_t dc, int first_symbol) {
+    StatementPosition position = {(int) ic, (int) dc, first_symbol};
+    arrayAppend(&index->positions, &position);
+}
+
+/**
+ * It records the operands of an instruction that refer to symbols. The instructions are recorded by the order of their
+ * addresses.
+ *
+ * @param index The index.
+ * @param symbol_operands The operands.
+ * @param count The number of operands.
+ */
+void incrementalIndexAddSymbolOperands(IncrementalIndex index, const SymbolOperand *symbol_operands, int count) {
+    for (int i = 0; i < count; ++i) {
+        arrayAppend(&index->references, &symbol_operands[i]);
+    }
+}
+
+/**
+ * It returns the words whose lines in the object file the last incremental assembly changed - the words are numbered
+ * from the first word of the code, and the data follows the code. The range is empty if nothing changed.
+ *
+ * @param index The index.
+ * @param first Set to the first changed word.
+ * @param end Set to one past the last changed word.
+ */
+void incrementalIndexGetChangedWords(IncrementalIndex index, size_t *first, size_t *end) {
+    *first = index->changed_first;
+    *end = index->changed_end;
+}
+
+/**
+ * It adds a range of words to the words the assembly changed.
+ *
+ * @param index The index.
+ * @param first The first changed word.
+ * @param end One past the last changed word.
+ */
+static void markChanged(IncrementalIndex index, size_t first, size_t end) {
+    if (first >= end)
+        return;
+
+    if (index->changed_first == index->changed_end) {
+        index->changed_first = first;
+        index->changed_end = end;
+        return;
+    }
+    if (first < index->changed_first)
+        index->changed_first = first;
+    if (end > index->changed_end)
+        index->changed_end = end;
+}
+
+/**
+ * It returns the length of the common prefix of two blocks of memory, a block of COMPARE_BLOCK_SIZE at a time.
+ *
+ * @param a The first block.
+ * @param b The second block.
+ * @param size The size of the shorter block.
+ */
+static size_t commonPrefix(const char *a, const char *b, size_t size) {
+    size_t len = 0;
+    while (len + COMPARE_BLOCK_SIZE <= size && memcmp(a + len, b + len, COMPARE_BLOCK_SIZE) == 0) {
+        len += COMPARE_BLOCK_SIZE;
+    }
+    while (len < size && a[len] == b[len]) {
+        len++;
+    }
+    return len;
+}
+
+/**
+ * It returns the length of the common suffix of two blocks of memory, a block of COMPARE_BLOCK_SIZE at a time.
+ *
+ * @param a_end The end of the first block.
+ * @param b_end The end of the second block.
+ * @param size The size of the shorter block.
+ */
+static size_t commonSuffix(const char *a_end, const char *b_end, size_t size) {
+    size_t len = 0;
+    while (len + COMPARE_BLOCK_SIZE <= size &&
+           memcmp(a_end - len - COMPARE_BLOCK_SIZE, b_end - len - COMPARE_BLOCK_SIZE, COMPARE_BLOCK_SIZE) == 0) {
+        len += COMPARE_BLOCK_SIZE;
+    }
+    while (len < size && a_end[-1 - (ptrdiff_t) len] == b_end[-1 - (ptrdiff_t) len]) {
+        len++;
+    }
+    return len;
+}
+
+/**
+ * It finds the first line of the old source that the new source changed.
+ *
+ * @param index The index.
+ * @param prefix The length of the common prefix of the old and the new source.
+ */
+static int firstChangedLine(IncrementalIndex index, size_t prefix) {
+    const IndexedLine *lines = index->lines.items;
+    int num_lines = index->lines.length - 1;
+
+    /* The first line that doesn't end within the common prefix. */
+    int low = 0, high = num_lines;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (lines[mid + 1].start <= prefix) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    /* The last line may not end with a '\n', so the new source may continue it. */
+    if (low == num_lines && num_lines > 0 && index->source[index->source_size - 1] != '\n')
+        low--;
+    return low;
+}
+
+/**
+ * It finds the first line of the old source, from a line on, that the new source has as is, and every line after it.
+ *
+ * @param index The index.
+ * @param from The line to start from.
+ * @param suffix The length of the common suffix of the old and the new source.
+ * @param source The new source.
+ * @param size The size of the new source.
+ */
+static int firstUnchangedLine(IncrementalIndex index, int from, size_t suffix, const char *source, size_t size) {
+    const IndexedLine *lines = index->lines.items;
+    int num_lines = index->lines.length - 1;
+    size_t suffix_start = index->source_size - suffix;
+
+    /* The first line that starts within the common suffix. */
+    int low = from, high = num_lines;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (lines[mid].start >= suffix_start) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    /* A line right at the start of the suffix only starts a line in the new source if a '\n' is before it there too. */
+    if (low < num_lines && lines[low].start == suffix_start) {
+        size_t new_start = suffix_start + size - index->source_size;
+        if (new_start > 0 && source[new_start - 1] != '\n')
+            low++;
+    }
+    return low;
+}
+
+/**
+ * It checks if a statement invokes one of the macros of the source.
+ *
+ * @param index The index.
+ * @param names The intern pool of the file.
+ * @param s The statement.
+ */
+static bool isMacroInvocation(IncrementalIndex index, InternPool names, Statement s) {
+    if (statementGetType(s) == COMMENT || statementGetType(s) == EMPTY_LINE)
+        return false;
+
+    int name_id = internPoolFind(names, statementGetTokenAt(s, 0), statementGetTokenSpanAt(s, 0).length);
+    const int *macros = index->macros.items;
+    for (int i = 0; i < index->macros.length; ++i) {
+        if (macros[i] == name_id)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * It parses the changed lines of the new source. They are copied to the arena first, as the statements borrow their
+ * text. Only lines that are statements of their own are handled - a line that defines or invokes a macro changes the
+ * statements of other lines too.
+ *
+ * @param index The index.
+ * @param ctx The assembly context of the file.
+ * @param text The changed lines.
+ * @param len The length of the changed lines.
+ * @param start The offset of the changed lines in the new source.
+ * @param first_line The index of the first changed line.
+ * @param first_statement The index of the statement of the first changed line.
+ * @param am_offset The offset of the changed lines in the .am text.
+ *
+ * @return false if a changed line isn't a statement of its own, true otherwise.
+ */
+static bool parseChangedLines(IncrementalIndex index, AssemblyContext ctx, const char *text, size_t len, size_t start,
+                              int first_line, int first_statement, size_t am_offset) {
+    Arena arena = assemblyContextGetArena(ctx);
+    InternPool names = assemblyContextGetInternPool(ctx);
+    bool keep_am = assemblyContextGetOptions(ctx)->keep_am;
+
+    char *copy = arenaAlloc(arena, len);
+    memcpy(copy, text, len);
+
+    index->new_statements.length = 0;
+    index->new_lines.length = 0;
+    size_t line_start = 0;
+    while (line_start < len) {
+        const char *newline = memchr(copy + line_start, '\n', len - line_start);
+        size_t line_end = newline ? (size_t) (newline - copy) + 1 : len;
+        int statement_index = first_statement + index->new_statements.length;
+
+        int line_num = first_line + index->new_lines.length + 1;
+
+        Statement s = parse(arena, copy + line_start, line_end - line_start, line_num);
+        if (!s || statementGetType(s) == MACRO_START || statementGetType(s) == MACRO_END ||
+            isMacroInvocation(index, names, s))
+            return false;
+
+        IndexedLine line = {start + line_start, keep_am ? am_offset + line_start : 0, statement_index, true, false};
+        arrayAppend(&index->new_lines, &line);
+        arrayAppend(&index->new_statements, &s);
+        line_start = line_end;
+    }
+    return true;
+}
+
+/**
+ * It gives a symbol the changed lines define its new value. The changed lines have to define the same symbols as the
+ * lines they replace, in the same order, so that the symbol table stays in the order of the definitions.
+ *
+ * @param symtab The symbol table.
+ * @param symbol_index The index of the symbol in the symbol table.
+ * @param end_index The index of the first symbol the lines after the changed lines define.
+ * @param name_id The interned name of the symbol.
+ * @param type The type of the symbol.
+ * @param value The value of the symbol.
+ * @param moved Set to true if the value of the symbol changed.
+ *
+ * @return false if the changed lines define a different symbol there, true otherwise.
+ */
+static bool redefineSymbol(Symtab symtab, int symbol_index, int end_index, int name_id, SymbolType type, int value,
+                           bool *moved) {
+    if (symbol_index >= end_index)
+        return false;
+
+    SymtabEntry entry = symtabGetEntryAt(symtab, symbol_index);
+    if (symtabEntryGetNameId(entry) != name_id || symtabEntryGetType(entry) != type)
+        return false;
+    if (symtabEntryGetValue(entry) != value) {
+        symtabEntrySetValue(entry, value);
+        *moved = true;
+    }
+    return true;
+}
+
+/**
+ * It collects the operands of the .entry statements in a range of the statements.
+ *
+ * @param index The index.
+ * @param statements The statements of the .am file.
+ * @param first The index of the first statement.
+ * @param end One past the index of the last statement.
+ */
+static void collectEntryOperands(IncrementalIndex index, Vector statements, int first, int end) {
+    index->entry_operands.length = 0;
+    for (int i = first; i < end; ++i) {
+        Statement s = vectorGetDataAt(statements, i);
+        if (statementGetType(s) == DIRECTIVE && strcmp(statementGetMnemonic(s), DIRECTIVE_ENTRY) == 0) {
+            const char *operand = statementGetOperandAt(s, 0);
+            arrayAppend(&index->entry_operands, &operand);
+        }
+    }
+}
+
+/**
+ * It runs the first pass over the statements of the changed lines, into code and data of their own - like
+ * run_first_pass_aux does, only without reporting errors, since any error sends the file to a full assembly.
+ *
+ * @param index The index, with the statements of the changed lines.
+ * @param ctx The assembly context of the file.
+ * @param symtab The symbol table.
+ * @param first The position of the first changed statement.
+ * @param end The position of the first statement after the changed ones.
+ * @param moved Set to true if a symbol the changed lines define moved.
+ *
+ * @return false if the changed lines have an error, or define other symbols or .entry symbols than before.
+ */
+static bool runFirstPassOnChangedLines(IncrementalIndex index, AssemblyContext ctx, Symtab symtab,
+                                       const StatementPosition *first, const StatementPosition *end, bool *moved) {
+    const char *filename = assemblyContextGetFilename(ctx);
+    Diagnostics diags = assemblyContextGetDiagnostics(ctx);
+    InternPool names = assemblyContextGetInternPool(ctx);
+
+    machineCodeDestroy(index->new_code);
+    memoryCodeDestroy(index->new_data);
+    index->new_code = NULL;
+    index->new_data = NULL;
+    index->new_code = machineCodeCreate();
+    index->new_data = memoryCodeCreate();
+    index->new_positions.length = 0;
+    index->new_references.length = 0;
+
+    int symbol_index = first->first_symbol, num_entries = 0;
+    const char *const *entry_operands = index->entry_operands.items;
+    for (int i = 0; i < index->new_statements.length; ++i) {
+        Statement s = ((Statement *) index->new_statements.items)[i];
+        int ic = first->ic + (int) machineCodeGetSize(index->new_code);
+        int dc = first->dc + (int) memoryCodeGetSize(index->new_data);
+        StatementPosition position = {ic, dc, symbol_index};
+        arrayAppend(&index->new_positions, &position);
+
+        if (statementGetLineLength(s) > MAX_LINE_LEN || !statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX, diags))
+            return false;
+        if (statementGetType(s) == EMPTY_LINE || statementGetType(s) == COMMENT)
+            continue;
+
+        const char *label = statementGetLabel(s);
+        if (label) {
+            int label_id = internPoolIntern(names, label, strlen(label));
+            bool is_data = statementGetType(s) == DIRECTIVE;
+            if (!redefineSymbol(symtab, symbol_index++, end->first_symbol, label_id,
+                                is_data ? SYMBOL_DATA : SYMBOL_CODE, is_data ? dc : ic, moved))
+                return false;
+        }
+
+        if (statementGetType(s) == DIRECTIVE) {
+            const char *directive = statementGetMnemonic(s);
+            if (label && isDataStoreDirective(directive)) {
+                memoryCodeAppendDirective(index->new_data, s);
+            } else if (strcmp(directive, DIRECTIVE_ENTRY) == 0) {
+                if (num_entries == index->entry_operands.length ||
+                    strcmp(entry_operands[num_entries++], statementGetOperandAt(s, 0)) != 0)
+                    return false;
+            } else if (strcmp(directive, DIRECTIVE_EXTERN) == 0) {
+                assert(statementGetOperandsCount(s) == 1);
+
+                const char *extern_operand = statementGetOperandAt(s, 0);
+                int extern_id = internPoolIntern(names, extern_operand, strlen(extern_operand));
+                if (!redefineSymbol(symtab, symbol_index++, end->first_symbol, extern_id, SYMBOL_EXTERN, 0, moved))
+                    return false;
+            }
+        } else { // INSTRUCTION
+            SymbolOperand symbol_operands[MAX_OPERANDS_COUNT];
+            int num_symbol_operands = machineCodeAppendInstruction(index->new_code, names, s, symbol_operands);
+            for (int j = 0; j < num_symbol_operands; ++j) {
+                symbol_operands[j].address += first->ic;
+                arrayAppend(&index->new_references, &symbol_operands[j]);
+            }
+        }
+    }
+    return symbol_index == end->first_symbol && num_entries == index->entry_operands.length;
+}
+
+/**
+ * It finds the first operand that refers to a symbol from an address on.
+ *
+ * @param index The index.
+ * @param address The address.
+ */
+static int firstReferenceFrom(IncrementalIndex index, int address) {
+    const SymbolOperand *references = index->references.items;
+    int low = 0, high = index->references.length;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (references[mid].address < address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/**
+ * It encodes the addresses of the symbols the operands refer to again - those of the changed lines, and if any symbol
+ * moved those of all the operands - and collects the uses of the extern symbols.
+ *
+ * @param index The index.
+ * @param symtab The symbol table.
+ * @param machine_code The machine code.
+ * @param first_new The index of the first operand of the changed lines.
+ * @param end_new One past the index of the last operand of the changed lines.
+ * @param moved Whether a symbol moved.
+ *
+ * @return false if an operand refers to an undefined symbol, true otherwise.
+ */
+static bool resolveReferences(IncrementalIndex index, Symtab symtab, MachineCode machine_code, int first_new,
+                              int end_new, bool moved) {
+    const SymbolOperand *references = index->references.items;
+    const unsigned short *words = machineCodeGetWords(machine_code);
+
+    index->extern_uses.length = 0;
+    for (int i = 0; i < index->references.length; ++i) {
+        SymtabEntry entry = symtabFind(symtab, references[i].symbol_id);
+        if (!entry)
+            return false;
+
+        int address = references[i].address;
+        if (moved || (i >= first_new && i < end_new)) {
+            unsigned short word = words[address];
+            machineCodeResolveSymbol(machine_code, address, entry, START_ADDRESS_OFFSET);
+            if (words[address] != word)
+                markChanged(index, address, address + 1);
+        }
+        if (symtabEntryGetType(entry) == SYMBOL_EXTERN) {
+            AssemblySymbol use = {references[i].operand, address + START_ADDRESS_OFFSET};
+            arrayAppend(&index->extern_uses, &use);
+        }
+    }
+    return true;
+}
+
+/**
+ * It collects the .entry symbols and their addresses, in the order the symbols were defined.
+ *
+ * @param index The index.
+ * @param symtab The symbol table.
+ * @param data_segment_address The address of the data segment.
+ */
+static void collectEntrySymbols(IncrementalIndex index, Symtab symtab, int data_segment_address) {
+    index->entry_symbols.length = 0;
+    for (int i = 0; i < symtabSize(symtab); ++i) {
+        SymtabEntry entry = symtabGetEntryAt(symtab, i);
+        if (symtabEntryIsEntry(entry)) {
+            AssemblySymbol symbol = {symtabEntryGetName(entry),
+                                     symtabEntryGetAddress(entry, data_segment_address) + START_ADDRESS_OFFSET};
+            arrayAppend(&index->entry_symbols, &symbol);
+        }
+    }
+}
+
+/**
+ * It assembles an edited source again, from the state of the last assembly of the file. The source is compared with the
+ * last one to find the lines that changed, and only they are parsed and run through the first pass. Their code and data
+ * replace the code and data of the lines they replace, the symbols after them move by the difference in sizes, and
+ * only the operands of the changed lines, or all the operands if a symbol moved, are encoded again.
+ *
+ * The line numbers of the statements after the changed lines aren't updated - they only appear in diagnostics, and a
+ * source with errors is always assembled in full.
+ *
+ * @param index The index of the last assembly, which has to have succeeded.
+ * @param ctx The assembly context of the file.
+ * @param source The new source.
+ * @param size The size of the new source.
+ * @param statements The statements of the .am file.
+ * @param symtab The symbol table.
+ * @param machine_code The machine code.
+ * @param memory_code The data segment.
+ * @param am The .am text, if it is kept.
+ * @param entry_symbols Set to the .entry symbols.
+ * @param extern_uses Set to the uses of extern symbols.
+ *
+ * @return true if the source was assembled, or false if it has to be assembled in full - the lines that changed define
+ * or invoke macros, define other symbols, have errors, or refer to undefined symbols. The state may be half-updated
+ * then, so it has to be thrown away.
+ */
+bool incrementalReassemble(IncrementalIndex index, AssemblyContext ctx, const char *source, size_t size,
+                           Vector statements, Symtab symtab, MachineCode machine_code, MemoryCode memory_code,
+                           StrBuffer *am, SymbolList *entry_symbols, SymbolList *extern_uses) {
+    index->changed_first = index->changed_end = 0;
+    size_t old_size = index->source_size;
+    size_t prefix = commonPrefix(index->source, source, old_size < size ? old_size : size);
+    if (prefix == old_size && prefix == size)
+        return true;
+    size_t suffix = commonSuffix(index->source + old_size, source + size,
+                                 (old_size < size ? old_size : size) - prefix);
+
+    /* The changed lines - first_line...end_line in the old source, and the same lines up to new_end in the new one. */
+    int first_line = firstChangedLine(index, prefix);
+    int end_line = firstUnchangedLine(index, first_line, suffix, source, size);
+    IndexedLine *lines = index->lines.items;
+    if (first_line > 0 && lines[first_line - 1].in_macro_definition)
+        return false;
+    for (int i = first_line; i < end_line; ++i) {
+        if (!lines[i].is_statement)
+            return false;
+    }
+    size_t start = lines[first_line].start, old_end = lines[end_line].start;
+    size_t new_end = old_end + size - old_size;
+    size_t am_start = lines[first_line].am_offset, am_end = lines[end_line].am_offset;
+
+    int first_statement = lines[first_line].first_statement, end_statement = lines[end_line].first_statement;
+    if (!parseChangedLines(index, ctx, source + start, new_end - start, start, first_line, first_statement,
+                           am_start))
+        return false;
+
+    StatementPosition first = ((StatementPosition *) index->positions.items)[first_statement];
+    StatementPosition end = ((StatementPosition *) index->positions.items)[end_statement];
+    collectEntryOperands(index, statements, first_statement, end_statement);
+    bool moved = false;
+    if (!runFirstPassOnChangedLines(index, ctx, symtab, &first, &end, &moved))
+        return false;
+
+    /* The code, the data and the symbols after the changed lines move by the difference in sizes. */
+    int delta_ic = (int) machineCodeGetSize(index->new_code) - (end.ic - first.ic);
+    int delta_dc = (int) memoryCodeGetSize(index->new_data) - (end.dc - first.dc);
+    machineCodeSplice(machine_code, first.ic, end.ic - first.ic, index->new_code);
+    memoryCodeSplice(memory_code, first.dc, end.dc - first.dc, index->new_data);
+    if (delta_ic || delta_dc) {
+        moved = true;
+        for (int i = end.first_symbol; i < symtabSize(symtab); ++i) {
+            SymtabEntry entry = symtabGetEntryAt(symtab, i);
+            if (symtabEntryGetType(entry) == SYMBOL_CODE) {
+                symtabEntrySetValue(entry, symtabEntryGetValue(entry) + delta_ic);
+            } else if (symtabEntryGetType(entry) == SYMBOL_DATA) {
+                symtabEntrySetValue(entry, symtabEntryGetValue(entry) + delta_dc);
+            }
+        }
+    }
+
+    /* The statements, their positions and their operands. */
+    int delta_statements = index->new_statements.length - (end_statement - first_statement);
+    vectorSplice(statements, first_statement, end_statement - first_statement, index->new_statements.items,
+                 index->new_statements.length);
+    arraySplice(&index->positions, first_statement, end_statement - first_statement, &index->new_positions);
+    StatementPosition *positions = index->positions.items;
+    for (int i = first_statement + index->new_positions.length; i < index->positions.length; ++i) {
+        positions[i].ic += delta_ic;
+        positions[i].dc += delta_dc;
+    }
+
+    int first_reference = firstReferenceFrom(index, first.ic), end_reference = firstReferenceFrom(index, end.ic);
+    arraySplice(&index->references, first_reference, end_reference - first_reference, &index->new_references);
+    SymbolOperand *references = index->references.items;
+    for (int i = first_reference + index->new_references.length; i < index->references.length; ++i) {
+        references[i].address += delta_ic;
+    }
+
+    /* The lines, and the source and the .am text they are in. */
+    arraySplice(&index->lines, first_line, end_line - first_line, &index->new_lines);
+    lines = index->lines.items;
+    for (int i = first_line + index->new_lines.length; i < index->lines.length; ++i) {
+        lines[i].start = lines[i].start + size - old_size;
+        if (am)
+            lines[i].am_offset = lines[i].am_offset + (new_end - start) - (am_end - am_start);
+        lines[i].first_statement += delta_statements;
+    }
+    if (size > old_size) {
+        index->source = realloc(index->source, size + 1);
+        if (!index->source)
+            memoryAllocationError();
+    }
+    memcpy(index->source, source, size);
+    index->source_size = size;
+    if (am)
+        strBufferReplace(am, am_start, am_end - am_start, source + start, new_end - start);
+
+    if (!resolveReferences(index, symtab, machine_code, first_reference,
+                           first_reference + index->new_references.length, moved))
+        return false;
+    size_t code_size = machineCodeGetSize(machine_code), data_size = memoryCodeGetSize(memory_code);
+    collectEntrySymbols(index, symtab, (int) code_size);
+    entry_symbols->symbols = index->entry_symbols.items;
+    entry_symbols->count = index->entry_symbols.length;
+    extern_uses->symbols = index->extern_uses.items;
+    extern_uses->count = index->extern_uses.length;
+
+    /* The lines of the object file after the first moved word have all changed. */
+    if (delta_ic) {
+        markChanged(index, first.ic, code_size + data_size);
+    } else {
+        markChanged(index, first.ic, first.ic + machineCodeGetSize(index->new_code));
+        markChanged(index, code_size + first.dc,
+                    delta_dc ? code_size + data_size : code_size + first.dc + memoryCodeGetSize(index->new_data));
+    }
+    return true;
+}
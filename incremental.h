@@ -0,0 +1,44 @@
+#ifndef ASSEMBLER_INCREMENTAL_H
+#define ASSEMBLER_INCREMENTAL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "assembly_context.h"
+#include "vector.h"
+#include "symtab.h"
+#include "machine_code.h"
+#include "memory_code.h"
+#include "second_pass.h"
+#include "str_utils.h"
+
+/* What the passes made of each part of a source, kept after it is assembled so that an edited version of the source can
+ * be assembled again by parsing and encoding only the lines that changed. The pre-assembly records what each line of the
+ * source turned into, and the first pass records where the code and the data of each statement start and every operand
+ * that refers to a symbol. */
+
+typedef struct incremental_index_t *IncrementalIndex;
+
+IncrementalIndex incrementalIndexCreate(const char *source, size_t size);
+
+void incrementalIndexDestroy(IncrementalIndex index);
+
+const char *incrementalIndexGetSource(IncrementalIndex index);
+
+void incrementalIndexAddLine(IncrementalIndex index, size_t line_len, bool is_statement, bool in_macro_definition,
+                             int statement_index, size_t am_offset);
+
+void incrementalIndexEndLines(IncrementalIndex index, int num_statements, size_t am_size);
+
+void incrementalIndexAddMacro(IncrementalIndex index, int name_id);
+
+void incrementalIndexAddStatement(IncrementalIndex index, size_t ic, size_t dc, int first_symbol);
+
+void incrementalIndexAddSymbolOperands(IncrementalIndex index, const SymbolOperand *symbol_operands, int count);
+
+bool incrementalReassemble(IncrementalIndex index, AssemblyContext ctx, const char *source, size_t size,
+                           Vector statements, Symtab symtab, MachineCode machine_code, MemoryCode memory_code,
+                           StrBuffer *am, SymbolList *entry_symbols, SymbolList *extern_uses);
+
+void incrementalIndexGetChangedWords(IncrementalIndex index, size_t *first, size_t *end);
+
+#endif //ASSEMBLER_INCREMENTAL_H
@@ -0,0 +1,24 @@
+mov r1, r2
+mov ,r1 r2
+mov r1 r2,
+mov r1,,r2
+X: inc X,
+X: inc X ,
+mov r1 , r2
+	mov	r1,	r2
+Y: .data 1, 2,3 , 4
+Z: .data 1,,2
+W: .data ,1,2
+V: .data 1,2,
+S: .string "ab,c"
+T: .struct 3, "xy"
+U: .struct 3 "xy"
+.entry X,
+.extern Q ,
+cmp #1,r1
+rts ,
+stop
+A: .data 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21
+; comment, with, commas
+mov mov, r1
+prn movx
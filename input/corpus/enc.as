@@ -0,0 +1,21 @@
+.extern EX
+.entry MAIN
+MAIN: mov #-1, r3
+ cmp #300, #-300
+ add ST.2, EX
+ sub r1, r7
+ lea ST.1, r0
+ prn #-128
+ prn #127
+ prn #255
+ jmp EX
+ jsr ST.1
+ not r6
+ clr MAIN
+ inc EX
+ lea EX.2, r1
+ rts
+ hlt
+D: .data -1, -600, 2000, 511, -512, 0, 1023, 1024
+ST: .struct -5, "hi"
+STR: .string "xyz"
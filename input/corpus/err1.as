@@ -0,0 +1,16 @@
+MAIN:   mov r1, r2
+MAIN:   add r1, r2
+X:      .data 1,,2
+Y:      .data 1, 2,
+        mov #1, #2
+        foo r1
+        lea #1, r2
+        prn
+mov:    inc r1
+1abc:   inc r1
+        .string abc
+        .struct 1
+.extern Q
+.extern Q
+        inc r9
+        mov r1 r2
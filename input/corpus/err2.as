@@ -0,0 +1,6 @@
+.entry NOPE
+.extern EXT
+.entry EXT
+MAIN:   mov r1, r2
+        inc EXT
+        hlt
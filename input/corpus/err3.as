@@ -0,0 +1,4 @@
+MAIN:   jmp UNDEF
+        inc r1
+        mov S9.1, r2
+        hlt
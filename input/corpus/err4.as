@@ -0,0 +1,10 @@
+        macro m1
+            inc r1
+        endmacro
+        macro m1
+            dec r1
+        endmacro
+        macro mov
+        endmacro
+        m1
+        hlt
@@ -0,0 +1,29 @@
+; externs and entries
+.extern W
+.extern L3
+.entry LOOP
+.entry LENGTH
+MAIN:   mov S1.1 ,W
+        add r2,STR
+LOOP:   jmp W
+        macro m2
+            inc L3
+            cmp #3, r1
+        endmacro
+        prn #-5
+        sub r1 , r4
+        m2
+        lea STR, r6
+        m2
+        clr S1.2
+        not r2
+        dec L3
+        bne LOOP
+        get r7
+        jsr W
+        rts
+END:    hlt
+STR:    .string "abcdef"
+LENGTH: .data 6,-9,15
+K:      .data 22, +7, -1
+S1:     .struct 8, "ab"
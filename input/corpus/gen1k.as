@@ -0,0 +1,1107 @@
+.extern XT1
+.extern XT2
+        macro mm
+            inc K0
+            mov r1, r2
+        endmacro
+L0:    mov S0.1 ,K0
+        add r2,L0
+        jmp L20
+        mm
+        prn #-4
+        sub r1 , XT1
+K0:    .data 6,-9,15
+S0:    .struct 8, "ab"
+T0:    .string "abcdef"
+; comment line
+.entry K0
+L10:    mov S1.1 ,K1
+        add r2,L10
+        jmp L30
+        mm
+        prn #-14
+        sub r1 , XT1
+K1:    .data 16,-9,15
+S1:    .struct 8, "ab"
+T1:    .string "abcdef"
+; comment line
+.entry K1
+L20:    mov S2.1 ,K2
+        add r2,L20
+        jmp L40
+        mm
+        prn #-24
+        sub r1 , XT1
+K2:    .data 26,-9,15
+S2:    .struct 8, "ab"
+T2:    .string "abcdef"
+; comment line
+.entry K2
+L30:    mov S3.1 ,K3
+        add r2,L30
+        jmp L50
+        mm
+        prn #-34
+        sub r1 , XT1
+K3:    .data 36,-9,15
+S3:    .struct 8, "ab"
+T3:    .string "abcdef"
+; comment line
+.entry K3
+L40:    mov S4.1 ,K4
+        add r2,L40
+        jmp L60
+        mm
+        prn #-44
+        sub r1 , XT1
+K4:    .data 46,-9,15
+S4:    .struct 8, "ab"
+T4:    .string "abcdef"
+; comment line
+.entry K4
+L50:    mov S5.1 ,K5
+        add r2,L50
+        jmp L70
+        mm
+        prn #-54
+        sub r1 , XT1
+K5:    .data 6,-9,15
+S5:    .struct 8, "ab"
+T5:    .string "abcdef"
+; comment line
+.entry K5
+L60:    mov S6.1 ,K6
+        add r2,L60
+        jmp L80
+        mm
+        prn #-64
+        sub r1 , XT1
+K6:    .data 16,-9,15
+S6:    .struct 8, "ab"
+T6:    .string "abcdef"
+; comment line
+.entry K6
+L70:    mov S7.1 ,K7
+        add r2,L70
+        jmp L90
+        mm
+        prn #-74
+        sub r1 , XT1
+K7:    .data 26,-9,15
+S7:    .struct 8, "ab"
+T7:    .string "abcdef"
+; comment line
+.entry K7
+L80:    mov S8.1 ,K8
+        add r2,L80
+        jmp L100
+        mm
+        prn #-84
+        sub r1 , XT1
+K8:    .data 36,-9,15
+S8:    .struct 8, "ab"
+T8:    .string "abcdef"
+; comment line
+.entry K8
+L90:    mov S9.1 ,K9
+        add r2,L90
+        jmp L110
+        mm
+        prn #-94
+        sub r1 , XT1
+K9:    .data 46,-9,15
+S9:    .struct 8, "ab"
+T9:    .string "abcdef"
+; comment line
+.entry K9
+L100:    mov S10.1 ,K10
+        add r2,L100
+        jmp L120
+        mm
+        prn #-4
+        sub r1 , XT1
+K10:    .data 6,-9,15
+S10:    .struct 8, "ab"
+T10:    .string "abcdef"
+; comment line
+.entry K10
+L110:    mov S11.1 ,K11
+        add r2,L110
+        jmp L130
+        mm
+        prn #-14
+        sub r1 , XT1
+K11:    .data 16,-9,15
+S11:    .struct 8, "ab"
+T11:    .string "abcdef"
+; comment line
+.entry K11
+L120:    mov S12.1 ,K12
+        add r2,L120
+        jmp L140
+        mm
+        prn #-24
+        sub r1 , XT1
+K12:    .data 26,-9,15
+S12:    .struct 8, "ab"
+T12:    .string "abcdef"
+; comment line
+.entry K12
+L130:    mov S13.1 ,K13
+        add r2,L130
+        jmp L150
+        mm
+        prn #-34
+        sub r1 , XT1
+K13:    .data 36,-9,15
+S13:    .struct 8, "ab"
+T13:    .string "abcdef"
+; comment line
+.entry K13
+L140:    mov S14.1 ,K14
+        add r2,L140
+        jmp L160
+        mm
+        prn #-44
+        sub r1 , XT1
+K14:    .data 46,-9,15
+S14:    .struct 8, "ab"
+T14:    .string "abcdef"
+; comment line
+.entry K14
+L150:    mov S15.1 ,K15
+        add r2,L150
+        jmp L170
+        mm
+        prn #-54
+        sub r1 , XT1
+K15:    .data 6,-9,15
+S15:    .struct 8, "ab"
+T15:    .string "abcdef"
+; comment line
+.entry K15
+L160:    mov S16.1 ,K16
+        add r2,L160
+        jmp L180
+        mm
+        prn #-64
+        sub r1 , XT1
+K16:    .data 16,-9,15
+S16:    .struct 8, "ab"
+T16:    .string "abcdef"
+; comment line
+.entry K16
+L170:    mov S17.1 ,K17
+        add r2,L170
+        jmp L190
+        mm
+        prn #-74
+        sub r1 , XT1
+K17:    .data 26,-9,15
+S17:    .struct 8, "ab"
+T17:    .string "abcdef"
+; comment line
+.entry K17
+L180:    mov S18.1 ,K18
+        add r2,L180
+        jmp L200
+        mm
+        prn #-84
+        sub r1 , XT1
+K18:    .data 36,-9,15
+S18:    .struct 8, "ab"
+T18:    .string "abcdef"
+; comment line
+.entry K18
+L190:    mov S19.1 ,K19
+        add r2,L190
+        jmp L210
+        mm
+        prn #-94
+        sub r1 , XT1
+K19:    .data 46,-9,15
+S19:    .struct 8, "ab"
+T19:    .string "abcdef"
+; comment line
+.entry K19
+L200:    mov S20.1 ,K20
+        add r2,L200
+        jmp L220
+        mm
+        prn #-4
+        sub r1 , XT1
+K20:    .data 6,-9,15
+S20:    .struct 8, "ab"
+T20:    .string "abcdef"
+; comment line
+.entry K20
+L210:    mov S21.1 ,K21
+        add r2,L210
+        jmp L230
+        mm
+        prn #-14
+        sub r1 , XT1
+K21:    .data 16,-9,15
+S21:    .struct 8, "ab"
+T21:    .string "abcdef"
+; comment line
+.entry K21
+L220:    mov S22.1 ,K22
+        add r2,L220
+        jmp L240
+        mm
+        prn #-24
+        sub r1 , XT1
+K22:    .data 26,-9,15
+S22:    .struct 8, "ab"
+T22:    .string "abcdef"
+; comment line
+.entry K22
+L230:    mov S23.1 ,K23
+        add r2,L230
+        jmp L250
+        mm
+        prn #-34
+        sub r1 , XT1
+K23:    .data 36,-9,15
+S23:    .struct 8, "ab"
+T23:    .string "abcdef"
+; comment line
+.entry K23
+L240:    mov S24.1 ,K24
+        add r2,L240
+        jmp L260
+        mm
+        prn #-44
+        sub r1 , XT1
+K24:    .data 46,-9,15
+S24:    .struct 8, "ab"
+T24:    .string "abcdef"
+; comment line
+.entry K24
+L250:    mov S25.1 ,K25
+        add r2,L250
+        jmp L270
+        mm
+        prn #-54
+        sub r1 , XT1
+K25:    .data 6,-9,15
+S25:    .struct 8, "ab"
+T25:    .string "abcdef"
+; comment line
+.entry K25
+L260:    mov S26.1 ,K26
+        add r2,L260
+        jmp L280
+        mm
+        prn #-64
+        sub r1 , XT1
+K26:    .data 16,-9,15
+S26:    .struct 8, "ab"
+T26:    .string "abcdef"
+; comment line
+.entry K26
+L270:    mov S27.1 ,K27
+        add r2,L270
+        jmp L290
+        mm
+        prn #-74
+        sub r1 , XT1
+K27:    .data 26,-9,15
+S27:    .struct 8, "ab"
+T27:    .string "abcdef"
+; comment line
+.entry K27
+L280:    mov S28.1 ,K28
+        add r2,L280
+        jmp L300
+        mm
+        prn #-84
+        sub r1 , XT1
+K28:    .data 36,-9,15
+S28:    .struct 8, "ab"
+T28:    .string "abcdef"
+; comment line
+.entry K28
+L290:    mov S29.1 ,K29
+        add r2,L290
+        jmp L310
+        mm
+        prn #-94
+        sub r1 , XT1
+K29:    .data 46,-9,15
+S29:    .struct 8, "ab"
+T29:    .string "abcdef"
+; comment line
+.entry K29
+L300:    mov S30.1 ,K30
+        add r2,L300
+        jmp L320
+        mm
+        prn #-4
+        sub r1 , XT1
+K30:    .data 6,-9,15
+S30:    .struct 8, "ab"
+T30:    .string "abcdef"
+; comment line
+.entry K30
+L310:    mov S31.1 ,K31
+        add r2,L310
+        jmp L330
+        mm
+        prn #-14
+        sub r1 , XT1
+K31:    .data 16,-9,15
+S31:    .struct 8, "ab"
+T31:    .string "abcdef"
+; comment line
+.entry K31
+L320:    mov S32.1 ,K32
+        add r2,L320
+        jmp L340
+        mm
+        prn #-24
+        sub r1 , XT1
+K32:    .data 26,-9,15
+S32:    .struct 8, "ab"
+T32:    .string "abcdef"
+; comment line
+.entry K32
+L330:    mov S33.1 ,K33
+        add r2,L330
+        jmp L350
+        mm
+        prn #-34
+        sub r1 , XT1
+K33:    .data 36,-9,15
+S33:    .struct 8, "ab"
+T33:    .string "abcdef"
+; comment line
+.entry K33
+L340:    mov S34.1 ,K34
+        add r2,L340
+        jmp L360
+        mm
+        prn #-44
+        sub r1 , XT1
+K34:    .data 46,-9,15
+S34:    .struct 8, "ab"
+T34:    .string "abcdef"
+; comment line
+.entry K34
+L350:    mov S35.1 ,K35
+        add r2,L350
+        jmp L370
+        mm
+        prn #-54
+        sub r1 , XT1
+K35:    .data 6,-9,15
+S35:    .struct 8, "ab"
+T35:    .string "abcdef"
+; comment line
+.entry K35
+L360:    mov S36.1 ,K36
+        add r2,L360
+        jmp L380
+        mm
+        prn #-64
+        sub r1 , XT1
+K36:    .data 16,-9,15
+S36:    .struct 8, "ab"
+T36:    .string "abcdef"
+; comment line
+.entry K36
+L370:    mov S37.1 ,K37
+        add r2,L370
+        jmp L390
+        mm
+        prn #-74
+        sub r1 , XT1
+K37:    .data 26,-9,15
+S37:    .struct 8, "ab"
+T37:    .string "abcdef"
+; comment line
+.entry K37
+L380:    mov S38.1 ,K38
+        add r2,L380
+        jmp L400
+        mm
+        prn #-84
+        sub r1 , XT1
+K38:    .data 36,-9,15
+S38:    .struct 8, "ab"
+T38:    .string "abcdef"
+; comment line
+.entry K38
+L390:    mov S39.1 ,K39
+        add r2,L390
+        jmp L410
+        mm
+        prn #-94
+        sub r1 , XT1
+K39:    .data 46,-9,15
+S39:    .struct 8, "ab"
+T39:    .string "abcdef"
+; comment line
+.entry K39
+L400:    mov S40.1 ,K40
+        add r2,L400
+        jmp L420
+        mm
+        prn #-4
+        sub r1 , XT1
+K40:    .data 6,-9,15
+S40:    .struct 8, "ab"
+T40:    .string "abcdef"
+; comment line
+.entry K40
+L410:    mov S41.1 ,K41
+        add r2,L410
+        jmp L430
+        mm
+        prn #-14
+        sub r1 , XT1
+K41:    .data 16,-9,15
+S41:    .struct 8, "ab"
+T41:    .string "abcdef"
+; comment line
+.entry K41
+L420:    mov S42.1 ,K42
+        add r2,L420
+        jmp L440
+        mm
+        prn #-24
+        sub r1 , XT1
+K42:    .data 26,-9,15
+S42:    .struct 8, "ab"
+T42:    .string "abcdef"
+; comment line
+.entry K42
+L430:    mov S43.1 ,K43
+        add r2,L430
+        jmp L450
+        mm
+        prn #-34
+        sub r1 , XT1
+K43:    .data 36,-9,15
+S43:    .struct 8, "ab"
+T43:    .string "abcdef"
+; comment line
+.entry K43
+L440:    mov S44.1 ,K44
+        add r2,L440
+        jmp L460
+        mm
+        prn #-44
+        sub r1 , XT1
+K44:    .data 46,-9,15
+S44:    .struct 8, "ab"
+T44:    .string "abcdef"
+; comment line
+.entry K44
+L450:    mov S45.1 ,K45
+        add r2,L450
+        jmp L470
+        mm
+        prn #-54
+        sub r1 , XT1
+K45:    .data 6,-9,15
+S45:    .struct 8, "ab"
+T45:    .string "abcdef"
+; comment line
+.entry K45
+L460:    mov S46.1 ,K46
+        add r2,L460
+        jmp L480
+        mm
+        prn #-64
+        sub r1 , XT1
+K46:    .data 16,-9,15
+S46:    .struct 8, "ab"
+T46:    .string "abcdef"
+; comment line
+.entry K46
+L470:    mov S47.1 ,K47
+        add r2,L470
+        jmp L490
+        mm
+        prn #-74
+        sub r1 , XT1
+K47:    .data 26,-9,15
+S47:    .struct 8, "ab"
+T47:    .string "abcdef"
+; comment line
+.entry K47
+L480:    mov S48.1 ,K48
+        add r2,L480
+        jmp L500
+        mm
+        prn #-84
+        sub r1 , XT1
+K48:    .data 36,-9,15
+S48:    .struct 8, "ab"
+T48:    .string "abcdef"
+; comment line
+.entry K48
+L490:    mov S49.1 ,K49
+        add r2,L490
+        jmp L510
+        mm
+        prn #-94
+        sub r1 , XT1
+K49:    .data 46,-9,15
+S49:    .struct 8, "ab"
+T49:    .string "abcdef"
+; comment line
+.entry K49
+L500:    mov S50.1 ,K50
+        add r2,L500
+        jmp L520
+        mm
+        prn #-4
+        sub r1 , XT1
+K50:    .data 6,-9,15
+S50:    .struct 8, "ab"
+T50:    .string "abcdef"
+; comment line
+.entry K50
+L510:    mov S51.1 ,K51
+        add r2,L510
+        jmp L530
+        mm
+        prn #-14
+        sub r1 , XT1
+K51:    .data 16,-9,15
+S51:    .struct 8, "ab"
+T51:    .string "abcdef"
+; comment line
+.entry K51
+L520:    mov S52.1 ,K52
+        add r2,L520
+        jmp L540
+        mm
+        prn #-24
+        sub r1 , XT1
+K52:    .data 26,-9,15
+S52:    .struct 8, "ab"
+T52:    .string "abcdef"
+; comment line
+.entry K52
+L530:    mov S53.1 ,K53
+        add r2,L530
+        jmp L550
+        mm
+        prn #-34
+        sub r1 , XT1
+K53:    .data 36,-9,15
+S53:    .struct 8, "ab"
+T53:    .string "abcdef"
+; comment line
+.entry K53
+L540:    mov S54.1 ,K54
+        add r2,L540
+        jmp L560
+        mm
+        prn #-44
+        sub r1 , XT1
+K54:    .data 46,-9,15
+S54:    .struct 8, "ab"
+T54:    .string "abcdef"
+; comment line
+.entry K54
+L550:    mov S55.1 ,K55
+        add r2,L550
+        jmp L570
+        mm
+        prn #-54
+        sub r1 , XT1
+K55:    .data 6,-9,15
+S55:    .struct 8, "ab"
+T55:    .string "abcdef"
+; comment line
+.entry K55
+L560:    mov S56.1 ,K56
+        add r2,L560
+        jmp L580
+        mm
+        prn #-64
+        sub r1 , XT1
+K56:    .data 16,-9,15
+S56:    .struct 8, "ab"
+T56:    .string "abcdef"
+; comment line
+.entry K56
+L570:    mov S57.1 ,K57
+        add r2,L570
+        jmp L590
+        mm
+        prn #-74
+        sub r1 , XT1
+K57:    .data 26,-9,15
+S57:    .struct 8, "ab"
+T57:    .string "abcdef"
+; comment line
+.entry K57
+L580:    mov S58.1 ,K58
+        add r2,L580
+        jmp L600
+        mm
+        prn #-84
+        sub r1 , XT1
+K58:    .data 36,-9,15
+S58:    .struct 8, "ab"
+T58:    .string "abcdef"
+; comment line
+.entry K58
+L590:    mov S59.1 ,K59
+        add r2,L590
+        jmp L610
+        mm
+        prn #-94
+        sub r1 , XT1
+K59:    .data 46,-9,15
+S59:    .struct 8, "ab"
+T59:    .string "abcdef"
+; comment line
+.entry K59
+L600:    mov S60.1 ,K60
+        add r2,L600
+        jmp L620
+        mm
+        prn #-4
+        sub r1 , XT1
+K60:    .data 6,-9,15
+S60:    .struct 8, "ab"
+T60:    .string "abcdef"
+; comment line
+.entry K60
+L610:    mov S61.1 ,K61
+        add r2,L610
+        jmp L630
+        mm
+        prn #-14
+        sub r1 , XT1
+K61:    .data 16,-9,15
+S61:    .struct 8, "ab"
+T61:    .string "abcdef"
+; comment line
+.entry K61
+L620:    mov S62.1 ,K62
+        add r2,L620
+        jmp L640
+        mm
+        prn #-24
+        sub r1 , XT1
+K62:    .data 26,-9,15
+S62:    .struct 8, "ab"
+T62:    .string "abcdef"
+; comment line
+.entry K62
+L630:    mov S63.1 ,K63
+        add r2,L630
+        jmp L650
+        mm
+        prn #-34
+        sub r1 , XT1
+K63:    .data 36,-9,15
+S63:    .struct 8, "ab"
+T63:    .string "abcdef"
+; comment line
+.entry K63
+L640:    mov S64.1 ,K64
+        add r2,L640
+        jmp L660
+        mm
+        prn #-44
+        sub r1 , XT1
+K64:    .data 46,-9,15
+S64:    .struct 8, "ab"
+T64:    .string "abcdef"
+; comment line
+.entry K64
+L650:    mov S65.1 ,K65
+        add r2,L650
+        jmp L670
+        mm
+        prn #-54
+        sub r1 , XT1
+K65:    .data 6,-9,15
+S65:    .struct 8, "ab"
+T65:    .string "abcdef"
+; comment line
+.entry K65
+L660:    mov S66.1 ,K66
+        add r2,L660
+        jmp L680
+        mm
+        prn #-64
+        sub r1 , XT1
+K66:    .data 16,-9,15
+S66:    .struct 8, "ab"
+T66:    .string "abcdef"
+; comment line
+.entry K66
+L670:    mov S67.1 ,K67
+        add r2,L670
+        jmp L690
+        mm
+        prn #-74
+        sub r1 , XT1
+K67:    .data 26,-9,15
+S67:    .struct 8, "ab"
+T67:    .string "abcdef"
+; comment line
+.entry K67
+L680:    mov S68.1 ,K68
+        add r2,L680
+        jmp L700
+        mm
+        prn #-84
+        sub r1 , XT1
+K68:    .data 36,-9,15
+S68:    .struct 8, "ab"
+T68:    .string "abcdef"
+; comment line
+.entry K68
+L690:    mov S69.1 ,K69
+        add r2,L690
+        jmp L710
+        mm
+        prn #-94
+        sub r1 , XT1
+K69:    .data 46,-9,15
+S69:    .struct 8, "ab"
+T69:    .string "abcdef"
+; comment line
+.entry K69
+L700:    mov S70.1 ,K70
+        add r2,L700
+        jmp L720
+        mm
+        prn #-4
+        sub r1 , XT1
+K70:    .data 6,-9,15
+S70:    .struct 8, "ab"
+T70:    .string "abcdef"
+; comment line
+.entry K70
+L710:    mov S71.1 ,K71
+        add r2,L710
+        jmp L730
+        mm
+        prn #-14
+        sub r1 , XT1
+K71:    .data 16,-9,15
+S71:    .struct 8, "ab"
+T71:    .string "abcdef"
+; comment line
+.entry K71
+L720:    mov S72.1 ,K72
+        add r2,L720
+        jmp L740
+        mm
+        prn #-24
+        sub r1 , XT1
+K72:    .data 26,-9,15
+S72:    .struct 8, "ab"
+T72:    .string "abcdef"
+; comment line
+.entry K72
+L730:    mov S73.1 ,K73
+        add r2,L730
+        jmp L750
+        mm
+        prn #-34
+        sub r1 , XT1
+K73:    .data 36,-9,15
+S73:    .struct 8, "ab"
+T73:    .string "abcdef"
+; comment line
+.entry K73
+L740:    mov S74.1 ,K74
+        add r2,L740
+        jmp L760
+        mm
+        prn #-44
+        sub r1 , XT1
+K74:    .data 46,-9,15
+S74:    .struct 8, "ab"
+T74:    .string "abcdef"
+; comment line
+.entry K74
+L750:    mov S75.1 ,K75
+        add r2,L750
+        jmp L770
+        mm
+        prn #-54
+        sub r1 , XT1
+K75:    .data 6,-9,15
+S75:    .struct 8, "ab"
+T75:    .string "abcdef"
+; comment line
+.entry K75
+L760:    mov S76.1 ,K76
+        add r2,L760
+        jmp L780
+        mm
+        prn #-64
+        sub r1 , XT1
+K76:    .data 16,-9,15
+S76:    .struct 8, "ab"
+T76:    .string "abcdef"
+; comment line
+.entry K76
+L770:    mov S77.1 ,K77
+        add r2,L770
+        jmp L790
+        mm
+        prn #-74
+        sub r1 , XT1
+K77:    .data 26,-9,15
+S77:    .struct 8, "ab"
+T77:    .string "abcdef"
+; comment line
+.entry K77
+L780:    mov S78.1 ,K78
+        add r2,L780
+        jmp L800
+        mm
+        prn #-84
+        sub r1 , XT1
+K78:    .data 36,-9,15
+S78:    .struct 8, "ab"
+T78:    .string "abcdef"
+; comment line
+.entry K78
+L790:    mov S79.1 ,K79
+        add r2,L790
+        jmp L810
+        mm
+        prn #-94
+        sub r1 , XT1
+K79:    .data 46,-9,15
+S79:    .struct 8, "ab"
+T79:    .string "abcdef"
+; comment line
+.entry K79
+L800:    mov S80.1 ,K80
+        add r2,L800
+        jmp L820
+        mm
+        prn #-4
+        sub r1 , XT1
+K80:    .data 6,-9,15
+S80:    .struct 8, "ab"
+T80:    .string "abcdef"
+; comment line
+.entry K80
+L810:    mov S81.1 ,K81
+        add r2,L810
+        jmp L830
+        mm
+        prn #-14
+        sub r1 , XT1
+K81:    .data 16,-9,15
+S81:    .struct 8, "ab"
+T81:    .string "abcdef"
+; comment line
+.entry K81
+L820:    mov S82.1 ,K82
+        add r2,L820
+        jmp L840
+        mm
+        prn #-24
+        sub r1 , XT1
+K82:    .data 26,-9,15
+S82:    .struct 8, "ab"
+T82:    .string "abcdef"
+; comment line
+.entry K82
+L830:    mov S83.1 ,K83
+        add r2,L830
+        jmp L850
+        mm
+        prn #-34
+        sub r1 , XT1
+K83:    .data 36,-9,15
+S83:    .struct 8, "ab"
+T83:    .string "abcdef"
+; comment line
+.entry K83
+L840:    mov S84.1 ,K84
+        add r2,L840
+        jmp L860
+        mm
+        prn #-44
+        sub r1 , XT1
+K84:    .data 46,-9,15
+S84:    .struct 8, "ab"
+T84:    .string "abcdef"
+; comment line
+.entry K84
+L850:    mov S85.1 ,K85
+        add r2,L850
+        jmp L870
+        mm
+        prn #-54
+        sub r1 , XT1
+K85:    .data 6,-9,15
+S85:    .struct 8, "ab"
+T85:    .string "abcdef"
+; comment line
+.entry K85
+L860:    mov S86.1 ,K86
+        add r2,L860
+        jmp L880
+        mm
+        prn #-64
+        sub r1 , XT1
+K86:    .data 16,-9,15
+S86:    .struct 8, "ab"
+T86:    .string "abcdef"
+; comment line
+.entry K86
+L870:    mov S87.1 ,K87
+        add r2,L870
+        jmp L890
+        mm
+        prn #-74
+        sub r1 , XT1
+K87:    .data 26,-9,15
+S87:    .struct 8, "ab"
+T87:    .string "abcdef"
+; comment line
+.entry K87
+L880:    mov S88.1 ,K88
+        add r2,L880
+        jmp L900
+        mm
+        prn #-84
+        sub r1 , XT1
+K88:    .data 36,-9,15
+S88:    .struct 8, "ab"
+T88:    .string "abcdef"
+; comment line
+.entry K88
+L890:    mov S89.1 ,K89
+        add r2,L890
+        jmp L910
+        mm
+        prn #-94
+        sub r1 , XT1
+K89:    .data 46,-9,15
+S89:    .struct 8, "ab"
+T89:    .string "abcdef"
+; comment line
+.entry K89
+L900:    mov S90.1 ,K90
+        add r2,L900
+        jmp L920
+        mm
+        prn #-4
+        sub r1 , XT1
+K90:    .data 6,-9,15
+S90:    .struct 8, "ab"
+T90:    .string "abcdef"
+; comment line
+.entry K90
+L910:    mov S91.1 ,K91
+        add r2,L910
+        jmp L930
+        mm
+        prn #-14
+        sub r1 , XT1
+K91:    .data 16,-9,15
+S91:    .struct 8, "ab"
+T91:    .string "abcdef"
+; comment line
+.entry K91
+L920:    mov S92.1 ,K92
+        add r2,L920
+        jmp L940
+        mm
+        prn #-24
+        sub r1 , XT1
+K92:    .data 26,-9,15
+S92:    .struct 8, "ab"
+T92:    .string "abcdef"
+; comment line
+.entry K92
+L930:    mov S93.1 ,K93
+        add r2,L930
+        jmp L950
+        mm
+        prn #-34
+        sub r1 , XT1
+K93:    .data 36,-9,15
+S93:    .struct 8, "ab"
+T93:    .string "abcdef"
+; comment line
+.entry K93
+L940:    mov S94.1 ,K94
+        add r2,L940
+        jmp L960
+        mm
+        prn #-44
+        sub r1 , XT1
+K94:    .data 46,-9,15
+S94:    .struct 8, "ab"
+T94:    .string "abcdef"
+; comment line
+.entry K94
+L950:    mov S95.1 ,K95
+        add r2,L950
+        jmp L970
+        mm
+        prn #-54
+        sub r1 , XT1
+K95:    .data 6,-9,15
+S95:    .struct 8, "ab"
+T95:    .string "abcdef"
+; comment line
+.entry K95
+L960:    mov S96.1 ,K96
+        add r2,L960
+        jmp L980
+        mm
+        prn #-64
+        sub r1 , XT1
+K96:    .data 16,-9,15
+S96:    .struct 8, "ab"
+T96:    .string "abcdef"
+; comment line
+.entry K96
+L970:    mov S97.1 ,K97
+        add r2,L970
+        jmp L990
+        mm
+        prn #-74
+        sub r1 , XT1
+K97:    .data 26,-9,15
+S97:    .struct 8, "ab"
+T97:    .string "abcdef"
+; comment line
+.entry K97
+L980:    mov S98.1 ,K98
+        add r2,L980
+        jmp L990
+        mm
+        prn #-84
+        sub r1 , XT1
+K98:    .data 36,-9,15
+S98:    .struct 8, "ab"
+T98:    .string "abcdef"
+; comment line
+.entry K98
+L990:    mov S99.1 ,K99
+        add r2,L990
+        jmp L990
+        mm
+        prn #-94
+        sub r1 , XT1
+K99:    .data 46,-9,15
+S99:    .struct 8, "ab"
+T99:    .string "abcdef"
+; comment line
+.entry K99
+        hlt
@@ -0,0 +1,52 @@
+LBL: .data 1
+S: .struct 1, "a"
+mov #5, LBL
+mov #5, r3
+mov LBL, LBL
+mov LBL, r3
+mov r3, LBL
+mov r3, r3
+cmp #5, #5
+cmp #5, LBL
+cmp #5, r3
+cmp LBL, #5
+cmp LBL, LBL
+cmp LBL, r3
+cmp r3, #5
+cmp r3, LBL
+cmp r3, r3
+add #5, LBL
+add #5, r3
+add LBL, LBL
+add LBL, r3
+add r3, LBL
+add r3, r3
+sub #5, LBL
+sub #5, r3
+sub LBL, LBL
+sub LBL, r3
+sub r3, LBL
+sub r3, r3
+not LBL
+not r3
+clr LBL
+clr r3
+lea LBL, LBL
+lea LBL, r3
+inc LBL
+inc r3
+dec LBL
+dec r3
+jmp LBL
+jmp r3
+bne LBL
+bne r3
+get LBL
+get r3
+prn #5
+prn LBL
+prn r3
+jsr LBL
+jsr r3
+rts
+hlt
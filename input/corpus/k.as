@@ -0,0 +1,14 @@
+data: .data 1
+r3: .data 1
+macro: .data 1
+mov: .data 2
+r8: .data 3
+endmacro: .data 3
+string: .data 1
+R1: .data 1
+x: mov r1, r8
+hlt
+rts 1
+lea r1, r2
+prn #1
+.strin "a"
@@ -0,0 +1,17 @@
+; file with macros
+.entry LATER
+.entry MISSING
+macro m1
+ inc r1
+ bad line here
+ mov r1, r2
+endmacro
+.extern EXT
+.entry EXT
+MAIN: mov r1, r2
+
+ m1
+; between
+ m1
+LATER: .data 5
+ jmp UNDEF
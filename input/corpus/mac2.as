@@ -0,0 +1,13 @@
+.entry LATER
+.entry MISSING
+macro m1
+ inc r1
+ mov r1, r2
+endmacro
+.extern EXT
+.entry EXT
+MAIN: mov r1, r2
+ m1
+ m1
+LATER: .data 5
+ jmp UNDEF
@@ -0,0 +1,11 @@
+.entry LATER
+macro m1
+ inc r1
+ mov r1, LATER
+endmacro
+.extern EXT
+MAIN: mov r1, r2
+ m1
+ m1
+ jmp EXT
+LATER: .data 5
@@ -0,0 +1,4 @@
+macro
+    inc r1
+endmacro
+MAIN: hlt
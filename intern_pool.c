@@ -0,0 +1,194 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern_pool.h"
+#include "errors.h"
+
+#define INTERN_POOL_INITIAL_CAPACITY 64
+#define INTERN_POOL_EMPTY_SLOT -1
+
+
+/* The identifiers of a file - labels, macro names and the symbols operands refer to. Each distinct identifier is
+ * stored once and numbered by the order it was first seen, so the tables keyed by identifiers are arrays indexed by
+ * the ID, and comparing identifiers is comparing IDs. */
+typedef struct {
+    const char *s;
+    size_t len;
+    unsigned hash;
+} InternedString;
+
+struct intern_pool_t {
+    Arena arena; // the strings are allocated from it
+
+    InternedString *strings; // indexed by the ID
+    int size;
+    int strings_capacity;
+
+    int *slots; // an open-addressing hash table of the IDs, keyed by the string
+    int slots_capacity; // always a power of 2
+};
+
+/**
+ * It computes the FNV-1a hash of a string.
+ *
+ * @param s The string to hash, doesn't have to be null-terminated.
+ * @param len The length of the string.
+ */
+static unsigned internPoolHash(const char *s, size_t len) {
+    unsigned hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (unsigned char) s[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * It allocates the slots of the hash table, all of them empty.
+ *
+ * @param capacity The number of slots.
+ */
+static int *internPoolCreateSlots(int capacity) {
+    int *slots = malloc(sizeof(*slots) * capacity);
+    if (!slots)
+        memoryAllocationError();
+
+    for (int i = 0; i < capacity; ++i) {
+        slots[i] = INTERN_POOL_EMPTY_SLOT;
+    }
+    return slots;
+}
+
+/**
+ * It creates an empty intern pool.
+ *
+ * @param arena The arena to allocate the strings from.
+ */
+InternPool internPoolCreate(Arena arena) {
+    InternPool pool = malloc(sizeof(*pool));
+    if (!pool)
+        memoryAllocationError();
+
+    pool->arena = arena;
+    pool->size = 0;
+    pool->strings_capacity = INTERN_POOL_INITIAL_CAPACITY;
+    pool->strings = malloc(sizeof(*pool->strings) * pool->strings_capacity);
+    if (!pool->strings)
+        memoryAllocationError();
+
+    pool->slots_capacity = 2 * INTERN_POOL_INITIAL_CAPACITY;
+    pool->slots = internPoolCreateSlots(pool->slots_capacity);
+    return pool;
+}
+
+/**
+ * It destroys the intern pool. The strings live in the arena they were allocated from.
+ *
+ * @param pool The intern pool to destroy.
+ */
+void internPoolDestroy(InternPool pool) {
+    if (!pool)
+        return;
+
+    free(pool->strings);
+    free(pool->slots);
+    free(pool);
+}
+
+/**
+ * It returns the slot of the string, or the empty slot where it should be inserted.
+ *
+ * @param pool The intern pool to search.
+ * @param s The string, doesn't have to be null-terminated.
+ * @param len The length of the string.
+ * @param hash The hash of the string.
+ */
+static int internPoolFindSlot(InternPool pool, const char *s, size_t len, unsigned hash) {
+    int mask = pool->slots_capacity - 1;
+    int slot = (int) (hash & mask);
+    while (pool->slots[slot] != INTERN_POOL_EMPTY_SLOT) {
+        const InternedString *str = &pool->strings[pool->slots[slot]];
+        if (str->hash == hash && str->len == len && memcmp(str->s, s, len) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * It doubles the number of slots and rehashes the IDs, using their precomputed hashes.
+ *
+ * @param pool The intern pool to grow.
+ */
+static void internPoolGrowSlots(InternPool pool) {
+    free(pool->slots);
+    pool->slots_capacity *= 2;
+    pool->slots = internPoolCreateSlots(pool->slots_capacity);
+
+    int mask = pool->slots_capacity - 1;
+    for (int id = 0; id < pool->size; ++id) {
+        int slot = (int) (pool->strings[id].hash & mask);
+        while (pool->slots[slot] != INTERN_POOL_EMPTY_SLOT) {
+            slot = (slot + 1) & mask;
+        }
+        pool->slots[slot] = id;
+    }
+}
+
+/**
+ * It returns the ID of a string, adding the string to the pool if it isn't there yet.
+ *
+ * @param pool The intern pool.
+ * @param s The string, doesn't have to be null-terminated.
+ * @param len The length of the string.
+ */
+int internPoolIntern(InternPool pool, const char *s, size_t len) {
+    unsigned hash = internPoolHash(s, len);
+    int slot = internPoolFindSlot(pool, s, len, hash);
+    if (pool->slots[slot] != INTERN_POOL_EMPTY_SLOT)
+        return pool->slots[slot];
+
+    if (pool->size == pool->strings_capacity) {
+        pool->strings_capacity *= 2;
+        pool->strings = realloc(pool->strings, sizeof(*pool->strings) * pool->strings_capacity);
+        if (!pool->strings)
+            memoryAllocationError();
+    }
+    int id = pool->size++;
+    pool->strings[id].s = arenaStrndup(pool->arena, s, len);
+    pool->strings[id].len = len;
+    pool->strings[id].hash = hash;
+    pool->slots[slot] = id;
+
+    /* Keeping the load factor at most 1/2, so the probe sequences stay short. */
+    if (2 * pool->size > pool->slots_capacity) {
+        internPoolGrowSlots(pool);
+    }
+    return id;
+}
+
+/**
+ * It returns the ID of a string, without adding it to the pool.
+ *
+ * @param pool The intern pool.
+ * @param s The string, doesn't have to be null-terminated.
+ * @param len The length of the string.
+ *
+ * @return The ID, or INTERN_POOL_NOT_FOUND if the string was never interned - so no table keyed by IDs has it.
+ */
+int internPoolFind(InternPool pool, const char *s, size_t len) {
+    int id = pool->slots[internPoolFindSlot(pool, s, len, internPoolHash(s, len))];
+    return id == INTERN_POOL_EMPTY_SLOT ? INTERN_POOL_NOT_FOUND : id;
+}
+
+/**
+ * It returns the string of an ID.
+ *
+ * @param pool The intern pool.
+ * @param id The ID of the string.
+ */
+const char *internPoolGetString(InternPool pool, int id) {
+    return pool->strings[id].s;
+}
+
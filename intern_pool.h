@@ -0,0 +1,21 @@
+#ifndef ASSEMBLER_INTERN_POOL_H
+#define ASSEMBLER_INTERN_POOL_H
+
+#include <stddef.h>
+#include "arena.h"
+
+#define INTERN_POOL_NOT_FOUND -1
+
+typedef struct intern_pool_t *InternPool;
+
+InternPool internPoolCreate(Arena arena);
+
+void internPoolDestroy(InternPool pool);
+
+int internPoolIntern(InternPool pool, const char *s, size_t len);
+
+int internPoolFind(InternPool pool, const char *s, size_t len);
+
+const char *internPoolGetString(InternPool pool, int id);
+
+#endif //ASSEMBLER_INTERN_POOL_H
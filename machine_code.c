@@ -2,347 +2,261 @@
 // Created by misha on 17/08/2022.
 //
 
-#include <malloc.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
 #include "machine_code.h"
-#include "linkedlist.h"
 #include "parser.h"
-#include "errors.h"
 #include "const_tables.h"
 #include "str_utils.h"
 #include "symtab.h"
 #include "base_conversion.h"
+#include "errors.h"
 
-#define MAX_OPERANDS_COUNT 2
+#define MAX_WORDS_COUNT (1 + 2 * MAX_OPERANDS_COUNT) // opcode word, and two words for each struct operand
 
 #define OPCODE_NUM_BITS 4
 #define ADDRESSING_NUM_BITS 2
 #define CODING_METHOD_NUM_BITS 2
 
 #define REGISTER_NUM_BITS 4
+#define VALUE_NUM_BITS (BINARY_WORD_SIZE - CODING_METHOD_NUM_BITS)
 
+/* The fields of a word, from the least significant bit: the coding method (A, E, R) and then either the destination
+ * and source addressing modes and the opcode, the destination and source registers, or a value. */
+#define CODING_METHOD_SHIFT 0
+#define DST_ADDRESSING_SHIFT CODING_METHOD_NUM_BITS
+#define SRC_ADDRESSING_SHIFT (DST_ADDRESSING_SHIFT + ADDRESSING_NUM_BITS)
+#define OPCODE_SHIFT (SRC_ADDRESSING_SHIFT + ADDRESSING_NUM_BITS)
+#define DST_REGISTER_SHIFT CODING_METHOD_NUM_BITS
+#define SRC_REGISTER_SHIFT (DST_REGISTER_SHIFT + REGISTER_NUM_BITS)
+#define VALUE_SHIFT CODING_METHOD_NUM_BITS
 
-struct machine_code_t {
-    int line_num;
-    int address; // 0-255
-
-    int opcode; // 0-15
-    int coding_method;  // A, E, R
-
-    // first dest then src
-    AddressingMode addressing_modes[MAX_OPERANDS_COUNT];
-
-    int values[MAX_OPERANDS_COUNT]; // 0-255
-
-    int registers[MAX_OPERANDS_COUNT]; // 0-15
+#define STRUCT_FIELD_DELIM '.'
 
-    int label_addresses[MAX_OPERANDS_COUNT]; // 0-255
+#define INITIAL_CAPACITY 64 // words
 
-    const char *labels[MAX_OPERANDS_COUNT];
-
-    int struct_addresses[MAX_OPERANDS_COUNT]; // 0-255
-    int struct_field_nums[MAX_OPERANDS_COUNT]; // 1/2
-
-    const char *struct_names[MAX_OPERANDS_COUNT];
-
-    bool is_extern[MAX_OPERANDS_COUNT];
-    int extern_words_index[MAX_OPERANDS_COUNT]; // 0-(size-1)
-
-    int num_operands; // 0/1/2
-    const char *operands[MAX_OPERANDS_COUNT];
 
+/* The machine code of a file - the words of its instructions, one after another from address 0, so the code is one
+ * array which is scanned linearly when it is written out. An instruction doesn't need a record of its own once it's
+ * encoded: the words holding the addresses of symbols are patched through their addresses. */
+struct machine_code_t {
+    unsigned short *words; // packed BINARY_WORD_SIZE-bit words
     size_t size;
-    char **words;
+    size_t capacity;
 };
 
 
-MachineCode machineCodeCreate(Statement s, int ic) {
-    MachineCode mc = malloc(sizeof(*mc));
-    if (!mc) {
-        memoryAllocationError();
-    }
-
-    mc->line_num = statementGetLineNum(s);
-    mc->address = ic;
-    mc->opcode = getInstructionCode(statementGetMnemonic(s));
-    mc->size = 1; // opcode word
-
-    /* It's initializing the fields of the struct. */
-    for (int i = 0; i < MAX_OPERANDS_COUNT; ++i) {
-        mc->addressing_modes[i] = EMPTY_ADDRESSING;
-        mc->values[i] = 0;
-        mc->registers[i] = 0;
-        mc->label_addresses[i] = 0;
-        mc->struct_addresses[i] = 0;
-        mc->struct_field_nums[i] = 0;
-        mc->struct_names[i] = NULL;
-        mc->labels[i] = NULL;
-    }
-    mc->words = NULL;
-
-    List instruction_operands = statementGetOperands(s);
-    int num_operands = listLength(instruction_operands);
-    assert(num_operands == getInstructionNumberOfOperands(statementGetMnemonic(s)));
-
-    mc->num_operands = num_operands;
-
-    for (int i = 0; i < num_operands; ++i) {
-        mc->size++; // operand value/address word
-
-        const char *operand = listGetDataAt(instruction_operands, i);
-        mc->operands[i] = strdup(operand);
-
-        AddressingMode addressing_mode = getAddressingMode(operand);
-        mc->addressing_modes[i] = addressing_mode;
-
-        if (addressing_mode == IMMEDIATE_ADDRESSING) {
-            mc->values[i] = atoi(operand + 1); // +1 to skip the '#'
-        } else if (addressing_mode == REGISTER_ADDRESSING) {
-            mc->registers[i] = atoi(operand + 1); // +1 to skip the 'r'
-        } else if (addressing_mode == DIRECT_ADDRESSING) {
-            mc->labels[i] = strdup(operand);
-        } else if (addressing_mode == STRUCT_ADDRESSING) {
-            List split_operand = strSplit(operand, ".");
-            const char *before_delim = listGetDataAt(split_operand, 0);
-            const char *after_delim = listGetDataAt(split_operand, 1);
-
-            mc->struct_names[i] = strdup(before_delim);
-            mc->size++; // struct field num word
-
-            mc->struct_field_nums[i] = atoi(after_delim);
-        }
-        mc->is_extern[i] = false;
-        mc->extern_words_index[i] = 0;
-    }
-
-    if (mc->addressing_modes[0] == mc->addressing_modes[1] && mc->addressing_modes[0] == REGISTER_ADDRESSING) {
-        mc->size--; // remove the second operand word
-    }
+/**
+ * It places a value in a field of a word, keeping only the field's num_bits least significant bits of the value.
+ *
+ * @param value The value of the field.
+ * @param num_bits The width of the field.
+ * @param shift The position of the field's least significant bit in the word.
+ */
+static unsigned short wordField(int value, int num_bits, int shift) {
+    return ((unsigned) value & ((1u << num_bits) - 1)) << shift;
+}
 
-    return mc;
+/**
+ * It encodes a word holding a value, e.g. an immediate number or an address, and its coding method.
+ *
+ * @param value The value.
+ * @param coding_method The coding method of the word (A, E or R).
+ */
+static unsigned short valueWord(int value, int coding_method) {
+    return wordField(value, VALUE_NUM_BITS, VALUE_SHIFT) |
+           wordField(coding_method, CODING_METHOD_NUM_BITS, CODING_METHOD_SHIFT);
 }
 
-int machineCodeCmp(MachineCode mc1, MachineCode mc2) {
-    return mc1->address - mc2->address;
+/**
+ * It encodes a word holding a source and a destination register.
+ *
+ * @param src_register The source register number.
+ * @param dst_register The destination register number.
+ */
+static unsigned short registersWord(int src_register, int dst_register) {
+    return wordField(src_register, REGISTER_NUM_BITS, SRC_REGISTER_SHIFT) |
+           wordField(dst_register, REGISTER_NUM_BITS, DST_REGISTER_SHIFT) |
+           wordField(A, CODING_METHOD_NUM_BITS, CODING_METHOD_SHIFT);
 }
 
-MachineCode machineCodeCopy(MachineCode mc) {
-    MachineCode copy = malloc(sizeof(*copy));
-    if (!copy) {
+/**
+ * It creates an empty machine code.
+ */
+MachineCode machineCodeCreate(void) {
+    MachineCode mc = malloc(sizeof(*mc));
+    if (!mc)
         memoryAllocationError();
-    }
-    copy->line_num = mc->line_num;
-    copy->address = mc->address;
-    copy->opcode = mc->opcode;
-    copy->coding_method = mc->coding_method;
-    copy->num_operands = mc->num_operands;
-    copy->size = mc->size;
-
-    if (mc->words) {
-        copy->words = malloc(sizeof(char *) * mc->size);
-        if (!copy->words) {
-            memoryAllocationError();
-        }
-        for (int i = 0; i < mc->size; ++i) {
-            copy->words[i] = strdup(mc->words[i]);
-        }
-    } else {
-        copy->words = NULL;
-    }
 
-    for (int i = 0; i < copy->num_operands; ++i) {
-        copy->addressing_modes[i] = mc->addressing_modes[i];
-        copy->values[i] = mc->values[i];
-        copy->registers[i] = mc->registers[i];
-        copy->label_addresses[i] = mc->label_addresses[i];
-        copy->struct_addresses[i] = mc->struct_addresses[i];
-        copy->struct_field_nums[i] = mc->struct_field_nums[i];
-        copy->struct_names[i] = strdup(mc->struct_names[i]);
-        copy->labels[i] = strdup(mc->labels[i]);
-        copy->is_extern[i] = mc->is_extern[i];
-        copy->extern_words_index[i] = mc->extern_words_index[i];
-        copy->operands[i] = strdup(mc->operands[i]);
-    }
-    return copy;
+    mc->size = 0;
+    mc->capacity = INITIAL_CAPACITY;
+    mc->words = malloc(mc->capacity * sizeof(*mc->words));
+    if (!mc->words)
+        memoryAllocationError();
+    return mc;
 }
 
+/**
+ * It destroys the machine code.
+ *
+ * @param mc The machine code to destroy.
+ */
 void machineCodeDestroy(MachineCode mc) {
-    if (mc->words) {
-        for (int i = 0; i < mc->size; ++i) {
-            free(mc->words[i]);
-        }
-        free(mc->words);
-    }
-    for (int i = 0; i < mc->num_operands; ++i) {
-        free((void *) mc->labels[i]);
-        free((void *) mc->struct_names[i]);
-        free((void *) mc->operands[i]);
-    }
-    free(mc);
-}
-
-size_t machineCodeGetSize(MachineCode mc) {
-    return mc->size;
-}
-
-static bool
-updateAndCheckSymbolAddresses(MachineCode mc, List symtab, const char *filename, const char *filename_suffix,
-                              int start_address) {
-    bool success = true;
-    for (int i = 0; i < mc->num_operands; ++i) {
-        if (mc->addressing_modes[i] == DIRECT_ADDRESSING) {
-            SymtabEntry found_entry = symbolTableFindByName(symtab, mc->labels[i]);
-            if (!found_entry) {
-                success = false;
-                printf("Undefined symbol %s on line %d in file %s%s\n", mc->labels[i], mc->line_num, filename,
-                       filename_suffix);
-            }
-            mc->label_addresses[i] = symtabEntryGetValue(found_entry) + start_address;
-            mc->is_extern[i] = symtabEntryGetType(found_entry) == SYMBOL_EXTERN;
+    if (!mc)
+        return;
 
-        } else if (mc->addressing_modes[i] == STRUCT_ADDRESSING) {
-            SymtabEntry found_entry = symbolTableFindByName(symtab, mc->struct_names[i]);
-            if (!found_entry) {
-                success = false;
-                printf("Undefined symbol %s on line %d in file %s%s\n", mc->labels[i], mc->line_num, filename,
-                       filename_suffix);
-            }
-            mc->struct_addresses[i] = symtabEntryGetValue(found_entry) + start_address;
-            mc->is_extern[i] = symtabEntryGetType(found_entry) == SYMBOL_EXTERN;
-        }
-    }
-    return success;
+    free(mc->words);
+    free(mc);
 }
 
 /**
- * It converts the machine code to base 32 words.
+ * It encodes an instruction statement and appends its words to the machine code. The words holding the addresses of
+ * the symbols the instruction refers to are left as relocatable zeros, until they are resolved by
+ * machineCodeResolveSymbol.
  *
- * @param mc a list of machine code instructions
- * @param symtab a list of symbols (strings)
+ * @param mc The machine code.
+ * @param names The intern pool to intern the symbols the operands refer to in.
+ * @param s The instruction statement.
+ * @param symbol_operands Set to the operands of the instruction that refer to symbols.
  *
- * @return true if successful, false otherwise
+ * @return The number of operands that refer to symbols.
  */
-bool machineCodeUpdateFromSymtab(MachineCode mc, List symtab, const char *filename_suffix, const char *filename,
-                                 int start_address_offset) {
-    if (!updateAndCheckSymbolAddresses(mc, symtab, filename, filename_suffix, start_address_offset)) {
-        return false;
-    }
+int machineCodeAppendInstruction(MachineCode mc, InternPool names, Statement s, SymbolOperand *symbol_operands) {
+    const Instruction *instruction = getInstruction(statementGetMnemonic(s));
+    int num_operands = statementGetOperandsCount(s);
+    assert(num_operands == instruction->num_operands);
 
-    char **words = malloc(sizeof(*words) * mc->size);
-    if (!words) {
-        memoryAllocationError();
+    AddressingMode addressing_modes[MAX_OPERANDS_COUNT] = {EMPTY_ADDRESSING, EMPTY_ADDRESSING};
+    for (int i = 0; i < num_operands; ++i) {
+        addressing_modes[i] = getAddressingMode(statementGetOperandAt(s, i));
     }
-    for (int i = 0; i < mc->size; ++i) {
-        words[i] = malloc(sizeof(char) * (BASE32_WORD_SIZE + 1));
-        if (!words[i]) {
+
+    if (mc->size + MAX_WORDS_COUNT > mc->capacity) {
+        mc->capacity *= 2;
+        mc->words = realloc(mc->words, mc->capacity * sizeof(*mc->words));
+        if (!mc->words)
             memoryAllocationError();
-        }
     }
-    mc->words = words;
-
-    char binary_buf[BINARY_WORD_SIZE + 1];
+    int address = (int) mc->size;
+    unsigned short *words = mc->words + address;
+    int num_words = 0, num_symbol_operands = 0;
 
     // opcode word
-    decimalToBinary(mc->opcode, binary_buf, OPCODE_NUM_BITS);
-    if (mc->num_operands == 0) {
-        decimalToBinary(0, binary_buf + OPCODE_NUM_BITS, ADDRESSING_NUM_BITS);
-        decimalToBinary(0, binary_buf + OPCODE_NUM_BITS + ADDRESSING_NUM_BITS, ADDRESSING_NUM_BITS);
-    } else if (mc->num_operands == 1) {
-        decimalToBinary(0, binary_buf + OPCODE_NUM_BITS, ADDRESSING_NUM_BITS);
-        decimalToBinary(mc->addressing_modes[0], binary_buf + OPCODE_NUM_BITS + ADDRESSING_NUM_BITS,
-                        ADDRESSING_NUM_BITS);
-    } else {
-        decimalToBinary(mc->addressing_modes[0], binary_buf + OPCODE_NUM_BITS,
-                        ADDRESSING_NUM_BITS);
-        decimalToBinary(mc->addressing_modes[1], binary_buf + OPCODE_NUM_BITS + ADDRESSING_NUM_BITS,
-                        ADDRESSING_NUM_BITS);
+    int src_addressing = 0, dst_addressing = 0;
+    if (num_operands == 1) {
+        dst_addressing = addressing_modes[0];
+    } else if (num_operands == 2) {
+        src_addressing = addressing_modes[0];
+        dst_addressing = addressing_modes[1];
     }
-    decimalToBinary(A, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-    binaryToBase32Word(binary_buf, words[0]);
+    words[num_words++] = wordField(instruction->opcode, OPCODE_NUM_BITS, OPCODE_SHIFT) |
+                         wordField(src_addressing, ADDRESSING_NUM_BITS, SRC_ADDRESSING_SHIFT) |
+                         wordField(dst_addressing, ADDRESSING_NUM_BITS, DST_ADDRESSING_SHIFT) |
+                         wordField(A, CODING_METHOD_NUM_BITS, CODING_METHOD_SHIFT);
 
     // operand value/address word(s)
-    if (mc->addressing_modes[0] == REGISTER_ADDRESSING && mc->addressing_modes[1] == REGISTER_ADDRESSING) {
-        assert(mc->size == 2);
-        decimalToBinary(mc->registers[0], binary_buf, REGISTER_NUM_BITS);
-        decimalToBinary(mc->registers[1], binary_buf + REGISTER_NUM_BITS, REGISTER_NUM_BITS);
-        decimalToBinary(A, binary_buf + 2 * REGISTER_NUM_BITS, CODING_METHOD_NUM_BITS);
-        binaryToBase32Word(binary_buf, words[1]);
-        return true;
+    if (addressing_modes[0] == REGISTER_ADDRESSING && addressing_modes[1] == REGISTER_ADDRESSING) {
+        // +1 to skip the 'r'
+        words[num_words++] = registersWord(atoi(statementGetOperandAt(s, 0) + 1),
+                                           atoi(statementGetOperandAt(s, 1) + 1));
+        mc->size += num_words;
+        return num_symbol_operands;
     }
 
-    int operand_word_index = 1;
-    for (int i = 0; i < mc->num_operands; ++i) {
-        if (mc->addressing_modes[i] == IMMEDIATE_ADDRESSING) {
-            decimalToBinary(mc->values[i], binary_buf, BINARY_WORD_SIZE - 2);
-            decimalToBinary(A, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-            binaryToBase32Word(binary_buf, words[operand_word_index++]);
-        } else if (mc->addressing_modes[i] == REGISTER_ADDRESSING) {
+    for (int i = 0; i < num_operands; ++i) {
+        const char *operand = statementGetOperandAt(s, i);
+        if (addressing_modes[i] == IMMEDIATE_ADDRESSING) {
+            words[num_words++] = valueWord(atoi(operand + 1), A); // +1 to skip the '#'
+        } else if (addressing_modes[i] == REGISTER_ADDRESSING) {
+            int reg = atoi(operand + 1); // +1 to skip the 'r'
             if (i == 0) {
-                decimalToBinary(mc->registers[i], binary_buf, REGISTER_NUM_BITS);
-                decimalToBinary(0, binary_buf + REGISTER_NUM_BITS, REGISTER_NUM_BITS);
-            } else if (i == 1) {
-                decimalToBinary(0, binary_buf, REGISTER_NUM_BITS);
-                decimalToBinary(mc->registers[i], binary_buf + REGISTER_NUM_BITS, REGISTER_NUM_BITS);
-            }
-            decimalToBinary(A, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-            binaryToBase32Word(binary_buf, words[operand_word_index++]);
-        } else if (mc->addressing_modes[i] == DIRECT_ADDRESSING) {
-            if (mc->is_extern[i]) {
-                decimalToBinary(0, binary_buf, BINARY_WORD_SIZE - 2);
-                decimalToBinary(E, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-                mc->extern_words_index[i] = operand_word_index;
+                words[num_words++] = registersWord(reg, 0);
             } else {
-                decimalToBinary(mc->label_addresses[i], binary_buf, BINARY_WORD_SIZE - 2);
-                decimalToBinary(R, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
+                words[num_words++] = registersWord(0, reg);
             }
-            binaryToBase32Word(binary_buf, words[operand_word_index++]);
-        } else if (mc->addressing_modes[i] == STRUCT_ADDRESSING) {
-            if (mc->is_extern[i]) {
-                decimalToBinary(0, binary_buf, BINARY_WORD_SIZE - 2);
-                decimalToBinary(E, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-                mc->extern_words_index[i] = operand_word_index;
-            } else {
-                decimalToBinary(mc->struct_addresses[i], binary_buf, BINARY_WORD_SIZE - 2);
-                decimalToBinary(R, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-            }
-            binaryToBase32Word(binary_buf, words[operand_word_index++]);
-            decimalToBinary(mc->struct_field_nums[i], binary_buf, BINARY_WORD_SIZE - 2);
-            decimalToBinary(A, binary_buf + OPCODE_NUM_BITS + 2 * ADDRESSING_NUM_BITS, CODING_METHOD_NUM_BITS);
-            binaryToBase32Word(binary_buf, words[operand_word_index++]);
+        } else if (addressing_modes[i] == DIRECT_ADDRESSING) {
+            SymbolOperand *symbol_operand = &symbol_operands[num_symbol_operands++];
+            symbol_operand->operand = operand;
+            symbol_operand->symbol_id = internPoolIntern(names, operand, strlen(operand));
+            symbol_operand->address = address + num_words;
+            words[num_words++] = valueWord(0, R);
+        } else if (addressing_modes[i] == STRUCT_ADDRESSING) {
+            const char *delim = strchr(operand, STRUCT_FIELD_DELIM);
+
+            SymbolOperand *symbol_operand = &symbol_operands[num_symbol_operands++];
+            symbol_operand->operand = operand;
+            symbol_operand->symbol_id = internPoolIntern(names, operand, delim - operand);
+            symbol_operand->address = address + num_words;
+            words[num_words++] = valueWord(0, R);
+            words[num_words++] = valueWord(atoi(delim + 1), A); // struct field num word
         }
     }
-    assert(operand_word_index == mc->size);
-    return true;
-}
+    assert(num_words <= MAX_WORDS_COUNT);
 
-int machineCodeGetNumOperands(MachineCode mc) {
-    return mc->num_operands;
+    mc->size += num_words;
+    return num_symbol_operands;
 }
 
-const char *machineCodeGetOperand(MachineCode mc, int index) {
-    return mc->operands[index];
+/**
+ * It returns the number of words of the machine code, which is also the address of the next instruction.
+ *
+ * @param mc The machine code.
+ */
+size_t machineCodeGetSize(MachineCode mc) {
+    return mc->size;
 }
 
-bool machineCodeGetIsExternOperand(MachineCode mc, int index) {
-    return mc->is_extern[index];
+/**
+ * It returns the words of the machine code, one per address from address 0.
+ *
+ * @param mc The machine code.
+ */
+const unsigned short *machineCodeGetWords(MachineCode mc) {
+    return mc->words;
 }
 
-int machineCodeGetExternalOperandAddress(MachineCode mc, int index) {
-    assert(mc->is_extern[index]);
-    return mc->address + mc->extern_words_index[index];
+/**
+ * It replaces a range of the words of the machine code with the words of other machine code, moving the words after it.
+ * The words of the replacement are copied as they are, so its symbol words have to be resolved again where they land.
+ *
+ * @param mc The machine code.
+ * @param address The address of the first word to replace.
+ * @param count The number of words to replace.
+ * @param replacement The machine code to put instead.
+ */
+void machineCodeSplice(MachineCode mc, int address, int count, MachineCode replacement) {
+    size_t size = mc->size - count + replacement->size;
+    if (size > mc->capacity) {
+        while (size > mc->capacity) {
+            mc->capacity *= 2;
+        }
+        mc->words = realloc(mc->words, mc->capacity * sizeof(*mc->words));
+        if (!mc->words)
+            memoryAllocationError();
+    }
+    memmove(mc->words + address + replacement->size, mc->words + address + count,
+            (mc->size - address - count) * sizeof(*mc->words));
+    memcpy(mc->words + address, replacement->words, replacement->size * sizeof(*mc->words));
+    mc->size = size;
 }
 
-void machineCodeToObjFile(MachineCode mc, FILE *f, int start_address_offset) {
-    int start_address = mc->address + start_address_offset;
-    char binary_buf[BINARY_WORD_SIZE + 1];
-    char base32_buf[BASE32_WORD_SIZE + 1];
+/**
+ * It encodes the address of a symbol an operand refers to, once the symbol is defined. The data segment follows the
+ * code, so a data symbol can only be resolved once all the code is encoded.
+ *
+ * @param mc The machine code.
+ * @param address The address of the word of the operand that holds the address of the symbol.
+ * @param entry The symbol table entry of the symbol, with its final value.
+ * @param start_address_offset The address the code is loaded at.
+ */
+void machineCodeResolveSymbol(MachineCode mc, int address, SymtabEntry entry, int start_address_offset) {
+    assert(address >= 0 && address < (int) mc->size);
 
-    for (int i = 0; i < mc->size; ++i) {
-        decimalToBinary(start_address + i, binary_buf, BINARY_WORD_SIZE);
-        binaryToBase32Word(binary_buf, base32_buf);
-        fprintf(f, "%s %s\n", base32_buf, mc->words[i]);
+    if (symtabEntryGetType(entry) == SYMBOL_EXTERN) {
+        mc->words[address] = valueWord(0, E);
+    } else {
+        mc->words[address] = valueWord(symtabEntryGetAddress(entry, (int) mc->size) + start_address_offset, R);
     }
 }
-
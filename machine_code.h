@@ -6,31 +6,34 @@
 #define ASSEMBLER_MACHINE_CODE_H
 
 #include "parser.h"
+#include "symtab.h"
+#include "arena.h"
+#include "intern_pool.h"
 
+#define MAX_OPERANDS_COUNT 2
 
-typedef struct machine_code_t *MachineCode;
 
-MachineCode machineCodeCreate(Statement s, int ic);
+typedef struct machine_code_t *MachineCode;
 
-int machineCodeCmp(MachineCode mc1, MachineCode mc2);
+/* An operand of an instruction that refers to a symbol, whose address is encoded in a word of the machine code. */
+typedef struct {
+    const char *operand; // as written in the statement
+    int symbol_id; // the interned label, or struct of a struct operand
+    int address; // of the word holding the address of the symbol
+} SymbolOperand;
 
-MachineCode machineCodeCopy(MachineCode mc);
+MachineCode machineCodeCreate(void);
 
 void machineCodeDestroy(MachineCode mc);
 
-size_t machineCodeGetSize(MachineCode mc);
-
-int machineCodeGetNumOperands(MachineCode mc);
-
-const char *machineCodeGetOperand(MachineCode mc, int index);
+int machineCodeAppendInstruction(MachineCode mc, InternPool names, Statement s, SymbolOperand *symbol_operands);
 
-bool machineCodeGetIsExternOperand(MachineCode mc, int index);
+size_t machineCodeGetSize(MachineCode mc);
 
-int machineCodeGetExternalOperandAddress(MachineCode mc, int index);
+const unsigned short *machineCodeGetWords(MachineCode mc);
 
-bool machineCodeUpdateFromSymtab(MachineCode mc, List symtab, const char *filename_suffix, const char *filename,
-                                 int start_address_offset);
+void machineCodeSplice(MachineCode mc, int address, int count, MachineCode replacement);
 
-void machineCodeToObjFile(MachineCode mc, FILE *f, int start_address_offset);
+void machineCodeResolveSymbol(MachineCode mc, int address, SymtabEntry entry, int start_address_offset);
 
 #endif //ASSEMBLER_MACHINE_CODE_H
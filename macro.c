@@ -2,104 +2,179 @@
 // Created by misha on 30/07/2022.
 //
 
-#include <malloc.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "macro.h"
 #include "errors.h"
 
+#define MACRO_TABLE_INITIAL_CAPACITY 16
+
 
 /* Defining a new type called `struct macro_t` which is a struct with two fields: `name` and `body`. */
 struct macro_t {
     int def_line_num;
 
-    const char *name;
-    const char *body;
+    int name_id;
+    const char *name; // the interned name
+    const char *body; // a view into the source, borrowed
+    size_t body_len;
+
+    /* The body, parsed once when the macro is defined. */
+    Statement *statements;
+    int num_statements;
+};
+
+/* The macros, keyed by the interned IDs of their names. The table only borrows the macros. */
+struct macro_table_t {
+    Macro *by_name_id; // NULL for a name that isn't a macro
+    int capacity;
 };
 
 /**
- * It creates a macro.
+ * It creates a macro. The macro is allocated from the arena, and its body text is borrowed from the source.
  *
- * @param name The name of the macro.
- * @param body The body of the macro.
+ * @param arena The arena to allocate the macro from.
+ * @param names The intern pool of the file.
+ * @param name_id The interned ID of the name of the macro.
+ * @param body The text of the body of the macro, or NULL if the macro is empty or its text isn't needed.
+ * @param body_len The length of the text of the body.
+ * @param statements The statements of the body, which the macro borrows.
  */
-Macro macroCreate(const char *name, const char *body, int def_line_num) {
-    Macro m = (Macro) malloc(sizeof(*m));
-    if (!m)
-        memoryAllocationError();
-
-    m->name = strdup(name);
-    if (!m->name)
-        memoryAllocationError();
-
-    if (body) {
-        m->body = strdup(body);
-        if (!m->body)
-            memoryAllocationError();
-    } else {
-        m->body = NULL;
+Macro macroCreate(Arena arena, InternPool names, int name_id, const char *body, size_t body_len, Vector statements,
+                  int def_line_num) {
+    Macro m = (Macro) arenaAlloc(arena, sizeof(*m));
+
+    m->name_id = name_id;
+    m->name = internPoolGetString(names, name_id);
+    m->body = body;
+    m->body_len = body ? body_len : 0;
+    m->num_statements = vectorLength(statements);
+    m->statements = arenaAlloc(arena, m->num_statements * sizeof(*m->statements));
+    for (int i = 0; i < m->num_statements; ++i) {
+        m->statements[i] = vectorGetDataAt(statements, i);
     }
-
     m->def_line_num = def_line_num;
 
     return m;
 }
 
 /**
- * It compares two macros and returns the result.
+ * It returns the text of the body of the macro. The text isn't null-terminated.
  *
- * @param m1 The first macro to compare.
- * @param m2 The macro to compare to.
+ * @param m The macro to get the body of.
+ * @param body_len Set to the length of the text.
+ *
+ * @return The text, or NULL if the macro is empty or its text wasn't kept.
  */
-int macroCmp(Macro m1, Macro m2) {
-    return strcmp(m1->name, m2->name);
+const char *macroGetBody(Macro m, size_t *body_len) {
+    *body_len = m->body_len;
+    return m->body;
 }
 
 /**
- * It copies the macro m and returns the copy.
+ * It returns the name of the macro.
  *
- * @param m The macro to copy.
+ * @param m The macro to get the name of.
  */
-Macro macroCopy(Macro m) {
-    return macroCreate(m->name, m->body, m->def_line_num);
+const char *macroGetName(Macro m) {
+    return m->name;
 }
 
 /**
- * It destroys the macro.
+ * It returns the line number of the macro definition.
  *
- * @param m The macro to destroy.
+ * @param m The macro to get the line number of.
  */
-void macroDestroy(Macro m) {
-    if (m->name)
-        free((char *) m->name);
-    if (m->body)
-        free((char *) m->body);
-    free(m);
+int macroGetDefLineNum(Macro m) {
+    return m->def_line_num;
 }
 
 /**
- * It returns the body of the macro.
+ * It returns the number of statements in the body of the macro.
  *
- * @param m The macro to get the body of.
+ * @param m The macro.
  */
-const char *macroGetBody(Macro m) {
-    return m->body;
+int macroGetStatementsCount(Macro m) {
+    return m->num_statements;
 }
 
 /**
- * It returns the name of the macro.
+ * It returns a statement of the body of the macro.
  *
- * @param m The macro to get the name of.
+ * @param m The macro.
+ * @param index The index of the statement in the body.
  */
-const char *macroGetName(Macro m) {
-    return m->name;
+Statement macroGetStatementAt(Macro m, int index) {
+    return m->statements[index];
 }
 
 /**
- * It returns the line number of the macro definition.
+ * It creates an empty macro table.
+ */
+MacroTable macroTableCreate(void) {
+    MacroTable table = malloc(sizeof(*table));
+    if (!table)
+        memoryAllocationError();
+
+    table->capacity = MACRO_TABLE_INITIAL_CAPACITY;
+    table->by_name_id = calloc(table->capacity, sizeof(*table->by_name_id));
+    if (!table->by_name_id)
+        memoryAllocationError();
+    return table;
+}
+
+/**
+ * It destroys the macro table. The macros live in the arena they were created in.
  *
- * @param m The macro to get the line number of.
+ * @param table The macro table to destroy.
  */
-int macroGetDefLineNum(Macro m) {
-    return m->def_line_num;
+void macroTableDestroy(MacroTable table) {
+    if (!table)
+        return;
+
+    free(table->by_name_id);
+    free(table);
+}
+
+/**
+ * It inserts the macro into the table, unless a macro with the same name is already defined.
+ *
+ * @param table The macro table to insert into.
+ * @param m The macro to insert.
+ *
+ * @return NULL if the macro was inserted, or the previously defined macro with the same name.
+ */
+Macro macroTableInsert(MacroTable table, Macro m) {
+    Macro found_macro = macroTableFind(table, m->name_id);
+    if (found_macro)
+        return found_macro;
+
+    if (m->name_id >= table->capacity) {
+        int old_capacity = table->capacity;
+        while (m->name_id >= table->capacity) {
+            table->capacity *= 2;
+        }
+        table->by_name_id = realloc(table->by_name_id, table->capacity * sizeof(*table->by_name_id));
+        if (!table->by_name_id)
+            memoryAllocationError();
+        memset(table->by_name_id + old_capacity, 0, (table->capacity - old_capacity) * sizeof(*table->by_name_id));
+    }
+    table->by_name_id[m->name_id] = m;
+    return NULL;
+}
+
+/**
+ * It finds a macro by the interned ID of its name.
+ *
+ * @param table The macro table to search.
+ * @param name_id The ID of the name, or INTERN_POOL_NOT_FOUND.
+ *
+ * @return The macro, or NULL if no macro with that name is defined.
+ */
+Macro macroTableFind(MacroTable table, int name_id) {
+    if (name_id < 0 || name_id >= table->capacity)
+        return NULL;
+
+    return table->by_name_id[name_id];
 }
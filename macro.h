@@ -5,21 +5,35 @@
 #ifndef ASSEMBLER_MACRO_H
 #define ASSEMBLER_MACRO_H
 
+#include <stddef.h>
+#include "arena.h"
+#include "parser.h"
+#include "vector.h"
+#include "intern_pool.h"
 
 typedef struct macro_t *Macro;
 
-Macro macroCreate(const char *name, const char *body, int def_line_num);
+typedef struct macro_table_t *MacroTable;
 
-int macroCmp(Macro m1, Macro m2);
+Macro macroCreate(Arena arena, InternPool names, int name_id, const char *body, size_t body_len, Vector statements,
+                  int def_line_num);
 
-Macro macroCopy(Macro m);
-
-void macroDestroy(Macro m);
-
-const char *macroGetBody(Macro m);
+const char *macroGetBody(Macro m, size_t *body_len);
 
 const char *macroGetName(Macro m);
 
 int macroGetDefLineNum(Macro m);
 
+int macroGetStatementsCount(Macro m);
+
+Statement macroGetStatementAt(Macro m, int index);
+
+MacroTable macroTableCreate(void);
+
+void macroTableDestroy(MacroTable table);
+
+Macro macroTableInsert(MacroTable table, Macro m);
+
+Macro macroTableFind(MacroTable table, int name_id);
+
 #endif //ASSEMBLER_MACRO_H
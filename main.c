@@ -1,56 +1,279 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
+#include "file_assembly.h"
+#include "server.h"
+#include "client.h"
+#include "watch.h"
 #include "errors.h"
-#include "pre_assembly.h"
-#include "first_pass.h"
-#include "second_pass.h"
-#include "file_utils.h"
+#include "str_utils.h"
+#include "thread_pool.h"
 
+#define ARENA_STATS_FLAG "--arena-stats"
+#define KEEP_AM_FLAG "--keep-am"
+#define INCREMENTAL_FLAG "--incremental"
+#define JOBS_FLAG "-j"
+#define SERVER_FLAG "--server"
+#define CLIENT_FLAG "--client"
+#define CACHE_DIR_FLAG "--cache-dir"
+#define CACHE_SIZE_FLAG "--cache-size"
+#define CACHE_STATS_FLAG "--cache-stats"
+#define WATCH_FLAG "--watch"
+#define BYTES_PER_MB (1024 * 1024)
+#define MAX_CACHE_SIZE_MB ((long) (SIZE_MAX / BYTES_PER_MB))
+#define OPTION_PREFIX "--"
 
-int main(int argc, char **argv) {
-    if (argc < 2) {
-        errorWithMsg("Not enough arguments! Need to specify files to compile (without suffix).");
+
+/* A file to assemble on the thread pool, with the messages about it buffered until all the files are done. */
+typedef struct {
+    const char *filename;
+    const FileAssemblyOptions *options;
+    off_t size; // of the source file, to assemble the largest files first
+    char *log_buf;
+    size_t log_size;
+    const char *failed_suffix; // of the file that can't be opened, or NULL
+} FileJob;
+
+
+/**
+ * It assembles a single file, printing the messages about it to the log, and exits if a file can't be opened.
+ *
+ * @param filename The name of the file to compile (without suffix).
+ * @param options The options to assemble the file with.
+ * @param log The stream to print the messages to.
+ */
+static void assembleFile(const char *filename, const FileAssemblyOptions *options, FILE *log) {
+    const char *failed_suffix;
+    if (!assembleFileToLog(filename, filename, options, log, &failed_suffix)) {
+        fileNotFoundError(strConcat(filename, failed_suffix));
     }
+}
 
-    for (int i = 1; i < argc; ++i) {
-        printf("============================================================================================\n");
+/**
+ * It assembles a file on the thread pool, buffering the messages about it.
+ *
+ * @param arg The FileJob of the file.
+ */
+static void assembleFileJob(void *arg) {
+    FileJob *job = arg;
+    FILE *log = open_memstream(&job->log_buf, &job->log_size);
+    if (!log)
+        memoryAllocationError();
+
+    const char *failed_suffix;
+    if (!assembleFileToLog(job->filename, job->filename, job->options, log, &failed_suffix))
+        job->failed_suffix = failed_suffix;
+    fclose(log);
+}
+
+/**
+ * It compares FileJobs by the size of their source file, the largest first.
+ */
+static int fileJobCmpBySizeDesc(const void *a, const void *b) {
+    const FileJob *job_a = *(FileJob *const *) a;
+    const FileJob *job_b = *(FileJob *const *) b;
+    return (job_a->size < job_b->size) - (job_a->size > job_b->size);
+}
+
+/**
+ * It assembles the files concurrently on num_threads threads, the largest files first, and then prints the messages
+ * about each file as one block, in the order of the files.
+ *
+ * @param files The names of the files to compile (without suffix).
+ * @param files_count The number of files.
+ * @param options The options to assemble the files with.
+ * @param num_threads The number of threads to assemble the files on.
+ */
+static void assembleFilesInParallel(const char **files, int files_count, const FileAssemblyOptions *options,
+                                    int num_threads) {
+    FileJob *jobs = malloc(files_count * sizeof(*jobs));
+    void **by_size = malloc(files_count * sizeof(*by_size));
+    if (!jobs || !by_size)
+        memoryAllocationError();
+
+    for (int i = 0; i < files_count; ++i) {
+        const char *source_filename = strConcat(files[i], SOURCE_FILE_SUFFIX);
+        struct stat st;
+        jobs[i].filename = files[i];
+        jobs[i].options = options;
+        jobs[i].size = stat(source_filename, &st) == 0 ? st.st_size : 0;
+        jobs[i].log_buf = NULL;
+        jobs[i].log_size = 0;
+        jobs[i].failed_suffix = NULL;
+        by_size[i] = &jobs[i];
+        free((void *) source_filename);
+    }
+    qsort(by_size, files_count, sizeof(*by_size), fileJobCmpBySizeDesc);
+
+    threadPoolRun(num_threads, assembleFileJob, by_size, files_count);
+
+    for (int i = 0; i < files_count; ++i) {
+        fwrite(jobs[i].log_buf, 1, jobs[i].log_size, stdout);
+        free(jobs[i].log_buf);
+        if (jobs[i].failed_suffix) // stop where assembling the files one after another would have stopped
+            fileNotFoundError(strConcat(jobs[i].filename, jobs[i].failed_suffix));
+    }
+    free(by_size);
+    free(jobs);
+}
+
+/**
+ * It checks if the source file of a file to compile exists.
+ *
+ * @param filename The name of the file (without suffix).
+ */
+static bool sourceFileExists(const char *filename) {
+    const char *source_filename = strConcat(filename, SOURCE_FILE_SUFFIX);
+    struct stat st;
+    bool exists = stat(source_filename, &st) == 0;
+    free((void *) source_filename);
+    return exists;
+}
 
-        const char *file_to_compile = argv[i];
+/**
+ * It parses a positive decimal number, which has to be the whole of the argument.
+ *
+ * @param num The argument, or NULL if it is missing.
+ * @param max The largest number allowed.
+ * @param value Set to the number.
+ *
+ * @return true if the argument is a number between 1 and max, false otherwise.
+ */
+static bool parsePositiveNumber(const char *num, long max, long *value) {
+    if (!num || !isdigit((unsigned char) num[0]))
+        return false;
 
-        printf("1. Run pre-assembly for %s\n", file_to_compile);
-        bool pre_assembly_res = run_pre_assembly(file_to_compile);
-        if (!pre_assembly_res) {
-            printf("Pre-assembly for %s failed. cleaning up and skipping first-pass", file_to_compile);
-            removeFileWithSuffix(file_to_compile, AFTER_MACRO_SUFFIX);
-            continue;
+    char *end;
+    errno = 0;
+    *value = strtol(num, &end, 10);
+    return errno == 0 && *end == '\0' && *value >= 1 && *value <= max;
+}
+
+/**
+ * It checks if an argument is the jobs flag, either alone (-j 8) or with the number attached (-j8).
+ *
+ * @param arg The argument.
+ */
+static bool isJobsFlag(const char *arg) {
+    size_t len = strlen(JOBS_FLAG);
+    if (strncmp(arg, JOBS_FLAG, len) != 0)
+        return false;
+    for (const char *c = arg + len; *c; ++c) {
+        if (!isdigit((unsigned char) *c))
+            return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char **argv) {
+    FileAssemblyOptions options = {{false}, false, NULL, false};
+    int num_threads = 1;
+    const char *server_socket = NULL, *client_socket = NULL;
+    const char *cache_dir = NULL;
+    size_t cache_size = OUTPUT_CACHE_DEFAULT_MAX_SIZE;
+    bool cache_stats = false, cache_size_set = false, watch = false;
+    const char **files = malloc(argc * sizeof(*files));
+    if (!files)
+        memoryAllocationError();
+
+    int files_count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], ARENA_STATS_FLAG) == 0) {
+            options.arena_stats = true;
+        } else if (strcmp(argv[i], KEEP_AM_FLAG) == 0) {
+            options.assembly.keep_am = true;
+        } else if (strcmp(argv[i], INCREMENTAL_FLAG) == 0) {
+            /* Only a process that outlives the assembly can keep its state - the server, for its clients. --watch
+             * always keeps it. */
+            options.incremental = true;
+        } else if (strcmp(argv[i], SERVER_FLAG) == 0 || strcmp(argv[i], CLIENT_FLAG) == 0) {
+            const char **socket_path = strcmp(argv[i], SERVER_FLAG) == 0 ? &server_socket : &client_socket;
+            if (!(*socket_path = argv[++i])) {
+                errorWithMsg("Missing socket! --server and --client must be followed by the path of a socket.");
+            }
+        } else if (strcmp(argv[i], CACHE_DIR_FLAG) == 0) {
+            if (!(cache_dir = argv[++i])) {
+                errorWithMsg("Missing cache directory! --cache-dir must be followed by a directory.");
+            }
+        } else if (strcmp(argv[i], CACHE_SIZE_FLAG) == 0) {
+            long megabytes;
+            if (!parsePositiveNumber(argv[++i], MAX_CACHE_SIZE_MB, &megabytes)) {
+                errorWithMsg("Invalid cache size! --cache-size must be followed by a positive number of megabytes.");
+            }
+            cache_size = (size_t) megabytes * BYTES_PER_MB;
+            cache_size_set = true;
+        } else if (strcmp(argv[i], CACHE_STATS_FLAG) == 0) {
+            cache_stats = true;
+        } else if (strcmp(argv[i], WATCH_FLAG) == 0) {
+            watch = true;
+        } else if (isJobsFlag(argv[i])) {
+            /* The number of threads is either attached (-j8) or the next argument (-j 8). */
+            const char *num = argv[i][strlen(JOBS_FLAG)] ? argv[i] + strlen(JOBS_FLAG) : argv[++i];
+            long jobs;
+            if (!parsePositiveNumber(num, INT_MAX, &jobs)) {
+                errorWithMsg("Invalid number of jobs! -j must be followed by a positive number.");
+            }
+            num_threads = (int) jobs;
+        } else if (strncmp(argv[i], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0) {
+            errorWithMsg(strConcat("Unknown option! ", argv[i])); // a misspelled option isn't quietly dropped
         } else {
-            printf("Pre-assembly for %s succeeded. %s%s file created\n", file_to_compile, file_to_compile, AFTER_MACRO_SUFFIX);
+            files[files_count++] = argv[i];
         }
+    }
+    /* The cache is only used by the files this process assembles from the command line itself. */
+    if ((cache_stats || cache_size_set) && !cache_dir) {
+        errorWithMsg("Missing cache directory! --cache-size and --cache-stats must be used with --cache-dir.");
+    }
+    if (cache_dir && (server_socket || client_socket || watch)) {
+        errorWithMsg("Invalid options! --cache-dir can't be used with --server, --client or --watch.");
+    }
+    if (server_socket) {
+        serverRun(server_socket);
+    }
+    if (files_count < 1) {
+        errorWithMsg("Not enough arguments! Need to specify files to compile (without suffix).");
+    }
 
-        printf("2. Run first-pass for %s\n", file_to_compile);
-        List symtab, machine_codes, memory_codes;
-        bool first_pass_res = run_first_pass(file_to_compile, &symtab, &machine_codes, &memory_codes);
-        if (!first_pass_res) {
-            printf("First-pass for %s failed. skipping second-pass\n", file_to_compile);
-            listDestroy(symtab);
-            listDestroy(machine_codes);
-            listDestroy(memory_codes);
-            continue;
-        }
+    if (watch) {
+        /* The files are assembled in this process, which keeps their state between saves. */
+        watchRun(files, files_count, &options);
+    }
+    if (cache_dir) {
+        options.cache = outputCacheCreate(cache_dir, cache_size);
+    }
 
-        printf("3. Run second-pass for %s\n", file_to_compile);
-        bool second_pass_res = run_second_pass(file_to_compile, symtab, machine_codes, memory_codes);
-        if (!second_pass_res) {
-            printf("Second-pass for %s failed. cleaning up artifacts..\n", file_to_compile);
-            removeFileWithSuffix(file_to_compile, OBJECT_FILE_SUFFIX);
-            removeFileWithSuffix(file_to_compile, ENTRIES_FILE_SUFFIX);
-            removeFileWithSuffix(file_to_compile, EXTERNAL_FILE_SUFFIX);
-        } else {
-            printf("Second-pass for %s succeeded. %s%s file created\n", file_to_compile, file_to_compile, OBJECT_FILE_SUFFIX);
+    int first_file = 0;
+    if (client_socket) {
+        clientRun(client_socket, files, files_count, &options);
+        first_file = files_count;
+    } else if (num_threads > 1) {
+        /* A missing source file stops the assembly, so only the files before it are assembled in parallel, and the
+         * missing file is then reported just like it is when the files are assembled one after another. */
+        int parallel_count = 0;
+        while (parallel_count < files_count && sourceFileExists(files[parallel_count])) {
+            parallel_count++;
         }
+        assembleFilesInParallel(files, parallel_count, &options, num_threads);
+        first_file = parallel_count;
+    }
+    for (int i = first_file; i < files_count; ++i) {
+        assembleFile(files[i], &options, stdout);
+    }
+    if (cache_stats) {
+        outputCachePrintStats(options.cache, stdout);
     }
+    outputCacheDestroy(options.cache);
 
+    free(files);
     return 0;
 }
@@ -4,98 +4,137 @@
 
 #include <string.h>
 #include <assert.h>
-#include <malloc.h>
+#include <stdlib.h>
 #include "memory_code.h"
 #include "const_tables.h"
-#include "errors.h"
 #include "base_conversion.h"
+#include "errors.h"
 
 
-struct memory_code_t {
-    int* values;
-    int size;
+#define INITIAL_CAPACITY 64 // words
 
-    int start_address;
+
+/* The data segment of a file - the words of its data store directives, one after another from offset 0. The data
+ * symbols hold offsets into the segment, which is placed right after the code when the object file is written. */
+struct memory_code_t {
+    unsigned short *words; // packed BINARY_WORD_SIZE-bit words
+    size_t size;
+    size_t capacity;
 };
 
-MemoryCode memoryCodeCreate(Statement s, int dc) {
+/**
+ * It creates an empty data segment.
+ */
+MemoryCode memoryCodeCreate(void) {
     MemoryCode mem_c = malloc(sizeof(*mem_c));
-    if (!mem_c) {
+    if (!mem_c)
         memoryAllocationError();
-    }
 
-    mem_c->start_address = dc;
-    mem_c->size = calcDirectiveDataSize(s);
-    mem_c->values = malloc(mem_c->size * sizeof(int));
-    if (!mem_c->values) {
+    mem_c->size = 0;
+    mem_c->capacity = INITIAL_CAPACITY;
+    mem_c->words = malloc(mem_c->capacity * sizeof(*mem_c->words));
+    if (!mem_c->words)
         memoryAllocationError();
+    return mem_c;
+}
+
+/**
+ * It destroys the data segment.
+ *
+ * @param mc The data segment to destroy.
+ */
+void memoryCodeDestroy(MemoryCode mc) {
+    if (!mc)
+        return;
+
+    free(mc->words);
+    free(mc);
+}
+
+/**
+ * It appends the words of a data store directive to the end of the data segment. Other directives add nothing.
+ *
+ * @param mc The data segment.
+ * @param s The directive statement.
+ */
+void memoryCodeAppendDirective(MemoryCode mc, Statement s) {
+    size_t size = calcDirectiveDataSize(s);
+    if (mc->size + size > mc->capacity) {
+        while (mc->size + size > mc->capacity) {
+            mc->capacity *= 2;
+        }
+        mc->words = realloc(mc->words, mc->capacity * sizeof(*mc->words));
+        if (!mc->words)
+            memoryAllocationError();
     }
+    unsigned short *words = mc->words + mc->size;
 
     const char *directive = statementGetMnemonic(s);
-    List operands = statementGetOperands(s);
-    int num_operands = listLength(operands);
+    int num_operands = statementGetOperandsCount(s);
 
     if (strcmp(directive, DIRECTIVE_DATA) == 0) {
         for (int i = 0; i < num_operands; i++) {
-            mem_c->values[i] = atoi(listGetDataAt(operands, i));
+            words[i] = atoi(statementGetOperandAt(s, i));
         }
     } else if (strcmp(directive, DIRECTIVE_STRING) == 0) {
-        const char *str = listGetDataAt(operands, 0);
-        for (int i = 0; i < strlen(str + 1) - 1; i++) {
-            mem_c->values[i] = str[1 + i]; // +1 to skip the first '"'
+        const char *str = statementGetOperandAt(s, 0);
+        for (size_t i = 0; i < size - 1; i++) {
+            words[i] = str[1 + i]; // +1 to skip the first '"'
         }
-        mem_c->values[mem_c->size - 1] = '\0';
+        words[size - 1] = '\0';
     } else if (strcmp(directive, DIRECTIVE_STRUCT) == 0) {
-        mem_c->values[0] = atoi(listGetDataAt(operands, 0));
+        words[0] = atoi(statementGetOperandAt(s, 0));
 
-        const char *str = listGetDataAt(statementGetOperands(s), 1);
-        for (int i = 1; i <= strlen(str + 1) - 1; i++) {
-            mem_c->values[i] = str[i]; // +1 to skip the first '"' is not needed since i starts from 1
+        const char *str = statementGetOperandAt(s, 1);
+        for (size_t i = 1; i < size - 1; i++) {
+            words[i] = str[i]; // +1 to skip the first '"' is not needed since i starts from 1
         }
-        mem_c->values[mem_c->size - 1] = '\0';
-    } else { // .entry or .extern
-        free(mem_c);
-        return NULL;
+        words[size - 1] = '\0';
     }
-
-    return mem_c;
-}
-
-int memoryCodeCmp(MemoryCode mc1, MemoryCode mc2) {
-    return mc1->start_address - mc2->start_address;
-}
-
-MemoryCode memoryCodeCopy(MemoryCode mc) {
-    MemoryCode copy = malloc(sizeof(*copy));
-    if (!copy) {
-        memoryAllocationError();
-    }
-
-    copy->start_address = mc->start_address;
-    copy->size = mc->size;
-    copy->values = malloc(copy->size * sizeof(int));
-    if (!copy->values) {
-        memoryAllocationError();
-    }
-    memcpy(copy->values, mc->values, copy->size * sizeof(int));
-    return copy;
-}
-
-void memoryCodeDestroy(MemoryCode mc) {
-    free(mc->values);
-    free(mc);
+    mc->size += size;
 }
 
+/**
+ * It returns the number of words in the data segment, which is also the offset of the next directive's data.
+ *
+ * @param mc The data segment.
+ */
 size_t memoryCodeGetSize(MemoryCode mc) {
     return mc->size;
 }
 
-void memoryCodeSetStartAddress(MemoryCode mc, int address) {
-    mc->start_address = address;
+/**
+ * It returns the words of the data segment, one per offset from offset 0.
+ *
+ * @param mc The data segment.
+ */
+const unsigned short *memoryCodeGetWords(MemoryCode mc) {
+    return mc->words;
 }
 
-int memoryCodeGetStartAddress(MemoryCode mc) {
-    return mc->start_address;
+/**
+ * It replaces a range of the words of the data segment with the words of another data segment, moving the words after
+ * it.
+ *
+ * @param mc The data segment.
+ * @param offset The offset of the first word to replace.
+ * @param count The number of words to replace.
+ * @param replacement The data segment to put instead.
+ */
+void memoryCodeSplice(MemoryCode mc, size_t offset, size_t count, MemoryCode replacement) {
+    size_t size = mc->size - count + replacement->size;
+    if (size > mc->capacity) {
+        while (size > mc->capacity) {
+            mc->capacity *= 2;
+        }
+        mc->words = realloc(mc->words, mc->capacity * sizeof(*mc->words));
+        if (!mc->words)
+            memoryAllocationError();
+    }
+    memmove(mc->words + offset + replacement->size, mc->words + offset + count,
+            (mc->size - offset - count) * sizeof(*mc->words));
+    memcpy(mc->words + offset, replacement->words, replacement->size * sizeof(*mc->words));
+    mc->size = size;
 }
 
 size_t calcDirectiveDataSize(Statement s) {
@@ -104,32 +143,14 @@ size_t calcDirectiveDataSize(Statement s) {
     const char *directive = statementGetMnemonic(s);
 
     if (strcmp(directive, DIRECTIVE_DATA) == 0) {
-        return listLength(statementGetOperands(s));
+        return statementGetOperandsCount(s);
     } else if (strcmp(directive, DIRECTIVE_STRING) == 0) {
-        const char *str = listGetDataAt(statementGetOperands(s), 0);
+        const char *str = statementGetOperandAt(s, 0);
         return strlen(str) - 2 + 1; // +1 for null terminator, -2 for quotes
     } else if (strcmp(directive, DIRECTIVE_STRUCT) == 0) {
-        const char *str = listGetDataAt(statementGetOperands(s), 1);
+        const char *str = statementGetOperandAt(s, 1);
         return 1 + strlen(str) - 2 + 1; // +1 for null terminator, -2 for quotes
     } else { // .entry or .extern
         return 0;
     }
 }
-
-void memoryCodeToObjFile(MemoryCode mc, FILE *f, int start_address_offset) {
-    int start_address = mc->start_address + start_address_offset;
-    char binary_buf1[BINARY_WORD_SIZE + 1];
-    char binary_buf2[BINARY_WORD_SIZE + 1];
-    char base32_buf1[BASE32_WORD_SIZE + 1];
-    char base32_buf2[BASE32_WORD_SIZE + 1];
-
-    for (int i = 0; i < mc->size; ++i) {
-        decimalToBinary(start_address + i, binary_buf1, BINARY_WORD_SIZE);
-        binaryToBase32Word(binary_buf1, base32_buf1);
-
-        decimalToBinary(mc->values[i], binary_buf2, BINARY_WORD_SIZE);
-        binaryToBase32Word(binary_buf2, base32_buf2);
-
-        fprintf(f, "%s %s\n", base32_buf1, base32_buf2);
-    }
-}
@@ -5,27 +5,23 @@
 #ifndef ASSEMBLER_MEMORY_CODE_H
 #define ASSEMBLER_MEMORY_CODE_H
 
-#include <stdio.h>
+#include <stddef.h>
 #include "parser.h"
 
 typedef struct memory_code_t *MemoryCode;
 
-MemoryCode memoryCodeCreate(Statement s, int dc);
-
-int memoryCodeCmp(MemoryCode mc1, MemoryCode mc2);
-
-MemoryCode memoryCodeCopy(MemoryCode mc);
+MemoryCode memoryCodeCreate(void);
 
 void memoryCodeDestroy(MemoryCode mc);
 
+void memoryCodeAppendDirective(MemoryCode mc, Statement s);
+
 size_t memoryCodeGetSize(MemoryCode mc);
 
-void memoryCodeSetStartAddress(MemoryCode mc, int address);
+const unsigned short *memoryCodeGetWords(MemoryCode mc);
 
-int memoryCodeGetStartAddress(MemoryCode mc);
+void memoryCodeSplice(MemoryCode mc, size_t offset, size_t count, MemoryCode replacement);
 
 size_t calcDirectiveDataSize(Statement s);
 
-void memoryCodeToObjFile(MemoryCode mc, FILE *f, int start_address_offset);
-
 #endif //ASSEMBLER_MEMORY_CODE_H
@@ -0,0 +1,504 @@
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "output_cache.h"
+#include "assembler.h"
+#include "file_utils.h"
+#include "str_utils.h"
+#include "errors.h"
+
+#define ENTRY_MAGIC "ASMCACH2" // bumped whenever the layout of an entry changes
+#define KEY_VERSION ENTRY_MAGIC "/" LIBASSEMBLER_VERSION // so a new assembler doesn't hit the entries of an old one
+#define EVICTION_LOW_WATER(_max_size) ((_max_size) - (_max_size) / 4) // so a full cache isn't scanned on every store
+#define ENTRY_NAME_SIZE 16 // the key, in hex
+#define ENTRY_PATH_SIZE 4096
+#define TMP_ENTRY_SUFFIX ".XXXXXX" // for mkstemp
+#define ENTRY_MODE 0644
+#define OUTPUT_RECORD_INITIAL_CAPACITY 4
+
+#define FNV_OFFSET_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+
+struct output_cache_t {
+    char *dir;
+    size_t max_size;
+
+    /* The cache is shared by the threads that assemble the files. */
+    pthread_mutex_t lock;
+    size_t total_size; // of the entries, as of the last eviction and the entries stored since
+    /* The statistics. */
+    int hits;
+    int misses;
+    size_t bytes_saved; // of sources that weren't assembled
+};
+
+/* A write or a removal of an output file, as read from an entry. */
+typedef struct {
+    bool remove;
+    const char *suffix;
+    const char *content;
+    size_t size;
+} EntryAction;
+
+/* An entry of the cache, with its modification time - which a hit updates, so it is the time the entry was last used. */
+typedef struct {
+    char name[ENTRY_NAME_SIZE + 1];
+    time_t mtime;
+    off_t size;
+} EntryInfo;
+
+/**
+ * It appends an action to the record, with a copy of the content. A file that is removed after it was written only
+ * has to be removed, so the write is dropped.
+ *
+ * @param record The record.
+ * @param remove Whether the file was removed, or written.
+ * @param suffix The suffix of the file, which isn't copied.
+ * @param content The content of a written file.
+ * @param size The size of the content.
+ */
+void outputRecordAdd(OutputRecord *record, bool remove, const char *suffix, const char *content, size_t size) {
+    if (remove) {
+        int kept = 0;
+        for (int i = 0; i < record->count; ++i) {
+            if (!record->actions[i].remove && strcmp(record->actions[i].suffix, suffix) == 0) {
+                free(record->actions[i].content);
+            } else {
+                record->actions[kept++] = record->actions[i];
+            }
+        }
+        record->count = kept;
+    }
+    if (record->count == record->capacity) {
+        record->capacity = record->capacity ? record->capacity * 2 : OUTPUT_RECORD_INITIAL_CAPACITY;
+        record->actions = realloc(record->actions, record->capacity * sizeof(*record->actions));
+        if (!record->actions)
+            memoryAllocationError();
+    }
+
+    OutputAction *action = &record->actions[record->count++];
+    action->remove = remove;
+    action->suffix = suffix;
+    action->content = NULL;
+    action->size = remove ? 0 : size;
+    if (!remove && size) {
+        action->content = malloc(size);
+        if (!action->content)
+            memoryAllocationError();
+        memcpy(action->content, content, size);
+    }
+}
+
+/**
+ * It frees the actions of a record.
+ *
+ * @param record The record.
+ */
+void outputRecordFree(OutputRecord *record) {
+    for (int i = 0; i < record->count; ++i) {
+        free(record->actions[i].content);
+    }
+    free(record->actions);
+    record->actions = NULL;
+    record->count = 0;
+    record->capacity = 0;
+}
+
+/**
+ * It compares entries by the time they were last used, the least recently used first.
+ */
+static int entryInfoCmpByMtime(const void *a, const void *b) {
+    const EntryInfo *entry_a = a;
+    const EntryInfo *entry_b = b;
+    return (entry_a->mtime > entry_b->mtime) - (entry_a->mtime < entry_b->mtime);
+}
+
+/**
+ * It checks if a file in the cache directory is an entry - its name is a key in hex.
+ *
+ * @param name The name of the file.
+ */
+static bool isEntryName(const char *name) {
+    if (strlen(name) != ENTRY_NAME_SIZE)
+        return false;
+    for (int i = 0; i < ENTRY_NAME_SIZE; ++i) {
+        if (!strchr("0123456789abcdef", name[i]))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * It evicts the least recently used entries if the entries don't fit in the maximum size of the cache, until they fit
+ * in the target size, and records the size of the entries that are left. Other processes may use the same directory,
+ * so the size is measured here rather than only tracked.
+ *
+ * @param cache The cache.
+ * @param target_size The size to evict the entries down to - at most the maximum size.
+ */
+static void outputCacheEvict(OutputCache cache, size_t target_size) {
+    cache->total_size = 0;
+    DIR *dir = opendir(cache->dir);
+    if (!dir)
+        return;
+
+    EntryInfo *entries = NULL;
+    int count = 0, capacity = 0;
+    size_t total_size = 0;
+    struct dirent *dirent;
+    while ((dirent = readdir(dir))) {
+        struct stat st;
+        if (!isEntryName(dirent->d_name) || fstatat(dirfd(dir), dirent->d_name, &st, 0) != 0)
+            continue;
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : OUTPUT_RECORD_INITIAL_CAPACITY;
+            entries = realloc(entries, capacity * sizeof(*entries));
+            if (!entries)
+                memoryAllocationError();
+        }
+        strcpy(entries[count].name, dirent->d_name);
+        entries[count].mtime = st.st_mtime;
+        entries[count].size = st.st_size;
+        total_size += st.st_size;
+        count++;
+    }
+
+    if (total_size > cache->max_size) {
+        qsort(entries, count, sizeof(*entries), entryInfoCmpByMtime);
+        for (int i = 0; i < count && total_size > target_size; ++i) {
+            if (unlinkat(dirfd(dir), entries[i].name, 0) == 0)
+                total_size -= entries[i].size;
+        }
+    }
+    closedir(dir);
+    free(entries);
+    cache->total_size = total_size;
+}
+
+/**
+ * It opens a cache directory, creating it if it doesn't exist, and evicts the least recently used entries if it is
+ * larger than its maximum size.
+ *
+ * @param dir The directory.
+ * @param max_size The size the entries are evicted down to whenever they grow past it.
+ */
+OutputCache outputCacheCreate(const char *dir, size_t max_size) {
+    mkdir(dir, 0777); // fails harmlessly if it exists - and if it can't be created, every lookup misses
+
+    OutputCache cache = malloc(sizeof(*cache));
+    if (!cache || !(cache->dir = strdup(dir)))
+        memoryAllocationError();
+    cache->max_size = max_size;
+    pthread_mutex_init(&cache->lock, NULL);
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->bytes_saved = 0;
+    outputCacheEvict(cache, max_size);
+    return cache;
+}
+
+/**
+ * It closes the cache.
+ *
+ * @param cache The cache.
+ */
+void outputCacheDestroy(OutputCache cache) {
+    if (!cache)
+        return;
+
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->dir);
+    free(cache);
+}
+
+/**
+ * It adds bytes to an FNV-1a hash.
+ *
+ * @param hash The hash so far.
+ * @param data The bytes.
+ * @param size The number of bytes.
+ */
+static uint64_t fnv1aUpdate(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * It computes the key of a file - the 64-bit FNV-1a hash of everything its outputs depend on. It only picks the entry
+ * of the file - two inputs may have the same key, so the input stored in the entry is compared as well.
+ *
+ * @param input What the outputs of the file depend on.
+ */
+static uint64_t outputCacheKey(const OutputCacheInput *input) {
+    uint64_t hash = fnv1aUpdate(FNV_OFFSET_BASIS, KEY_VERSION, sizeof(KEY_VERSION));
+    hash = fnv1aUpdate(hash, &input->options, sizeof(input->options));
+    hash = fnv1aUpdate(hash, input->filename, strlen(input->filename) + 1);
+    return fnv1aUpdate(hash, input->source, input->size);
+}
+
+/**
+ * It formats the path of the entry of a key.
+ *
+ * @param cache The cache.
+ * @param key The key.
+ * @param path Set to the path.
+ */
+static void entryPath(OutputCache cache, uint64_t key, char path[ENTRY_PATH_SIZE]) {
+    snprintf(path, ENTRY_PATH_SIZE, "%s/%016llx", cache->dir, (unsigned long long) key);
+}
+
+/**
+ * It takes the next field of an entry that is read.
+ *
+ * @param cursor The position in the entry, advanced past the field.
+ * @param end The end of the entry.
+ * @param size The size of the field.
+ *
+ * @return The field, or NULL if the entry ends before it.
+ */
+static const char *entryTake(const char **cursor, const char *end, size_t size) {
+    if ((size_t) (end - *cursor) < size)
+        return NULL;
+    const char *field = *cursor;
+    *cursor += size;
+    return field;
+}
+
+/**
+ * It takes the next word of an entry that is read.
+ *
+ * @param cursor The position in the entry, advanced past the word.
+ * @param end The end of the entry.
+ * @param word Set to the word.
+ *
+ * @return false if the entry ends before it, true otherwise.
+ */
+static bool entryTakeWord(const char **cursor, const char *end, uint64_t *word) {
+    const char *field = entryTake(cursor, end, sizeof(*word));
+    if (field)
+        memcpy(word, field, sizeof(*word));
+    return field != NULL;
+}
+
+/**
+ * It reads an entry in full, and checks that it is the entry of the input - before anything is done with it, so that a
+ * malformed entry, or the entry of another input with the same key, is never replayed in part.
+ *
+ * @param data The entry.
+ * @param size The size of the entry.
+ * @param input The input the entry should be of.
+ * @param log_buf Set to the messages about the file.
+ * @param log_size Set to the size of the messages.
+ * @param actions Set to the actions done to the output files, to be freed with free.
+ * @param count Set to the number of actions.
+ *
+ * @return false if the entry is malformed or isn't of the input, true otherwise.
+ */
+static bool readEntry(const char *data, size_t size, const OutputCacheInput *input, const char **log_buf,
+                      size_t *log_size, EntryAction **actions, size_t *count) {
+    const char *cursor = data, *end = data + size;
+    uint64_t entry_options, filename_size, source_size, entry_log_size, entry_count;
+    const char *version = entryTake(&cursor, end, sizeof(KEY_VERSION));
+    if (!version || memcmp(version, KEY_VERSION, sizeof(KEY_VERSION)) != 0 || !entryTakeWord(&cursor, end, &entry_options) ||
+        !entryTakeWord(&cursor, end, &filename_size) || !entryTakeWord(&cursor, end, &source_size) ||
+        !entryTakeWord(&cursor, end, &entry_log_size) || !entryTakeWord(&cursor, end, &entry_count))
+        return false;
+
+    size_t input_filename_size = strlen(input->filename);
+    if (entry_options != input->options || filename_size != input_filename_size || source_size != input->size)
+        return false;
+    const char *filename = entryTake(&cursor, end, filename_size);
+    const char *source = entryTake(&cursor, end, source_size);
+    *log_buf = entryTake(&cursor, end, entry_log_size);
+    if (!filename || !source || !*log_buf || memcmp(filename, input->filename, filename_size) != 0 ||
+        memcmp(source, input->source, source_size) != 0)
+        return false;
+    *log_size = entry_log_size;
+
+    /* Every action takes at least its three words, so a count the entry can't hold is malformed. */
+    if (entry_count > (uint64_t) (end - cursor) / (3 * sizeof(uint64_t)))
+        return false;
+    *actions = malloc((entry_count ? entry_count : 1) * sizeof(**actions));
+    if (!*actions)
+        memoryAllocationError();
+    for (uint64_t i = 0; i < entry_count; ++i) {
+        uint64_t remove, suffix_size, content_size;
+        if (!entryTakeWord(&cursor, end, &remove) || !entryTakeWord(&cursor, end, &suffix_size) ||
+            !entryTakeWord(&cursor, end, &content_size) || suffix_size >= (uint64_t) (end - cursor)) {
+            free(*actions);
+            return false;
+        }
+        const char *suffix = entryTake(&cursor, end, suffix_size + 1); // null-terminated
+        const char *content = entryTake(&cursor, end, content_size);
+        if (!suffix || !content || suffix[suffix_size] != '\0') {
+            free(*actions);
+            return false;
+        }
+        (*actions)[i] = (EntryAction) {remove != 0, suffix, content, content_size};
+    }
+    *count = entry_count;
+    return true;
+}
+
+/**
+ * It replays an entry - it does the actions to the output files, and then prints the messages. The whole entry is
+ * read and checked first, so nothing is done with an entry that can't be replayed. If an output file can't be written
+ * midway, the files of the earlier actions are already written or removed - but the caller then assembles the file,
+ * which writes or removes every one of those files again, the same way.
+ *
+ * @param data The entry.
+ * @param size The size of the entry.
+ * @param input The input the entry should be of.
+ * @param path The path of the file (without suffix).
+ * @param log The stream to print the messages to.
+ *
+ * @return false if the entry is malformed, isn't of the input, or an output file can't be written - nothing is printed
+ * then - true otherwise.
+ */
+static bool replayEntry(const char *data, size_t size, const OutputCacheInput *input, const char *path, FILE *log) {
+    const char *log_buf;
+    size_t log_size, count;
+    EntryAction *actions;
+    if (!readEntry(data, size, input, &log_buf, &log_size, &actions, &count))
+        return false;
+
+    bool replayed = true;
+    for (size_t i = 0; replayed && i < count; ++i) {
+        if (actions[i].remove) {
+            removeFileWithSuffix(path, actions[i].suffix);
+        } else {
+            replayed = writeFileWithSuffix(path, actions[i].suffix, actions[i].content, actions[i].size);
+        }
+    }
+    free(actions);
+    if (replayed)
+        fwrite(log_buf, 1, log_size, log);
+    return replayed;
+}
+
+/**
+ * It looks a file up in the cache, and on a hit replays the entry - the output files are written and removed, and the
+ * messages are printed, just like they were when the file was assembled.
+ *
+ * @param cache The cache.
+ * @param input What the outputs of the file depend on.
+ * @param path The path of the file (without suffix).
+ * @param log The stream to print the messages to.
+ *
+ * @return Whether it was a hit - on a miss, nothing is printed, and the file has to be assembled.
+ */
+bool outputCacheRestore(OutputCache cache, const OutputCacheInput *input, const char *path, FILE *log) {
+    char entry_path[ENTRY_PATH_SIZE];
+    entryPath(cache, outputCacheKey(input), entry_path);
+
+    FileContent entry;
+    bool hit = false;
+    if (readFileWithSuffix(entry_path, "", &entry)) {
+        hit = replayEntry(entry.data, entry.size, input, path, log);
+        fileContentFree(&entry);
+    }
+    if (hit)
+        utimensat(AT_FDCWD, entry_path, NULL, 0); // used now, for the eviction
+
+    pthread_mutex_lock(&cache->lock);
+    if (hit) {
+        cache->hits++;
+        cache->bytes_saved += input->size;
+    } else {
+        cache->misses++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return hit;
+}
+
+/**
+ * It appends a word to an entry that is written.
+ *
+ * @param buf The entry.
+ * @param word The word.
+ */
+static void entryAppendWord(StrBuffer *buf, uint64_t word) {
+    strBufferAppend(buf, (const char *) &word, sizeof(word));
+}
+
+/**
+ * It stores the entry of a file that was assembled. The entry is written to a temporary file that is then renamed, so
+ * other assemblies never see it half written, and the least recently used entries are evicted once the entries grow
+ * past the maximum size of the cache. A failure to write it is ignored - the file is only assembled again.
+ *
+ * @param cache The cache.
+ * @param input What the outputs of the file depend on.
+ * @param log_buf The messages about the file.
+ * @param log_size The size of the messages.
+ * @param record The actions done to the output files.
+ */
+void outputCacheStore(OutputCache cache, const OutputCacheInput *input, const char *log_buf, size_t log_size,
+                      const OutputRecord *record) {
+    StrBuffer buf = {NULL, 0, 0};
+    size_t filename_size = strlen(input->filename);
+    strBufferAppend(&buf, KEY_VERSION, sizeof(KEY_VERSION));
+    entryAppendWord(&buf, input->options);
+    entryAppendWord(&buf, filename_size);
+    entryAppendWord(&buf, input->size);
+    entryAppendWord(&buf, log_size);
+    entryAppendWord(&buf, record->count);
+    strBufferAppend(&buf, input->filename, filename_size);
+    strBufferAppend(&buf, input->source, input->size);
+    strBufferAppend(&buf, log_buf, log_size);
+    for (int i = 0; i < record->count; ++i) {
+        const OutputAction *action = &record->actions[i];
+        entryAppendWord(&buf, action->remove);
+        entryAppendWord(&buf, strlen(action->suffix));
+        entryAppendWord(&buf, action->size);
+        strBufferAppend(&buf, action->suffix, strlen(action->suffix) + 1);
+        if (action->size)
+            strBufferAppend(&buf, action->content, action->size);
+    }
+
+    char entry_path[ENTRY_PATH_SIZE], tmp_path[ENTRY_PATH_SIZE + sizeof(TMP_ENTRY_SUFFIX)];
+    entryPath(cache, outputCacheKey(input), entry_path);
+    snprintf(tmp_path, sizeof(tmp_path), "%s%s", entry_path, TMP_ENTRY_SUFFIX);
+    int fd = mkstemp(tmp_path);
+    bool stored = false;
+    if (fd != -1) {
+        fchmod(fd, ENTRY_MODE); // mkstemp creates the file for its owner only
+        bool written = write(fd, buf.data, buf.length) == (ssize_t) buf.length;
+        written = close(fd) == 0 && written;
+        stored = written && rename(tmp_path, entry_path) == 0;
+        if (!stored)
+            unlink(tmp_path);
+    }
+
+    if (stored) {
+        pthread_mutex_lock(&cache->lock);
+        cache->total_size += buf.length;
+        if (cache->total_size > cache->max_size)
+            outputCacheEvict(cache, EVICTION_LOW_WATER(cache->max_size));
+        pthread_mutex_unlock(&cache->lock);
+    }
+    strBufferFree(&buf);
+}
+
+/**
+ * It prints the statistics of the cache - the hits, the misses, and the bytes of source that weren't assembled thanks
+ * to the hits.
+ *
+ * @param cache The cache.
+ * @param out The stream to print to.
+ */
+void outputCachePrintStats(OutputCache cache, FILE *out) {
+    fprintf(out, "Cache stats: %d hits, %d misses, %zu bytes saved\n", cache->hits, cache->misses, cache->bytes_saved);
+}
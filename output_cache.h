@@ -0,0 +1,57 @@
+#ifndef ASSEMBLER_OUTPUT_CACHE_H
+#define ASSEMBLER_OUTPUT_CACHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* A directory of the outputs of earlier assemblies, keyed by the hash of what they depend on - the version of the
+ * assembler, the options, the name of the file and its source. An entry is what it depends on, the messages about the
+ * file and what was done to each of its output files, so a hit - an entry of the same input, compared in full, as the
+ * hash is not collision-resistant - replays them instead of assembling the file. */
+
+#define OUTPUT_CACHE_DEFAULT_MAX_SIZE (64 * 1024 * 1024)
+
+typedef struct output_cache_t *OutputCache;
+
+/* Something done to an output file. */
+typedef struct {
+    bool remove; // or write the content
+    const char *suffix; // one of the output file suffixes, not copied
+    char *content;
+    size_t size;
+} OutputAction;
+
+/* What the outputs of a file depend on, besides the version of the assembler. */
+typedef struct {
+    const char *filename; // without suffix, which the messages about the file contain
+    unsigned options; // the options the file is assembled with, as bits
+    const char *source;
+    size_t size;
+} OutputCacheInput;
+
+/* The actions done to the output files of an assembly, in order. */
+typedef struct {
+    OutputAction *actions;
+    int count;
+    int capacity;
+} OutputRecord;
+
+
+void outputRecordAdd(OutputRecord *record, bool remove, const char *suffix, const char *content, size_t size);
+
+void outputRecordFree(OutputRecord *record);
+
+OutputCache outputCacheCreate(const char *dir, size_t max_size);
+
+void outputCacheDestroy(OutputCache cache);
+
+bool outputCacheRestore(OutputCache cache, const OutputCacheInput *input, const char *path, FILE *log);
+
+void outputCacheStore(OutputCache cache, const OutputCacheInput *input, const char *log_buf, size_t log_size,
+                      const OutputRecord *record);
+
+void outputCachePrintStats(OutputCache cache, FILE *out);
+
+#endif //ASSEMBLER_OUTPUT_CACHE_H
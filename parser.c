@@ -11,29 +11,33 @@
 #include <stdio.h>
 #include <assert.h>
 #include "const_tables.h"
-#include "rules.h"
 #include "types_utils.h"
 
 #define WHITESPACE_DELIM " \t\n "
 #define OPERANDS_DELIM ","
+#define TOKENS_DELIM WHITESPACE_DELIM OPERANDS_DELIM
 #define OPERANDS_DELIM_CHAR ','
 #define LABEL_SUFFUX ":"
 #define COMMENT_PREFIX ";"
 
-#define START_MACRO_STR "macro"
-#define END_MACRO_STR "endmacro"
-
 #define LABEL_MAX_LENGTH 30
 
+#define TOKENS_BUFFER_LEN 16
+
 struct statement_t {
     int line_num;
-    const char *raw_text;
-    List tokens;
+    const char *raw_text; // not null-terminated
+    size_t raw_len;
+
+    /* The tokens are spans into raw_text. text is a copy of raw_text with every token null-terminated in place. */
+    char *text;
+    int num_tokens;
+    StrSpan *tokens;
 
     StatementType type;
     const char *label;
     const char *mnemonic;
-    List operands;
+    int first_operand_index;
 };
 
 
@@ -41,10 +45,15 @@ struct statement_t {
  * It checks if the line is a comment line
  *
  * @param line The line to check.
+ * @param line_len The length of the line.
  * @return true if the line is a comment line, false otherwise.
  */
-static bool isCommentLine(const char *line) {
-    return strStartsWith(line, COMMENT_PREFIX, true);
+static bool isCommentLine(const char *line, size_t line_len) {
+    size_t i = 0;
+    while (i < line_len && isspace(line[i])) {
+        i++;
+    }
+    return line_len - i >= strlen(COMMENT_PREFIX) && strncmp(line + i, COMMENT_PREFIX, strlen(COMMENT_PREFIX)) == 0;
 }
 
 /**
@@ -66,11 +75,8 @@ static bool isLabel(const char *s) {
  * @return true if the string is a directive, false otherwise.
  */
 static bool isDirective(const char *str) {
-    for (int i = 0; i < DIRECTIVES_SIZE; ++i) {
-        if (strcmp(str, DIRECTIVES[i]) == 0)
-            return true;
-    }
-    return false;
+    const Keyword *keyword = getKeyword(str);
+    return keyword && keyword->kind == KEYWORD_DIRECTIVE;
 }
 
 /**
@@ -91,137 +97,114 @@ bool isDataStoreDirective(const char *directive) {
  * @return true if the string is an instruction, false otherwise.
  */
 static bool isInstruction(const char *str) {
-    for (int i = 0; i < INSTRUCTIONS_ALL_SIZE; ++i) {
-        if (strcmp(str, INSTRUCTIONS_ALL[i]) == 0)
-            return true;
-    }
-    return false;
+    const Keyword *keyword = getKeyword(str);
+    return keyword && keyword->kind == KEYWORD_INSTRUCTION;
 }
 
 /**
- * It returns true if the string passed in is the start macro string
- *
- * @param s The string to check
+ * It parses a line of text into a Statement. The statement is allocated from the arena, and borrows the line, so the
+ * line must outlive it.
  *
- * @return true if the string is the start macro string, false otherwise.
+ * @param arena The arena to allocate the statement from.
+ * @param line The line of text to parse, which doesn't have to be null-terminated.
+ * @param line_len The length of the line, including its '\n' if it has one.
  */
-static bool isMacroStart(const char *s) {
-    return strcmp(s, START_MACRO_STR) == 0;
-}
+Statement parse(Arena arena, const char *line, size_t line_len, int line_num) {
+    if (isCommentLine(line, line_len)) {
+        return statementCreate(arena, line_num, COMMENT, line, line_len);
+    }
 
-/**
- * It returns true if the string passed to it is the string "END_MACRO"
- *
- * @param s The string to check.
- *
- * @return true if the string is the end macro string, false otherwise.
- */
-static bool isMacroEnd(const char *s) {
-    return strcmp(s, END_MACRO_STR) == 0;
-}
+    Statement s = statementCreate(arena, line_num, EMPTY_LINE, line, line_len);
 
-/**
- * It parses a line of text into a Statement.
- *
- * @param line The line of text to parse.
- */
-Statement parse(const char *line, int line_num) {
-    if (isCommentLine(line)) {
-        return statementCreate(line_num, COMMENT, line, NULL, NULL, NULL, NULL);
+    /* The line is tokenized into a small buffer first, so the statement keeps exactly as many spans as it needs, and
+     * only lines with more tokens than fit in the buffer are tokenized twice. */
+    StrSpan tokens_buf[TOKENS_BUFFER_LEN];
+    s->num_tokens = strTokenize(line, line_len, TOKENS_DELIM, tokens_buf, TOKENS_BUFFER_LEN);
+    if (s->num_tokens == 0) { // empty line
+        return s;
     }
-
-    const char *line_replaced = strReplace(line, OPERANDS_DELIM, WHITESPACE_DELIM);
-    if (!line_replaced) {
-        memoryAllocationError();
+    s->tokens = arenaAlloc(arena, s->num_tokens * sizeof(*s->tokens));
+    if (s->num_tokens <= TOKENS_BUFFER_LEN) {
+        memcpy(s->tokens, tokens_buf, s->num_tokens * sizeof(*s->tokens));
+    } else {
+        strTokenize(line, line_len, TOKENS_DELIM, s->tokens, s->num_tokens);
     }
 
-    List tokens = strSplit(line_replaced, WHITESPACE_DELIM);
-    /* Checking that the list of tokens is not empty. */
-    if (listLength(tokens) == 0) { // empty line
-        listDestroy(tokens);
-        free((char *) line_replaced);
-        return statementCreate(line_num, EMPTY_LINE, line, NULL, NULL, NULL, NULL);
+    s->text = arenaAlloc(arena, line_len + 1);
+    memcpy(s->text, line, line_len);
+    s->text[line_len] = '\0';
+    for (int i = 0; i < s->num_tokens; ++i) {
+        s->text[s->tokens[i].offset + s->tokens[i].length] = '\0';
     }
 
-    free((char *) line_replaced);
-
     int token_index = 0;
-    const char *token = listGetDataAt(tokens, token_index);
+    const char *token = statementGetTokenAt(s, token_index);
 
-    const char *label = NULL;
     if (isLabel(token)) {
-        label = strndup(token, strlen(token) - strlen(LABEL_SUFFUX));
+        s->label = arenaStrndup(arena, token, strlen(token) - strlen(LABEL_SUFFUX));
         token_index++;
-        token = listGetDataAt(tokens, token_index);
+        token = statementGetTokenAt(s, token_index);
     }
-    StatementType type;
-    if (isMacroStart(token)) { // && listLength(tokens) == 2) {
-        type = MACRO_START;
-    } else if (isMacroEnd(token)) { // && listLength(tokens) == 1) {
-        type = MACRO_END;
-    } else if (isDirective(token)) {
-        type = DIRECTIVE;
-    } else if (isInstruction(token)) {
-        type = INSTRUCTION;
+    const Keyword *keyword = token ? getKeywordOfLength(token, s->tokens[token_index].length) : NULL;
+    if (!keyword) { // not a keyword, or a label with nothing after it
+        s->type = OTHER;
+    } else if (keyword->kind == KEYWORD_MACRO_START) {
+        s->type = MACRO_START;
+    } else if (keyword->kind == KEYWORD_MACRO_END) {
+        s->type = MACRO_END;
+    } else if (keyword->kind == KEYWORD_DIRECTIVE) {
+        s->type = DIRECTIVE;
+    } else if (keyword->kind == KEYWORD_INSTRUCTION) {
+        s->type = INSTRUCTION;
     } else {
-        type = OTHER;
+        s->type = OTHER;
     }
 
-    const char *mnemonic = token;
-
-    token_index++;
-    List operands = listCopyFromIndex(tokens, token_index);
-
-    Statement s = statementCreate(line_num, type, line, label, mnemonic, operands, tokens);
-    free((char *) label);
-    listDestroy(tokens);
-    listDestroy(operands);
+    s->mnemonic = token;
+    /* A label with nothing after it has no mnemonic, and no operands either. */
+    s->first_operand_index = token ? token_index + 1 : s->num_tokens;
 
     return s;
 }
 
 /**
- * It creates a statement.
+ * It creates a statement with no tokens in the arena. The statement borrows the raw text.
  *
+ * @param arena The arena to allocate the statement from.
+ * @param line_num The line number of the statement.
  * @param type The type of statement.
- * @param raw_text The raw text of the statement.
- * @param label The label of the statement, if any.
- * @param mnemonic The mnemonic of the instruction.
- * @param operands A list of operands. Each operand is a list of tokens.
- * @param tokens A list of tokens that make up the statement.
+ * @param raw_text The raw text of the statement, which doesn't have to be null-terminated.
+ * @param raw_len The length of the raw text.
  */
-Statement
-statementCreate(int line_num, StatementType type, const char *raw_text, const char *label, const char *mnemonic,
-                List operands,
-                List tokens) {
-    Statement s = (Statement) malloc(sizeof(*s));
-    if (!s)
-        memoryAllocationError();
+Statement statementCreate(Arena arena, int line_num, StatementType type, const char *raw_text, size_t raw_len) {
+    Statement s = (Statement) arenaAlloc(arena, sizeof(*s));
 
     s->line_num = line_num;
     s->type = type;
-    s->raw_text = strdup(raw_text);
-    s->label = strdup(label);
-    s->mnemonic = strdup(mnemonic);
+    s->raw_text = raw_text;
+    s->raw_len = raw_len;
+    s->label = NULL;
+    s->mnemonic = NULL;
 
-    s->operands = listCopy(operands);
-    s->tokens = listCopy(tokens);
+    s->text = NULL;
+    s->num_tokens = 0;
+    s->tokens = NULL;
+    s->first_operand_index = 0;
 
     return s;
 }
 
 /**
- * It destroys the statement.
+ * It copies the statement into the arena. The copy shares the tokens of the statement, so a statement that is
+ * repeated, like a line of a macro body, is parsed only once and every repetition only gets its own line number.
  *
- * @param s The statement to destroy.
+ * @param arena The arena to allocate the copy from.
+ * @param s The statement to copy.
  */
-void statementDestroy(Statement s) {
-    free((char *) s->raw_text);
-    free((char *) s->label);
-    free((char *) s->mnemonic);
-    listDestroy(s->operands);
-    listDestroy(s->tokens);
-    free(s);
+Statement statementCopy(Arena arena, Statement s) {
+    Statement copy = (Statement) arenaAlloc(arena, sizeof(*copy));
+    *copy = *s;
+    return copy;
 }
 
 /**
@@ -233,6 +216,16 @@ int statementGetLineNum(Statement s) {
     return s->line_num;
 }
 
+/**
+ * It sets the line number of the statement.
+ *
+ * @param s The statement to set the line number of.
+ * @param line_num The new line number.
+ */
+void statementSetLineNum(Statement s, int line_num) {
+    s->line_num = line_num;
+}
+
 /**
  * It returns the type of the statement.
  *
@@ -243,12 +236,12 @@ StatementType statementGetType(Statement s) {
 }
 
 /**
- * It returns the raw text of the statement.
+ * It returns the length of the line of the statement, not counting its '\n'.
  *
  * @param s The statement object
  */
-const char *statementGetRawText(Statement s) {
-    return s->raw_text;
+size_t statementGetLineLength(Statement s) {
+    return s->raw_len > 0 && s->raw_text[s->raw_len - 1] == '\n' ? s->raw_len - 1 : s->raw_len;
 }
 
 /**
@@ -270,21 +263,62 @@ const char *statementGetMnemonic(Statement s) {
 }
 
 /**
- * It returns the operands of the statement.
+ * It returns the number of tokens in the statement.
+ *
+ * @param s The statement to get the number of tokens of.
+ */
+int statementGetTokensCount(Statement s) {
+    return s->num_tokens;
+}
+
+/**
+ * It returns the span of a token in the raw text of the statement.
+ *
+ * @param s The statement to get the token from.
+ * @param index The index of the token, between 0 and statementGetTokensCount() - 1.
+ */
+StrSpan statementGetTokenSpanAt(Statement s, int index) {
+    assert(index >= 0 && index < s->num_tokens);
+    return s->tokens[index];
+}
+
+/**
+ * It returns a token of the statement.
  *
- * @param s The statement to get the operands of.
+ * @param s The statement to get the token from.
+ * @param index The index of the token.
+ *
+ * @return The token, or NULL if the index is out of range.
  */
-const List statementGetOperands(Statement s) {
-    return s->operands;
+const char *statementGetTokenAt(Statement s, int index) {
+    if (index < 0 || index >= s->num_tokens)
+        return NULL;
+    return s->text + s->tokens[index].offset;
 }
 
 /**
- * It returns the list of tokens in the statement.
+ * It returns the number of operands of the statement.
  *
- * @param s The statement to get the tokens from.
+ * @param s The statement to get the number of operands of.
  */
-const List statementGetTokens(Statement s) {
-    return s->tokens;
+int statementGetOperandsCount(Statement s) {
+    if (s->num_tokens == 0)
+        return 0;
+    return s->num_tokens - s->first_operand_index;
+}
+
+/**
+ * It returns an operand of the statement.
+ *
+ * @param s The statement to get the operand from.
+ * @param index The index of the operand.
+ *
+ * @return The operand, or NULL if the index is out of range.
+ */
+const char *statementGetOperandAt(Statement s, int index) {
+    if (index < 0 || index >= statementGetOperandsCount(s))
+        return NULL;
+    return statementGetTokenAt(s, s->first_operand_index + index);
 }
 
 /**
@@ -292,36 +326,41 @@ const List statementGetTokens(Statement s) {
  *
  * @param s The statement to check.
  */
-static bool labelCheckSyntax(Statement s, const char *filename, const char *filename_suffix) {
+static bool labelCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags) {
     assert(s->label != NULL);
 
     if (strlen(s->label) > LABEL_MAX_LENGTH) {
-        printf("Error in %s.%s line %d: Label is too long\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s.%s line %d: Label is too long", filename, filename_suffix,
+                s->line_num);
         return false;
     }
     if (!isalpha(s->label[0])) {
-        printf("Error in %s.%s line %d: Label must start with a letter\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s.%s line %d: Label must start with a letter", filename,
+                filename_suffix, s->line_num);
         return false;
     }
-    for (int i = 1; i < strlen(s->label); i++) {
+    for (size_t i = 1; i < strlen(s->label); i++) {
         if (!isalnum(s->label[i])) {
-            printf("Error in %s.%s line %d: Label must contain only letters and digits\n", filename, filename_suffix,
-                   s->line_num);
+            diagnosticsReport(diags, s->line_num, "Error in %s.%s line %d: Label must contain only letters and digits",
+                    filename, filename_suffix, s->line_num);
             return false;
         }
     }
     if (s->type != DIRECTIVE && s->type != INSTRUCTION) {
-        printf("Error in %s.%s line %d: Label can only be used with directives and instructions\n", filename,
-               filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num,
+                "Error in %s.%s line %d: Label can only be used with directives and instructions", filename,
+                filename_suffix, s->line_num);
         return false;
     }
     if (s->type == DIRECTIVE && !isDataStoreDirective(s->mnemonic)) {
-        printf("Error in %s.%s line %d: Label can only be used with directives data, struct and string\n", filename,
-               filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num,
+                "Error in %s.%s line %d: Label can only be used with directives data, struct and string", filename,
+                filename_suffix, s->line_num);
         return false;
     }
     if (isReservedWord(s->label)) {
-        printf("Error in %s.%s line %d: Label can not be a reserved word\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s.%s line %d: Label can not be a reserved word", filename,
+                filename_suffix, s->line_num);
         return false;
     }
     return true;
@@ -332,36 +371,42 @@ static bool labelCheckSyntax(Statement s, const char *filename, const char *file
  *
  * @param s The statement to check.
  */
-static bool macroCheckSyntax(Statement s, const char *filename, const char *filename_suffix) {
+static bool macroCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags) {
     assert(s->type == MACRO_START);
 
     if (s->label != NULL) {
-        printf("Error in %s%s line %d: Macro can not have a label\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Macro can not have a label", filename,
+                filename_suffix, s->line_num);
         return false;
     }
-    if (listLength(s->operands) != 1) {
-        printf("Error in %s%s line %d: Macro start statement must have exactly one argument\n", filename,
-               filename_suffix, s->line_num);
+    if (statementGetOperandsCount(s) != 1) {
+        diagnosticsReport(diags, s->line_num,
+                "Error in %s%s line %d: Macro start statement must have exactly one argument", filename,
+                filename_suffix, s->line_num);
         return false;
     }
-    const char *macro_name = listGetDataAt(s->operands, 0);
+    const char *macro_name = statementGetOperandAt(s, 0);
     if (isDirective(macro_name) || isInstruction(macro_name)) {
-        printf("Error in %s%s line %d: Macro name can't be an instruction or a directive!\n", filename, filename_suffix,
-               s->line_num);
+        diagnosticsReport(diags, s->line_num,
+                "Error in %s%s line %d: Macro name can't be an instruction or a directive!", filename, filename_suffix,
+                s->line_num);
         return false;
     }
     if (strlen(macro_name) > LABEL_MAX_LENGTH) {
-        printf("Error in %s%s line %d: Macro name is too long\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Macro name is too long", filename,
+                filename_suffix, s->line_num);
         return false;
     }
     if (!isalpha(macro_name[0])) {
-        printf("Error in %s%s line %d: Macro name must start with a letter\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Macro name must start with a letter", filename,
+                filename_suffix, s->line_num);
         return false;
     }
-    for (int i = 1; i < strlen(macro_name); i++) {
+    for (size_t i = 1; i < strlen(macro_name); i++) {
         if (!isalnum(macro_name[i])) {
-            printf("Error in %s%s line %d: Macro name must contain only letters and digits\n", filename,
-                   filename_suffix, s->line_num);
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Macro name must contain only letters and digits", filename, filename_suffix,
+                    s->line_num);
             return false;
         }
     }
@@ -374,62 +419,69 @@ static bool macroCheckSyntax(Statement s, const char *filename, const char *file
  * @param s The statement that is being checked.
  * @param filename the name of the file being parsed
  * @param filename_suffix The suffix of the file name. For example, if the file name is "test.c", the suffix is "c".
+ * @param diags The diagnostics to report the errors to.
  */
-static bool directiveCheckSyntax(Statement s, const char *filename, const char *filename_suffix) {
-    if (listLength(s->operands) == 0) {
-        printf("Error in %s%s line %d: Directive must have at least one argument\n", filename, filename_suffix,
-               s->line_num);
+static bool directiveCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags) {
+    if (statementGetOperandsCount(s) == 0) {
+        diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Directive must have at least one argument",
+                filename, filename_suffix, s->line_num);
         return false;
     }
     if (strcmp(s->mnemonic, DIRECTIVE_DATA) == 0) {
-        for (int i = 0; i < listLength(s->operands); i++) {
-            const char *operand = listGetDataAt(s->operands, i);
+        for (int i = 0; i < statementGetOperandsCount(s); i++) {
+            const char *operand = statementGetOperandAt(s, i);
             if (!isNumeric(operand)) {
-                printf("Error in %s%s line %d: Directive .data must be numeric\n", filename, filename_suffix,
-                       s->line_num);
+                diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Directive .data must be numeric",
+                        filename, filename_suffix, s->line_num);
                 return false;
             }
         }
     } else if (strcmp(s->mnemonic, DIRECTIVE_STRING) == 0) {
-        if (listLength(s->operands) != 1) {
-            printf("Error in %s%s line %d: Directive .string must have exactly one argument\n", filename,
-                   filename_suffix, s->line_num);
+        if (statementGetOperandsCount(s) != 1) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Directive .string must have exactly one argument", filename,
+                    filename_suffix, s->line_num);
             return false;
         }
-        const char *operand = listGetDataAt(s->operands, 0);
+        const char *operand = statementGetOperandAt(s, 0);
         if (!isString(operand)) {
-            printf("Error in %s%s line %d: Directive .string operand must be a string\n", filename, filename_suffix,
-                   s->line_num);
+            diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Directive .string operand must be a string",
+                    filename, filename_suffix, s->line_num);
             return false;
         }
     } else if (strcmp(s->mnemonic, DIRECTIVE_STRUCT) == 0) {
-        if (listLength(s->operands) != 2) {
-            printf("Error in %s%s line %d: Directive .struct must have exactly two arguments\n", filename,
-                   filename_suffix, s->line_num);
+        if (statementGetOperandsCount(s) != 2) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Directive .struct must have exactly two arguments", filename,
+                    filename_suffix, s->line_num);
             return false;
         }
         bool res = true;
-        if (!isNumeric(listGetDataAt(s->operands, 0))) {
-            printf("Error in %s%s line %d: Directive .struct first argument must be numeric\n", filename,
-                   filename_suffix, s->line_num);
+        if (!isNumeric(statementGetOperandAt(s, 0))) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Directive .struct first argument must be numeric", filename,
+                    filename_suffix, s->line_num);
             res = false;
         }
-        if (!isString(listGetDataAt(s->operands, 1))) {
-            printf("Error in %s%s line %d: Directive .struct second argument must be a string\n", filename,
-                   filename_suffix, s->line_num);
+        if (!isString(statementGetOperandAt(s, 1))) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Directive .struct second argument must be a string", filename,
+                    filename_suffix, s->line_num);
             res = false;
         }
         return res;
     } else if (strcmp(s->mnemonic, DIRECTIVE_ENTRY) == 0) {
-        if (listLength(s->operands) != 1) {
-            printf("Error in %s%s line %d: Directive .entry must have exactly one argument\n", filename,
-                   filename_suffix, s->line_num);
+        if (statementGetOperandsCount(s) != 1) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Directive .entry must have exactly one argument", filename, filename_suffix,
+                    s->line_num);
             return false;
         }
     } else if (strcmp(s->mnemonic, DIRECTIVE_EXTERN) == 0) {
-        if (listLength(s->operands) != 1) {
-            printf("Error in %s%s line %d: Directive .extern must have exactly one argument\n", filename,
-                   filename_suffix, s->line_num);
+        if (statementGetOperandsCount(s) != 1) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Directive .extern must have exactly one argument", filename,
+                    filename_suffix, s->line_num);
             return false;
         }
     }
@@ -442,48 +494,49 @@ static bool directiveCheckSyntax(Statement s, const char *filename, const char *
  * @param s The statement to check.
  * @param filename The name of the file that the statement is in.
  * @param filename_suffix The suffix of the file that is being checked.
+ * @param diags The diagnostics to report the errors to.
  */
-static bool instructionCheckSyntax(Statement s, const char *filename, const char *filename_suffix) {
-    if (is0OperandInstruction(s->mnemonic) && listLength(s->operands) != 0) {
-        printf("Error in %s%s line %d: Instruction %s must have no operands\n", filename, filename_suffix, s->line_num,
-               s->mnemonic);
-        return false;
-    } else if (is1OperandInstruction(s->mnemonic) && listLength(s->operands) != 1) {
-        printf("Error in %s%s line %d: Instruction %s must have exactly one operand\n", filename, filename_suffix,
-               s->line_num, s->mnemonic);
-        return false;
-    } else if (is2OperandInstruction(s->mnemonic) && listLength(s->operands) != 2) {
-        printf("Error in %s%s line %d: Instruction %s must have exactly two operands\n", filename, filename_suffix,
-               s->line_num, s->mnemonic);
+static bool instructionCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags) {
+    const Instruction *instruction = getInstruction(s->mnemonic);
+    int num_operands = statementGetOperandsCount(s);
+
+    if (num_operands != instruction->num_operands) {
+        if (instruction->num_operands == 0) {
+            diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Instruction %s must have no operands",
+                    filename, filename_suffix, s->line_num, s->mnemonic);
+        } else if (instruction->num_operands == 1) {
+            diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Instruction %s must have exactly one operand",
+                    filename, filename_suffix, s->line_num, s->mnemonic);
+        } else {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: Instruction %s must have exactly two operands", filename, filename_suffix,
+                    s->line_num, s->mnemonic);
+        }
         return false;
     }
-    int num_operands = listLength(s->operands);
+    AddressingMode modes[2];
     for (int i = 0; i < num_operands; i++) {
-        const char *operand = listGetDataAt(s->operands, i);
-        AddressingMode mode = getAddressingMode(operand);
-        if (mode == INVALID_ADDRESSING) {
-            printf("Error in %s%s line %d: operand %s is not a valid operand\n", filename, filename_suffix, s->line_num,
-                   operand);
+        const char *operand = statementGetOperandAt(s, i);
+        modes[i] = getAddressingMode(operand);
+        if (modes[i] == INVALID_ADDRESSING) {
+            diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: operand %s is not a valid operand", filename,
+                    filename_suffix, s->line_num, operand);
             return false;
         }
     }
     if (num_operands == 1) {
-        const char *operand = listGetDataAt(s->operands, 0);
-        AddressingMode mode = getAddressingMode(operand);
-        if (!isValidAddressing_1_OP(s->mnemonic, mode)) {
-            printf("Error in %s%s line %d: invalid addressing for operand %s and instruction %s\n", filename,
-                   filename_suffix, s->line_num, operand, s->mnemonic);
+        if (!isValidDstAddressing(instruction, modes[0])) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: invalid addressing for operand %s and instruction %s", filename,
+                    filename_suffix, s->line_num, statementGetOperandAt(s, 0), s->mnemonic);
             return false;
         }
     } else if (num_operands == 2) {
-        const char *operand_src = listGetDataAt(s->operands, 0);
-        const char *operand_dest = listGetDataAt(s->operands, 1);
-        AddressingMode mode_src = getAddressingMode(operand_src);
-        AddressingMode mode_dest = getAddressingMode(operand_dest);
-
-        if (!isValidAddressing_2_OP(s->mnemonic, mode_src, mode_dest)) {
-            printf("Error in %s%s line %d: invalid addressing for operands %s and %s and instruction %s\n", filename,
-                   filename_suffix, s->line_num, operand_src, operand_dest, s->mnemonic);
+        if (!isValidSrcAddressing(instruction, modes[0]) || !isValidDstAddressing(instruction, modes[1])) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: invalid addressing for operands %s and %s and instruction %s", filename,
+                    filename_suffix, s->line_num, statementGetOperandAt(s, 0), statementGetOperandAt(s, 1),
+                    s->mnemonic);
             return false;
         }
     }
@@ -496,38 +549,32 @@ static bool instructionCheckSyntax(Statement s, const char *filename, const char
  * @param s The statement to check.
  * @param filename the name of the file being parsed
  * @param filename_suffix The suffix of the file name.
+ * @param diags The diagnostics to report the errors to.
  */
-static bool delimiterCheckSyntax(Statement s, const char *filename, const char *filename_suffix) {
-    if (listLength(s->operands) == 0) {
-        if (strCountChar(s->raw_text, OPERANDS_DELIM_CHAR) > 0) {
-            printf("Error in %s%s line %d: number of operands does not match number of delimiters\n", filename,
-                   filename_suffix,
-                   s->line_num);
+static bool delimiterCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags) {
+    int num_operands = statementGetOperandsCount(s);
+    if (num_operands == 0) {
+        if (strCountChar(s->raw_text, s->raw_len, OPERANDS_DELIM_CHAR) > 0) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: number of operands does not match number of delimiters", filename,
+                    filename_suffix, s->line_num);
             return false;
         }
     } else {
-        if (strCountChar(s->raw_text, OPERANDS_DELIM_CHAR) != listLength(s->operands) - 1) {
-            printf("Error in %s%s line %d: number of operands does not match number of delimiters\n", filename,
-                   filename_suffix,
-                   s->line_num);
+        if (strCountChar(s->raw_text, s->raw_len, OPERANDS_DELIM_CHAR) != num_operands - 1) {
+            diagnosticsReport(diags, s->line_num,
+                    "Error in %s%s line %d: number of operands does not match number of delimiters", filename,
+                    filename_suffix, s->line_num);
             return false;
         }
-        const char *with_mnemonic;
-        if (s->label) {
-            with_mnemonic = strReplace(s->raw_text, s->label, WHITESPACE_DELIM);
-        } else {
-            with_mnemonic = s->raw_text;
-        }
-        const char *only_operands = strReplace(with_mnemonic, s->mnemonic, WHITESPACE_DELIM);
-        List seperated_by_delim = strSplit(only_operands, OPERANDS_DELIM);
-        if (listLength(seperated_by_delim) != listLength(s->operands)) {
-            printf("Error in %s%s line %d: misplaced delimiters\n", filename, filename_suffix,
-                   s->line_num);
-            return false;
+        /* The label and the mnemonic have no delimiters in them, so the line splits by the delimiters into one part
+         * per operand, unless a delimiter is doubled or at the very start or end of the line. */
+        bool valid = strTokenize(s->raw_text, s->raw_len, OPERANDS_DELIM, NULL, 0) == (size_t) num_operands;
+        if (!valid) {
+            diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: misplaced delimiters", filename,
+                    filename_suffix, s->line_num);
         }
-        free((void *) with_mnemonic);
-        free((void *) only_operands);
-        listDestroy(seperated_by_delim);
+        return valid;
     }
     return true;
 }
@@ -538,14 +585,16 @@ static bool delimiterCheckSyntax(Statement s, const char *filename, const char *
  * @param s The statement to check.
  * @param filename the name of the file being checked
  * @param filename_suffix The suffix of the file name. For example, if the file name is "test.c", the suffix is ".c".
+ * @param diags The diagnostics to report the errors to.
  */
-bool statementCheckSyntax(Statement s, const char *filename, const char *filename_suffix) {
+bool statementCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags) {
     if (!s) {
         return false;
     }
 
     if (s->type == OTHER) {
-        printf("Error in %s%s line %d: Undefined/Invalid statement\n", filename, filename_suffix, s->line_num);
+        diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Undefined/Invalid statement", filename,
+                filename_suffix, s->line_num);
         return false;
     }
     if (s->type == COMMENT || s->type == EMPTY_LINE) {
@@ -553,23 +602,23 @@ bool statementCheckSyntax(Statement s, const char *filename, const char *filenam
     }
 
     if (s->type == MACRO_START) {
-        return macroCheckSyntax(s, filename, filename_suffix);
+        return macroCheckSyntax(s, filename, filename_suffix, diags);
     } else if (s->type == MACRO_END) {
-        if (listLength(s->operands) != 0) {
-            printf("Error in %s%s line %d: Macro end statement must have no arguments\n", filename, filename_suffix,
-                   s->line_num);
+        if (statementGetOperandsCount(s) != 0) {
+            diagnosticsReport(diags, s->line_num, "Error in %s%s line %d: Macro end statement must have no arguments",
+                    filename, filename_suffix, s->line_num);
             return false;
         }
         return true;
     } else {  // directive or instruction
-        bool valid = delimiterCheckSyntax(s, filename, filename_suffix);
+        bool valid = delimiterCheckSyntax(s, filename, filename_suffix, diags);
         if (s->label) {
-            valid = valid && labelCheckSyntax(s, filename, filename_suffix);
+            valid = valid && labelCheckSyntax(s, filename, filename_suffix, diags);
         }
         if (s->type == DIRECTIVE) {
-            valid = valid && directiveCheckSyntax(s, filename, filename_suffix);
+            valid = valid && directiveCheckSyntax(s, filename, filename_suffix, diags);
         } else { // instruction
-            valid = valid && instructionCheckSyntax(s, filename, filename_suffix);
+            valid = valid && instructionCheckSyntax(s, filename, filename_suffix, diags);
         }
         return valid;
     }
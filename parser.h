@@ -5,9 +5,12 @@
 #ifndef ASSEMBLER_PARSER_H
 #define ASSEMBLER_PARSER_H
 
+#include <stdio.h>
 #include <stdbool.h>
 
-#include "linkedlist.h"
+#include "arena.h"
+#include "str_utils.h"
+#include "diagnostics.h"
 
 
 typedef enum {
@@ -16,30 +19,36 @@ typedef enum {
 
 typedef struct statement_t *Statement;
 
-Statement parse(const char *line, int line_num);
+Statement parse(Arena arena, const char *line, size_t line_len, int line_num);
 
-Statement
-statementCreate(int line_num, StatementType type, const char *raw_text, const char *label, const char *mnemonic, List operands,
-                List tokens);
+Statement statementCreate(Arena arena, int line_num, StatementType type, const char *raw_text, size_t raw_len);
 
-void statementDestroy(Statement s);
+Statement statementCopy(Arena arena, Statement s);
 
 StatementType statementGetType(Statement s);
 
-const char *statementGetRawText(Statement s);
+size_t statementGetLineLength(Statement s);
 
 const char *statementGetLabel(Statement s);
 
 const char *statementGetMnemonic(Statement s);
 
-const List statementGetOperands(Statement s);
+int statementGetTokensCount(Statement s);
 
-const List statementGetTokens(Statement s);
+StrSpan statementGetTokenSpanAt(Statement s, int index);
 
-bool statementCheckSyntax(Statement s, const char *filename, const char *filename_suffix);
+const char *statementGetTokenAt(Statement s, int index);
+
+int statementGetOperandsCount(Statement s);
+
+const char *statementGetOperandAt(Statement s, int index);
+
+bool statementCheckSyntax(Statement s, const char *filename, const char *filename_suffix, Diagnostics diags);
 
 int statementGetLineNum(Statement s);
 
+void statementSetLineNum(Statement s, int line_num);
+
 bool isDataStoreDirective(const char *directive);
 
 
@@ -1,138 +1,172 @@
 //
 // Created by misha on 27/07/2022.
 //
-#define _GNU_SOURCE
 
-#include <stdio.h>
-#include <malloc.h>
 #include <string.h>
 
 #include "pre_assembly.h"
-#include "linkedlist.h"
+#include "vector.h"
 #include "errors.h"
 #include "macro.h"
 #include "parser.h"
-#include "file_utils.h"
+#include "arena.h"
+#include "source_file.h"
+#include "str_utils.h"
 
 
 #define SOURCE_FILE_SUFFIX ".as"
-#define VERY_LARGE_BUFFER_LEN 2048
 
 /**
- * It takes a source file and a destination file and copies the source file to the destination file, but it also replaces
- * any macros with their definitions.
+ * It appends the statements of a macro body to the statements of the .am file. The body was parsed when the macro was
+ * defined, so every invocation only copies its statements, numbered by the line of the invocation in the source file -
+ * the line an error in them is reported on.
  *
- * @param src_file The file to read from.
- * @param dst_file The file to write the output to.
- * @param filename The name of the source file.
+ * @param arena The arena to allocate the statements from.
+ * @param statements The statements of the .am file.
+ * @param macro The macro to expand.
+ * @param line_num The line number of the invocation.
+ */
+static void appendMacroBody(Arena arena, Vector statements, Macro macro, int line_num) {
+    for (int i = 0; i < macroGetStatementsCount(macro); ++i) {
+        Statement s = statementCopy(arena, macroGetStatementAt(macro, i));
+        statementSetLineNum(s, line_num);
+        vectorAppendMove(statements, s);
+    }
+}
+
+/**
+ * It takes a source file and copies it to the .am text, but it also replaces any macros with their definitions. The
+ * lines of the .am text are also parsed into statements, numbered by their line in the source file, which is all the
+ * passes need - so the .am text itself is optional.
+ *
+ * @param src_file The source file to read from.
+ * @param am The buffer to append the .am text to, or NULL to only expand the macros into the statements.
+ * @param ctx The assembly context of the source file.
+ * @param statements The vector to append the statements of the destination file to.
+ * @param index The index to record what each line became in, or NULL.
  *
  * @return true if the operation was successful, false otherwise.
  */
-bool unfold_macros(FILE *src_file, FILE *dst_file, const char *filename) {
-    List macros = listCreate((list_eq) macroCmp, (list_copy) macroCopy, (list_free) macroDestroy);
+bool unfold_macros(SourceFile src_file, StrBuffer *am, AssemblyContext ctx, Vector statements,
+                   IncrementalIndex index) {
+    const char *filename = assemblyContextGetFilename(ctx);
+    Diagnostics diags = assemblyContextGetDiagnostics(ctx);
+    Arena arena = assemblyContextGetArena(ctx);
+    InternPool names = assemblyContextGetInternPool(ctx);
+
+    /* The macros live in the arena, the table only borrows them. */
+    MacroTable macros = macroTableCreate();
+    Vector macro_statements = vectorCreate(NULL);
 
     bool success = true;
 
     bool is_macro = false;
-    const char *macro_name;
-    char *macro_body = NULL;
-    int macro_def_line_num;
+    int macro_name_id = INTERN_POOL_NOT_FOUND;
+    /* The text of the body of the macro being defined, a view into the source - only needed for the .am text. */
+    const char *macro_body = NULL;
+    size_t macro_body_len = 0;
+    int macro_def_line_num = 0;
 
     int line_num = 0;
-    char line[VERY_LARGE_BUFFER_LEN]; // we want to be able to copy the lines as is at this stage
-    while (fgets(line, VERY_LARGE_BUFFER_LEN, src_file) != NULL) {
-        /* It's parsing the line. */
+    while (line_num < sourceFileGetLinesCount(src_file)) {
+        /* It's parsing the line, in place in the source file. Lines outside a macro definition are mostly kept as
+         * statements, and macro body lines are kept as the parsed body of the macro. */
+        size_t line_len;
+        const char *line = sourceFileGetLine(src_file, line_num, &line_len);
         line_num++;
-        Statement s = parse(line, line_num);
-        if (!s) { // Parsing failed.
-            continue;
-        }
-
-        if (statementGetType(s) == MACRO_START) {
+        int first_statement = vectorLength(statements);
+        size_t am_offset = am ? am->length : 0;
+        bool is_statement = false;
+        Statement s = parse(arena, line, line_len, line_num);
+        if (!s) { // Parsing failed - the line is left out.
+        } else if (statementGetType(s) == MACRO_START) {
             is_macro = true;
-            macro_name = strdup(listGetDataAt(statementGetOperands(s), 0));
-            success = success && statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX);
+            const char *macro_name = statementGetOperandAt(s, 0);
+            if (!macro_name) { // the body is still skipped up to the endmacro, but no macro is defined
+                diagnosticsReport(diags, line_num, "Error in %s%s line %d: Missing macro name", filename,
+                                  SOURCE_FILE_SUFFIX, line_num);
+                success = false;
+            } else {
+                macro_name_id = internPoolIntern(names, macro_name, strlen(macro_name));
+                success = success && statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX, diags);
+            }
             macro_def_line_num = line_num;
 
         } else if (statementGetType(s) == MACRO_END) {
-            success = success && statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX);
-            Macro m = macroCreate(macro_name, macro_body, macro_def_line_num);
-
-            Macro found_macro;
-            ListResult res = listFind(macros, m, (void **) &found_macro);
-
-            if (res == LIST_NOT_FOUND) {  // macro not found
-                listAppend(macros, m);
-            } else { // found macro
-                printf("Error in %s.%s line %d: Macro %s on was already previously defined on line %d\n",
-                       filename, SOURCE_FILE_SUFFIX, macro_def_line_num, macro_name, macroGetDefLineNum(found_macro));
-                success = false;
-//                macroDestroy(found_macro);
+            success = success && statementCheckSyntax(s, filename, SOURCE_FILE_SUFFIX, diags);
+
+            if (is_macro && macro_name_id != INTERN_POOL_NOT_FOUND) { // nothing to define without a macro or a name
+                Macro macro = macroCreate(arena, names, macro_name_id, macro_body, macro_body_len, macro_statements,
+                                          macro_def_line_num);
+                Macro found_macro = macroTableInsert(macros, macro);
+                if (found_macro) { // already defined
+                    diagnosticsReport(diags, macro_def_line_num,
+                            "Error in %s.%s line %d: Macro %s on was already previously defined on line %d", filename,
+                            SOURCE_FILE_SUFFIX, macro_def_line_num, macroGetName(macro),
+                            macroGetDefLineNum(found_macro));
+                    success = false;
+                } else if (index) {
+                    incrementalIndexAddMacro(index, macro_name_id);
+                }
             }
 
-            macroDestroy(m);
-
             is_macro = false;
-            free((void *) macro_name);
-            free(macro_body);
+            macro_name_id = INTERN_POOL_NOT_FOUND;
             macro_body = NULL;
+            macro_body_len = 0;
+            vectorClear(macro_statements);
 
         } else if (is_macro) { // inside macro - append to macro body
-            char *tmp = macro_body;
-
-            if (!macro_body) {
-                /* It's appending the line to the macro body. */
-                if (asprintf(&macro_body, "%s", line) == -1)
-                    memoryAllocationError();
-            } else {
-                /* It's appending the line to the macro body. */
-                if (asprintf(&macro_body, "%s%s", macro_body, line) == -1)
-                    memoryAllocationError();
-                free(tmp);
+            if (am) { // the lines of the source are contiguous, so the body is the span of its lines
+                if (!macro_body)
+                    macro_body = line;
+                macro_body_len = (size_t) (line - macro_body) + line_len;
             }
+            vectorAppendMove(macro_statements, s);
 
         } else { // outside macro definition, check if referencing macro that needs unfolding
-            if (statementGetType(s) == COMMENT || statementGetType(s) == EMPTY_LINE) {
-                fputs(line, dst_file);
-                statementDestroy(s);
-                continue;
+            Macro found_macro = NULL;
+            if (statementGetType(s) != COMMENT && statementGetType(s) != EMPTY_LINE) {
+                /* A name that was never interned can't be a macro, so the lookup doesn't add it to the pool. */
+                found_macro = macroTableFind(macros, internPoolFind(names, statementGetTokenAt(s, 0),
+                                                                    statementGetTokenSpanAt(s, 0).length));
             }
-            const char *first_word = listGetDataAt(statementGetTokens(s), 0);
-
-            /* It's creating a dummy macro with the name of the first word in the line. */
-            Macro dummy = macroCreate(first_word, NULL, -1);
-            Macro found_macro;
-            ListResult res = listFind(macros, dummy, (void **) &found_macro);
-            macroDestroy(dummy);
-
-            if (res == LIST_SUCCESS) { // found macro
-                fputs(macroGetBody(found_macro), dst_file);
-//                macroDestroy(found_macro);
+            if (found_macro) { // found macro
+                size_t body_len;
+                const char *body = macroGetBody(found_macro, &body_len);
+                if (am && body)
+                    strBufferAppend(am, body, body_len);
+                appendMacroBody(arena, statements, found_macro, line_num);
             } else {
-                fputs(line, dst_file);
+                if (am)
+                    strBufferAppend(am, line, line_len);
+                vectorAppendMove(statements, s);
+                is_statement = true;
             }
         }
-        statementDestroy(s);
+        if (index)
+            incrementalIndexAddLine(index, line_len, is_statement, is_macro, first_statement, am_offset);
     }
-    listDestroy(macros);
+    if (index)
+        incrementalIndexEndLines(index, vectorLength(statements), am ? am->length : 0);
+    macroTableDestroy(macros);
+    vectorDestroy(macro_statements);
 
     return success;
 }
 
 /**
- * It runs the pre-assembly step of the pipeline.
+ * It runs the pre-assembly step of the pipeline on the source file of the context. The .am text is only kept if the
+ * keep_am option is set.
  *
- * @param filename The name of the file to be assembled.
+ * @param ctx The assembly context of the file to be assembled.
+ * @param am The buffer to append the .am text to.
+ * @param statements_ptr Set to the statements of the .am file, which the vector borrows from the arena.
+ * @param index The index to record what each line of the source became in, or NULL.
  * @return Whether the pre-assembly step was successful.
  */
-bool run_pre_assembly(const char *filename) {
-    FILE *src_file = openFileWithSuffix(filename, "r", SOURCE_FILE_SUFFIX);
-    FILE *dst_file = openFileWithSuffix(filename, "w", AFTER_MACRO_SUFFIX);
-
-    bool res = unfold_macros(src_file, dst_file, filename);
-
-    fclose(src_file);
-    fclose(dst_file);
-
-    return res;
+bool run_pre_assembly(AssemblyContext ctx, StrBuffer *am, Vector *statements_ptr, IncrementalIndex index) {
+    *statements_ptr = vectorCreate(NULL);
+    return unfold_macros(assemblyContextGetSourceFile(ctx), assemblyContextGetOptions(ctx)->keep_am ? am : NULL, ctx,
+                         *statements_ptr, index);
 }
@@ -6,9 +6,11 @@
 #define ASSEMBLER_PRE_ASSEMBLY_H
 
 #include <stdbool.h>
+#include "assembly_context.h"
+#include "vector.h"
+#include "str_utils.h"
+#include "incremental.h"
 
-#define AFTER_MACRO_SUFFIX ".am"
-
-bool run_pre_assembly(const char *filename);
+bool run_pre_assembly(AssemblyContext ctx, StrBuffer *am, Vector *statements_ptr, IncrementalIndex index);
 
 #endif //ASSEMBLER_PRE_ASSEMBLY_H
@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "protocol.h"
+
+#define HEADER_WORDS 3
+
+
+/**
+ * It fills the address of the server's socket.
+ *
+ * @param socket_path The path of the socket.
+ * @param addr Set to the address.
+ *
+ * @return false if the path is too long for a socket address, true otherwise.
+ */
+bool protocolSocketAddress(const char *socket_path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr->sun_path))
+        return false;
+
+    strcpy(addr->sun_path, socket_path);
+    return true;
+}
+
+/**
+ * It returns the flags of a request for the options to assemble a file with.
+ *
+ * @param options The options.
+ */
+uint32_t protocolOptionsToFlags(const FileAssemblyOptions *options) {
+    return (options->assembly.keep_am ? REQUEST_FLAG_KEEP_AM : 0) |
+           (options->arena_stats ? REQUEST_FLAG_ARENA_STATS : 0) |
+           (options->incremental ? REQUEST_FLAG_INCREMENTAL : 0);
+}
+
+/**
+ * It returns the options to assemble a file with, by the flags of a request.
+ *
+ * @param flags The flags of the request.
+ */
+FileAssemblyOptions protocolFlagsToOptions(uint32_t flags) {
+    FileAssemblyOptions options = {{false}, false, NULL, false};
+    options.assembly.keep_am = (flags & REQUEST_FLAG_KEEP_AM) != 0;
+    options.arena_stats = (flags & REQUEST_FLAG_ARENA_STATS) != 0;
+    options.incremental = (flags & REQUEST_FLAG_INCREMENTAL) != 0;
+    return options;
+}
+
+/**
+ * It initializes a message to send, without blobs.
+ *
+ * @param m The message.
+ * @param type The type of the message.
+ * @param flags The flags of the message.
+ */
+void protocolMessageInit(Message *m, uint32_t type, uint32_t flags) {
+    memset(m, 0, sizeof(*m));
+    m->type = type;
+    m->flags = flags;
+}
+
+/**
+ * It adds a blob to a message to send. The message only borrows it.
+ *
+ * @param m The message.
+ * @param blob The blob.
+ * @param size The size of the blob.
+ */
+void protocolMessageAddBlob(Message *m, const char *blob, size_t size) {
+    m->blobs[m->num_blobs] = blob;
+    m->blob_sizes[m->num_blobs] = size;
+    m->num_blobs++;
+}
+
+/**
+ * It sends a message - the header, the sizes and the blobs in a single call, unless the socket takes only part of it.
+ *
+ * @param fd The socket to send the message to.
+ * @param m The message.
+ *
+ * @return false if the message can't be sent, e.g. if the other side closed the connection, true otherwise.
+ */
+bool protocolSend(int fd, const Message *m) {
+    uint32_t words[HEADER_WORDS + PROTOCOL_MAX_BLOBS] = {m->type, m->flags, (uint32_t) m->num_blobs};
+    struct iovec iov[1 + PROTOCOL_MAX_BLOBS];
+    iov[0].iov_base = words;
+    iov[0].iov_len = (HEADER_WORDS + m->num_blobs) * sizeof(*words);
+    for (int i = 0; i < m->num_blobs; ++i) {
+        words[HEADER_WORDS + i] = (uint32_t) m->blob_sizes[i];
+        iov[1 + i].iov_base = (void *) m->blobs[i];
+        iov[1 + i].iov_len = m->blob_sizes[i];
+    }
+
+    struct msghdr msg = {0};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 1 + m->num_blobs;
+    while (msg.msg_iovlen > 0) {
+        /* MSG_NOSIGNAL, so a client that went away is an error of the send and not a SIGPIPE. */
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0)
+            return false;
+
+        /* Skip what was sent - the whole buffers, and then part of the next one. */
+        while (msg.msg_iovlen > 0 && (size_t) n >= msg.msg_iov->iov_len) {
+            n -= (ssize_t) msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (msg.msg_iovlen > 0) {
+            msg.msg_iov->iov_base = (char *) msg.msg_iov->iov_base + n;
+            msg.msg_iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+/**
+ * It reads exactly size bytes from a socket.
+ *
+ * @param fd The socket.
+ * @param buf The buffer to read into.
+ * @param size The number of bytes to read.
+ *
+ * @return false if the connection ended before they were read, true otherwise.
+ */
+static bool readFully(int fd, void *buf, size_t size) {
+    while (size > 0) {
+        ssize_t n = read(fd, buf, size);
+        if (n <= 0)
+            return false;
+        buf = (char *) buf + n;
+        size -= n;
+    }
+    return true;
+}
+
+/**
+ * It receives a message. The blobs are null-terminated, in a buffer that the message owns.
+ *
+ * @param fd The socket to receive the message from.
+ * @param m Set to the message, to be freed with protocolMessageFree if it was received.
+ *
+ * @return false if the connection ended, the message is malformed or there isn't memory for it, true otherwise.
+ */
+bool protocolReceive(int fd, Message *m) {
+    uint32_t words[HEADER_WORDS + PROTOCOL_MAX_BLOBS];
+    if (!readFully(fd, words, HEADER_WORDS * sizeof(*words)) || words[2] > PROTOCOL_MAX_BLOBS)
+        return false;
+    protocolMessageInit(m, words[0], words[1]);
+    m->num_blobs = (int) words[2];
+    if (!readFully(fd, words + HEADER_WORDS, m->num_blobs * sizeof(*words)))
+        return false;
+
+    size_t total = 0;
+    for (int i = 0; i < m->num_blobs; ++i) {
+        m->blob_sizes[i] = words[HEADER_WORDS + i];
+        total += m->blob_sizes[i] + 1;
+    }
+    if (total > PROTOCOL_MAX_MESSAGE_SIZE || !(m->buf = malloc(total + 1)))
+        return false;
+
+    char *blob = m->buf;
+    for (int i = 0; i < m->num_blobs; ++i) {
+        if (!readFully(fd, blob, m->blob_sizes[i])) {
+            protocolMessageFree(m);
+            return false;
+        }
+        blob[m->blob_sizes[i]] = '\0';
+        m->blobs[i] = blob;
+        blob += m->blob_sizes[i] + 1;
+    }
+    return true;
+}
+
+/**
+ * It frees the blobs of a received message.
+ *
+ * @param m The message.
+ */
+void protocolMessageFree(Message *m) {
+    free(m->buf);
+    m->buf = NULL;
+    m->num_blobs = 0;
+}
@@ -0,0 +1,64 @@
+#ifndef ASSEMBLER_PROTOCOL_H
+#define ASSEMBLER_PROTOCOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/un.h>
+
+#include "file_assembly.h"
+
+/* The messages between the assembler server and its clients. A message is a header of three words - its type, its
+ * flags and its number of blobs - then the size of each blob, and then the blobs themselves. The words are in the
+ * byte order of the machine, as the server is only reachable through a local socket. */
+
+#define PROTOCOL_MAX_BLOBS 5
+#define PROTOCOL_MAX_MESSAGE_SIZE (1u << 30)
+
+/* The requests, and the blobs they carry. */
+typedef enum {
+    REQUEST_ASSEMBLE_FILE, // the name of the file (without suffix) and its path - outputs written by the server
+    REQUEST_ASSEMBLE_SOURCE // the name of the file (without suffix) and its source - outputs sent back
+} RequestType;
+
+/* The flags of a request, for its options. */
+#define REQUEST_FLAG_KEEP_AM 1u
+#define REQUEST_FLAG_ARENA_STATS 2u
+#define REQUEST_FLAG_INCREMENTAL 4u // the server keeps the state of the file, to reassemble only the lines that changed
+
+/* The types of the response to a REQUEST_ASSEMBLE_FILE - it carries the messages about the file, and the name of the
+ * file that can't be opened if there is one. A REQUEST_ASSEMBLE_SOURCE is answered by its AssemblyStatus, with the
+ * diagnostics and then the .am, .ob, .ent and .ext content. */
+typedef enum {
+    RESPONSE_FILE_ASSEMBLED,
+    RESPONSE_FILE_NOT_FOUND,
+    RESPONSE_OUT_OF_MEMORY
+} FileResponseType;
+
+typedef struct {
+    uint32_t type;
+    uint32_t flags;
+    int num_blobs;
+    const char *blobs[PROTOCOL_MAX_BLOBS]; // a received blob is also null-terminated
+    size_t blob_sizes[PROTOCOL_MAX_BLOBS];
+    char *buf; // the received blobs, or NULL for a message that is sent
+} Message;
+
+
+bool protocolSocketAddress(const char *socket_path, struct sockaddr_un *addr);
+
+uint32_t protocolOptionsToFlags(const FileAssemblyOptions *options);
+
+FileAssemblyOptions protocolFlagsToOptions(uint32_t flags);
+
+void protocolMessageInit(Message *m, uint32_t type, uint32_t flags);
+
+void protocolMessageAddBlob(Message *m, const char *blob, size_t size);
+
+bool protocolSend(int fd, const Message *m);
+
+bool protocolReceive(int fd, Message *m);
+
+void protocolMessageFree(Message *m);
+
+#endif //ASSEMBLER_PROTOCOL_H
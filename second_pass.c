@@ -2,210 +2,119 @@
 // Created by misha on 27/07/2022.
 //
 
-#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include "second_pass.h"
-#include "linkedlist.h"
-#include "file_utils.h"
+#include "vector.h"
 #include "machine_code.h"
-#include "memory_code.h"
 #include "const_tables.h"
 #include "symtab.h"
-#include "base_conversion.h"
+#include "fixups.h"
 
-#define SOURCE_FILE_SUFFIX ".am"
-#define START_ADDRESS_OFFSET 100
+#define SOURCE_FILE_SUFFIX ".as"
 
 
-/**
- * It writes the machine and memory codes to the object file.
- *
- * @param machine_codes a list of machine codes
- * @param memory_codes a list of memory codes
- * @param obj_file the file pointer to the object file
- */
-static void writeCodeToObjectFile(List machine_codes, List memory_codes, FILE *obj_file) {
-    size_t machine_code_size = 0, memory_code_size = 0;
-    for (int i = 0; i < listLength(machine_codes); i++) {
-        MachineCode mc = (MachineCode) listGetDataAt(machine_codes, i);
-        machine_code_size += machineCodeGetSize(mc);
-    }
-    for (int i = 0; i < listLength(memory_codes); i++) {
-        MemoryCode mc = (MemoryCode) listGetDataAt(memory_codes, i);
-        memory_code_size += memoryCodeGetSize(mc);
-    }
-    char binary_buf1[BINARY_WORD_SIZE + 1];
-    char binary_buf2[BINARY_WORD_SIZE + 1];
-    char base32_buf1[BASE32_WORD_SIZE + 1];
-    char base32_buf2[BASE32_WORD_SIZE + 1];
-
-    decimalToBinary(machine_code_size, binary_buf1, BINARY_WORD_SIZE);
-    binaryToBase32Word(binary_buf1, base32_buf1);
-
-    decimalToBinary(memory_code_size, binary_buf2, BINARY_WORD_SIZE);
-    binaryToBase32Word(binary_buf2, base32_buf2);
-
-    fprintf(obj_file, "%s %s\n", base32_buf1, base32_buf2);
-
-    for (int i = 0; i < listLength(machine_codes); i++) {
-        MachineCode mc = (MachineCode) listGetDataAt(machine_codes, i);
-        machineCodeToObjFile(mc, obj_file, START_ADDRESS_OFFSET);
-    }
-    for (int i = 0; i < listLength(memory_codes); i++) {
-        MemoryCode mc = (MemoryCode) listGetDataAt(memory_codes, i);
-        memoryCodeToObjFile(mc, obj_file, START_ADDRESS_OFFSET);
-    }
-}
-
-/**
- * It updates the addresses of the symbols in the machine code from the symbol table.
- *
- * @param machine_codes a list of machine codes
- * @param symtab a list of symbols (see below)
- * @param filename the name of the file that contains the assembly code
- */
-static bool updateAdressesFromSymtab(List machine_codes, List symtab, const char *filename) {
-    bool success = true;
-    for (int i = 0; i < listLength(machine_codes); ++i) {
-        MachineCode mc = (MachineCode) listGetDataAt(machine_codes, i);
-        success =
-                success && machineCodeUpdateFromSymtab(mc, symtab, SOURCE_FILE_SUFFIX, filename, START_ADDRESS_OFFSET);
-    }
-    return success;
-}
-
 /**
  * It updates the symbol table with the the declared .entry symbols.
  *
  * @param filename the name of the file being processed
- * @param src_file The file pointer to the source file.
- * @param symtab a pointer to a List (which is a pointer to a struct)
+ * @param entries the .entry statements recorded by the first pass
+ * @param symtab the symbol table
+ * @param names the intern pool of the file
+ * @param diags the diagnostics to report the errors to
  */
-bool updateEntriesInSymbolTable(const char *filename, FILE *src_file, List symtab) {
+bool updateEntriesInSymbolTable(const char *filename, Vector entries, Symtab symtab, InternPool names,
+                                Diagnostics diags) {
     bool success = true;
 
-    int line_num = 0;
-    char line[LINE_BUFFER_LEN];
-    while (fgets(line, LINE_BUFFER_LEN, src_file) != NULL) {
-        line_num++;
-        Statement s = parse(line, line_num);
-        if (statementGetType(s) == EMPTY_LINE || statementGetType(s) == COMMENT) {
-            continue;
-        }
-        if (statementGetType(s) == DIRECTIVE) {
-            const char *directive = statementGetMnemonic(s);
-            if (strcmp(directive, DIRECTIVE_ENTRY) == 0) {
-                List entry_operands = statementGetOperands(s);
-                assert(listLength(entry_operands) == 1);
-
-                const char *entry_operand = listGetDataAt(entry_operands, 0);
-                SymtabEntry found_entry = symbolTableFindByName(symtab, entry_operand);
-                if (!found_entry) {
-                    printf("Error in %s.%s line %d: entry '%s' not found\n", filename, SOURCE_FILE_SUFFIX,
-                           line_num, entry_operand);
-                    success = false;
-                    continue;
-                }
-                if (symtabEntryGetType(found_entry) == SYMBOL_EXTERN) {
-                    printf("Error in %s.%s line %d: can't define '%s' as both .extern and .entry\n", filename,
-                           SOURCE_FILE_SUFFIX,
-                           line_num, entry_operand);
-                    success = false;
-                    continue;
-                }
-                symtabEntrySetIsEntry(found_entry, true);
-            }
+    for (VectorIterator it = vectorBegin(entries); it != vectorEnd(entries); ++it) {
+        Statement s = (Statement) *it;
+        int line_num = statementGetLineNum(s);
+        assert(statementGetOperandsCount(s) == 1);
+
+        const char *entry_operand = statementGetOperandAt(s, 0);
+        SymtabEntry found_entry = symtabFind(symtab, internPoolFind(names, entry_operand, strlen(entry_operand)));
+        if (!found_entry) {
+            diagnosticsReport(diags, line_num, "Error in %s.%s line %d: entry '%s' not found", filename,
+                    SOURCE_FILE_SUFFIX, line_num, entry_operand);
+            success = false;
+        } else if (symtabEntryGetType(found_entry) == SYMBOL_EXTERN) {
+            diagnosticsReport(diags, line_num, "Error in %s.%s line %d: can't define '%s' as both .extern and .entry",
+                    filename, SOURCE_FILE_SUFFIX, line_num, entry_operand);
+            success = false;
+        } else {
+            symtabEntrySetIsEntry(found_entry, true);
         }
     }
     return success;
 }
 
 /**
- * It writes the declared .entry symbols to the .ent file.
+ * It collects the declared .entry symbols and their addresses, in the order the symbols were defined.
  *
- * @param symtab a list of symbol table entries
- * @param filename the name of the file to write to
+ * @param symtab the symbol table
+ * @param data_segment_address the address of the data segment, to relocate the data symbols to
+ * @param arena the arena to allocate the list from
+ * @param entry_symbols set to the .entry symbols
  */
-void writeEntriesFile(List symtab, const char *filename) {
-    bool is_entry = false;
-    FILE *entries_file = openFileWithSuffix(filename, "w", ENTRIES_FILE_SUFFIX);
-    for (int i = 0; i < listLength(symtab); ++i) {
-        SymtabEntry entry = (SymtabEntry) listGetDataAt(symtab, i);
-        if (symtabEntryIsEntry(entry)) {
-            is_entry = true;
-            char binary_buf[BINARY_WORD_SIZE + 1];
-            decimalToBinary(symtabEntryGetValue(entry) + START_ADDRESS_OFFSET, binary_buf, BINARY_WORD_SIZE);
-            char base32_buf[BASE32_WORD_SIZE + 1];
-            binaryToBase32Word(binary_buf, base32_buf);
-            fprintf(entries_file, "%s %s\n", symtabEntryGetName(entry), base32_buf);
-        }
+static void collectEntrySymbols(Symtab symtab, int data_segment_address, Arena arena, SymbolList *entry_symbols) {
+    int count = 0;
+    for (int i = 0; i < symtabSize(symtab); ++i) {
+        if (symtabEntryIsEntry(symtabGetEntryAt(symtab, i)))
+            count++;
     }
-    fclose(entries_file);
 
-    if (!is_entry) {
-        removeFileWithSuffix(filename, ENTRIES_FILE_SUFFIX);
-    } else {
-        printf("%s%s file created\n", filename, ENTRIES_FILE_SUFFIX);
+    entry_symbols->symbols = arenaAlloc(arena, count * sizeof(*entry_symbols->symbols));
+    entry_symbols->count = 0;
+    for (int i = 0; i < symtabSize(symtab); ++i) {
+        SymtabEntry entry = symtabGetEntryAt(symtab, i);
+        if (symtabEntryIsEntry(entry)) {
+            AssemblySymbol *symbol = &entry_symbols->symbols[entry_symbols->count++];
+            symbol->name = symtabEntryGetName(entry);
+            symbol->address = symtabEntryGetAddress(entry, data_segment_address) + START_ADDRESS_OFFSET;
+        }
     }
 }
 
 /**
- * It writes the external declarations and usages to the .ext file.
+ * It collects the operands that use extern symbols, by the addresses of their words.
  *
- * @param machine_codes A list of machine code instructions.
- * @param filename the name of the file to write to
+ * @param fixups the fixups, which collected the operands that refer to extern symbols
+ * @param arena the arena to allocate the list from
+ * @param extern_uses set to the extern uses
  */
-void writeExternalFile(List machine_codes, const char *filename) {
-    bool is_extern = false;
-    FILE *extern_file = openFileWithSuffix(filename, "w", EXTERNAL_FILE_SUFFIX);
-    for (int i = 0; i < listLength(machine_codes); ++i) {
-        MachineCode mc = (MachineCode) listGetDataAt(machine_codes, i);
-        for (int j = 0; j < machineCodeGetNumOperands(mc); ++j) {
-            if (machineCodeGetIsExternOperand(mc, j)) {
-                is_extern = true;
-                char binary_buf[BINARY_WORD_SIZE + 1];
-                decimalToBinary(machineCodeGetExternalOperandAddress(mc, j) + START_ADDRESS_OFFSET, binary_buf,
-                                BINARY_WORD_SIZE);
-                char base32_buf[BASE32_WORD_SIZE + 1];
-                binaryToBase32Word(binary_buf, base32_buf);
-                fprintf(extern_file, "%s %s\n", machineCodeGetOperand(mc, j), base32_buf);
-            }
-        }
-    }
-    fclose(extern_file);
-
-    if (!is_extern) {
-        removeFileWithSuffix(filename, EXTERNAL_FILE_SUFFIX);
-    } else {
-        printf("%s%s file created\n", filename, EXTERNAL_FILE_SUFFIX);
+static void collectExternUses(Fixups fixups, Arena arena, SymbolList *extern_uses) {
+    extern_uses->count = fixupsGetExternUsesCount(fixups);
+    extern_uses->symbols = arenaAlloc(arena, extern_uses->count * sizeof(*extern_uses->symbols));
+    for (int i = 0; i < extern_uses->count; ++i) {
+        extern_uses->symbols[i].name = fixupsGetExternUseName(fixups, i);
+        extern_uses->symbols[i].address = fixupsGetExternUseAddress(fixups, i) + START_ADDRESS_OFFSET;
     }
 }
 
 /**
- * Runs the second pass of the assembler.
+ * Runs the second pass of the assembler. The outputs are collected even if it fails, like the first pass leaves them.
  *
- * @param filename the name of the file to be read
- * @param symtab a list of symbols and their addresses
- * @param machine_codes a list of machine codes
- * @param memory_codes a list of memory codes
+ * @param ctx the assembly context of the file
+ * @param symtab the symbol table of symbols and their addresses
+ * @param machine_code the machine code
+ * @param entries the .entry statements recorded by the first pass
+ * @param fixups the operands whose symbols weren't resolved by the first pass
+ * @param entry_symbols set to the .entry symbols
+ * @param extern_uses set to the operands that use extern symbols
  */
-bool run_second_pass(const char *filename, List symtab, List machine_codes, List memory_codes) {
-    FILE *src_file = openFileWithSuffix(filename, "r", SOURCE_FILE_SUFFIX);
-    FILE *object_file = openFileWithSuffix(filename, "w", OBJECT_FILE_SUFFIX);
-
-    bool success = updateAdressesFromSymtab(machine_codes, symtab, filename);
-    writeCodeToObjectFile(machine_codes, memory_codes, object_file);
-    success = success && updateEntriesInSymbolTable(filename, src_file, symtab);
-    writeEntriesFile(symtab, filename);
-    writeExternalFile(machine_codes, filename);
-
-    fclose(src_file);
-    fclose(object_file);
-
-    listDestroy(symtab);
-    listDestroy(machine_codes);
-    listDestroy(memory_codes);
+bool run_second_pass(AssemblyContext ctx, Symtab symtab, MachineCode machine_code, Vector entries, Fixups fixups,
+                     SymbolList *entry_symbols, SymbolList *extern_uses) {
+    const char *filename = assemblyContextGetFilename(ctx);
+    Diagnostics diags = assemblyContextGetDiagnostics(ctx);
+    Arena arena = assemblyContextGetArena(ctx);
+
+    /* The file has ended, so the symbols left are either data symbols, whose addresses are final now, or undefined. */
+    bool success = fixupsResolvePending(fixups, filename, SOURCE_FILE_SUFFIX, diags);
+    success = success && updateEntriesInSymbolTable(filename, entries, symtab, assemblyContextGetInternPool(ctx),
+                                                    diags);
+    collectEntrySymbols(symtab, (int) machineCodeGetSize(machine_code), arena, entry_symbols);
+    collectExternUses(fixups, arena, extern_uses);
 
     return success;
 }
@@ -5,12 +5,19 @@
 #ifndef ASSEMBLER_SECOND_PASS_H
 #define ASSEMBLER_SECOND_PASS_H
 
-#include "linkedlist.h"
+#include "vector.h"
+#include "symtab.h"
+#include "fixups.h"
+#include "machine_code.h"
+#include "assembly_context.h"
 
-#define OBJECT_FILE_SUFFIX ".ob"
-#define ENTRIES_FILE_SUFFIX ".ent"
-#define EXTERNAL_FILE_SUFFIX ".ext"
+/* The symbols the second pass collects for the output files - the .entry symbols or the extern uses. */
+typedef struct {
+    AssemblySymbol *symbols;
+    int count;
+} SymbolList;
 
-bool run_second_pass(const char *filename, List symtab, List machine_codes, List memory_codes);
+bool run_second_pass(AssemblyContext ctx, Symtab symtab, MachineCode machine_code, Vector entries, Fixups fixups,
+                     SymbolList *entry_symbols, SymbolList *extern_uses);
 
 #endif //ASSEMBLER_SECOND_PASS_H
@@ -0,0 +1,321 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include "server.h"
+#include "protocol.h"
+#include "file_assembly.h"
+#include "errors.h"
+#include "file_utils.h"
+
+#define ERROR_MSG_SIZE 256
+#define MAX_INCREMENTAL_FILES 64
+#define ACCEPT_BACKOFF_US 100000 // after a transient failure to accept a client
+
+/* A file a client asked to assemble incrementally, kept between requests. */
+typedef struct {
+    char *filename;
+    char *path;
+    uint32_t flags;
+    IncrementalFile file;
+    unsigned long last_used;
+} IncrementalEntry;
+
+/* The files kept between requests, by their name, path and flags. A file is taken out of the table while it is
+ * assembled, so that no two requests assemble it at once, and the least recently used file is dropped when the table
+ * is full. */
+static IncrementalEntry incremental_files[MAX_INCREMENTAL_FILES];
+static int incremental_files_count;
+static unsigned long incremental_clock;
+static pthread_mutex_t incremental_files_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/**
+ * It finds a file in the table of the files kept between requests.
+ *
+ * @return The index of the file, or -1 if it isn't in the table.
+ */
+static int findIncrementalEntry(const char *filename, const char *path, uint32_t flags) {
+    for (int i = 0; i < incremental_files_count; ++i) {
+        IncrementalEntry *entry = &incremental_files[i];
+        if (entry->flags == flags && strcmp(entry->path, path) == 0 && strcmp(entry->filename, filename) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * It removes an entry from the table of the files kept between requests.
+ *
+ * @param i The index of the entry.
+ *
+ * @return The file of the entry.
+ */
+static IncrementalFile removeIncrementalEntry(int i) {
+    IncrementalEntry *entry = &incremental_files[i];
+    IncrementalFile file = entry->file;
+    free(entry->filename);
+    free(entry->path);
+    *entry = incremental_files[--incremental_files_count];
+    return file;
+}
+
+/**
+ * It takes a file out of the table of the files kept between requests, to assemble it.
+ *
+ * @param filename The name of the file (without suffix).
+ * @param path The path of the file (without suffix).
+ * @param flags The flags of the request.
+ *
+ * @return The file, or NULL if it isn't kept - it was never assembled incrementally, was dropped, or is being
+ * assembled for another request.
+ */
+static IncrementalFile takeIncrementalFile(const char *filename, const char *path, uint32_t flags) {
+    pthread_mutex_lock(&incremental_files_lock);
+    int i = findIncrementalEntry(filename, path, flags);
+    IncrementalFile file = i == -1 ? NULL : removeIncrementalEntry(i);
+    pthread_mutex_unlock(&incremental_files_lock);
+    return file;
+}
+
+/**
+ * It puts a file that was assembled back into the table of the files kept between requests. A copy of the file that
+ * another request put back meanwhile is replaced, and if the table is full, the least recently used file is dropped.
+ *
+ * @param filename The name of the file (without suffix).
+ * @param path The path of the file (without suffix).
+ * @param flags The flags of the request.
+ * @param file The file.
+ */
+static void putIncrementalFile(const char *filename, const char *path, uint32_t flags, IncrementalFile file) {
+    IncrementalFile dropped = NULL;
+    char *filename_copy = strdup(filename), *path_copy = strdup(path);
+    if (!filename_copy || !path_copy) {
+        free(filename_copy);
+        free(path_copy);
+        incrementalFileDestroy(file);
+        return;
+    }
+
+    pthread_mutex_lock(&incremental_files_lock);
+    int i = findIncrementalEntry(filename, path, flags);
+    if (i == -1 && incremental_files_count == MAX_INCREMENTAL_FILES) {
+        i = 0;
+        for (int j = 1; j < incremental_files_count; ++j) {
+            if (incremental_files[j].last_used < incremental_files[i].last_used)
+                i = j;
+        }
+    }
+    if (i != -1)
+        dropped = removeIncrementalEntry(i);
+    incremental_files[incremental_files_count++] = (IncrementalEntry) {filename_copy, path_copy, flags, file,
+                                                                      ++incremental_clock};
+    pthread_mutex_unlock(&incremental_files_lock);
+    incrementalFileDestroy(dropped);
+}
+
+
+/**
+ * It answers a REQUEST_ASSEMBLE_FILE - it assembles the file like the command line does, writing the output files next
+ * to the source, and sends back the messages about it. A failed allocation only fails the request. A file asked to be
+ * assembled incrementally is kept after it is assembled, so that the next request for it reassembles only the lines
+ * that changed.
+ *
+ * @param fd The socket of the client.
+ * @param request The request - the name of the file (without suffix) and its path.
+ *
+ * @return false if the response can't be sent, true otherwise.
+ */
+static bool serveFileRequest(int fd, const Message *request) {
+    FileAssemblyOptions options = protocolFlagsToOptions(request->flags);
+    char *log_buf = NULL;
+    size_t log_size = 0;
+    const char *failed_suffix = NULL;
+    volatile uint32_t type = RESPONSE_OUT_OF_MEMORY;
+    IncrementalFile volatile file = NULL;
+
+    FILE *log = open_memstream(&log_buf, &log_size);
+    if (log) {
+        jmp_buf recovery_point;
+        jmp_buf *previous_recovery_point = errorsSetRecoveryPoint(&recovery_point);
+        if (setjmp(recovery_point) == 0) {
+            bool assembled;
+            if (options.incremental) {
+                if (!(file = takeIncrementalFile(request->blobs[0], request->blobs[1], request->flags)))
+                    file = incrementalFileCreate(request->blobs[0], &options.assembly);
+                assembled = assembleFileIncrementally(file, request->blobs[0], request->blobs[1], &options, log,
+                                                      &failed_suffix);
+            } else {
+                assembled = assembleFileToLog(request->blobs[0], request->blobs[1], &options, log, &failed_suffix);
+            }
+            type = assembled ? RESPONSE_FILE_ASSEMBLED : RESPONSE_FILE_NOT_FOUND;
+        }
+        errorsSetRecoveryPoint(previous_recovery_point);
+        fclose(log);
+    }
+    if (file && type != RESPONSE_OUT_OF_MEMORY) {
+        putIncrementalFile(request->blobs[0], request->blobs[1], request->flags, file);
+    } else {
+        incrementalFileDestroy(file); // its state is unknown after a failed allocation
+    }
+
+    Message response;
+    protocolMessageInit(&response, type, 0);
+    protocolMessageAddBlob(&response, log_buf, log_size);
+    if (type == RESPONSE_FILE_NOT_FOUND)
+        protocolMessageAddBlob(&response, failed_suffix, strlen(failed_suffix));
+    bool sent = protocolSend(fd, &response);
+    free(log_buf);
+    return sent;
+}
+
+/**
+ * It answers a REQUEST_ASSEMBLE_SOURCE - it assembles the source in the request and sends back its status, its
+ * diagnostics and the content of its output files. The .ob, .ent and .ext content is only sent if the assembly
+ * succeeded, and the .am content only if it was asked for.
+ *
+ * @param fd The socket of the client.
+ * @param request The request - the name of the file (without suffix) and its source.
+ *
+ * @return false if the response can't be sent, true otherwise.
+ */
+static bool serveSourceRequest(int fd, const Message *request) {
+    FileAssemblyOptions options = protocolFlagsToOptions(request->flags);
+    AssemblyResult result = assemble(request->blobs[0], request->blobs[1], request->blob_sizes[1], &options.assembly);
+    AssemblyStatus status = result ? assemblyResultGetStatus(result) : ASSEMBLY_OUT_OF_MEMORY;
+
+    char *diags_buf = NULL;
+    size_t diags_size = 0;
+    FILE *diags = status != ASSEMBLY_OUT_OF_MEMORY ? open_memstream(&diags_buf, &diags_size) : NULL;
+    if (diags) {
+        for (int i = 0; i < assemblyResultGetDiagnosticsCount(result); ++i) {
+            fprintf(diags, "%s\n", assemblyResultGetDiagnosticAt(result, i)->message);
+        }
+        fclose(diags);
+    }
+
+    size_t am_size = 0, sizes[3] = {0};
+    const char *am = result ? assemblyResultGetAm(result, &am_size) : "";
+    char *outputs[3] = {NULL};
+    if (status == ASSEMBLY_SUCCESS) {
+        outputs[0] = assemblyResultRenderObjectFile(result, &sizes[0]);
+        outputs[1] = assemblyResultRenderEntriesFile(result, &sizes[1]);
+        outputs[2] = assemblyResultRenderExternalFile(result, &sizes[2]);
+        if (!outputs[0] || !outputs[1] || !outputs[2])
+            status = ASSEMBLY_OUT_OF_MEMORY;
+    }
+    if (!diags)
+        status = ASSEMBLY_OUT_OF_MEMORY;
+
+    Message response;
+    protocolMessageInit(&response, status, 0);
+    if (status != ASSEMBLY_OUT_OF_MEMORY) {
+        protocolMessageAddBlob(&response, diags_buf, diags_size);
+        protocolMessageAddBlob(&response, am, am_size);
+        for (int i = 0; i < 3; ++i) {
+            protocolMessageAddBlob(&response, outputs[i], sizes[i]);
+        }
+    }
+    bool sent = protocolSend(fd, &response);
+
+    for (int i = 0; i < 3; ++i) {
+        free(outputs[i]);
+    }
+    free(diags_buf);
+    assemblyResultDestroy(result);
+    return sent;
+}
+
+/**
+ * It answers the requests of a client, one after another, until the client closes the connection.
+ *
+ * @param arg The socket of the client.
+ */
+static void *serveClient(void *arg) {
+    int fd = (int) (intptr_t) arg;
+    Message request;
+    while (protocolReceive(fd, &request)) {
+        bool served = false;
+        if (request.num_blobs == 2 && request.type == REQUEST_ASSEMBLE_FILE) {
+            served = serveFileRequest(fd, &request);
+        } else if (request.num_blobs == 2 && request.type == REQUEST_ASSEMBLE_SOURCE) {
+            served = serveSourceRequest(fd, &request);
+        }
+        protocolMessageFree(&request);
+        if (!served) // the client went away, or doesn't speak the protocol
+            break;
+    }
+    close(fd);
+    return NULL;
+}
+
+/**
+ * It exits with a message about a failed call, and the reason it failed.
+ *
+ * @param what What failed.
+ * @param socket_path The path of the socket.
+ */
+static void serverError(const char *what, const char *socket_path) {
+    char msg[ERROR_MSG_SIZE];
+    snprintf(msg, sizeof(msg), "Can't %s the server socket %s: %s\n", what, socket_path, strerror(errno));
+    errorWithMsg(msg);
+}
+
+/**
+ * It runs the assembler as a server on a Unix domain socket, until the process is killed. Every client is served on a
+ * thread of its own, so the files of different clients are assembled concurrently, and the process stays up between
+ * requests - a request costs only the assembly itself, not starting a process.
+ *
+ * @param socket_path The path of the socket to listen on. A socket left there by an earlier server is replaced.
+ */
+void serverRun(const char *socket_path) {
+    fileUtilsDisableMapping(); // a source truncated while it is mapped would take the server down
+    struct sockaddr_un addr;
+    if (!protocolSocketAddress(socket_path, &addr)) {
+        errno = ENAMETOOLONG;
+        serverError("create", socket_path);
+    }
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd == -1)
+        serverError("create", socket_path);
+    unlink(socket_path);
+    if (bind(server_fd, (struct sockaddr *) &addr, sizeof(addr)) == -1)
+        serverError("bind", socket_path);
+    if (listen(server_fd, SOMAXCONN) == -1)
+        serverError("listen on", socket_path);
+    printf("Assembler server listening on %s\n", socket_path);
+    fflush(stdout);
+
+    for (;;) {
+        int client_fd = accept(server_fd, NULL, NULL);
+        if (client_fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM || errno == EPROTO) {
+                /* Out of descriptors or memory for now - the clients that are served free them when they are done. */
+                fprintf(stderr, "Can't accept on the server socket %s: %s - retrying\n", socket_path,
+                        strerror(errno));
+                usleep(ACCEPT_BACKOFF_US);
+                continue;
+            }
+            serverError("accept on", socket_path);
+        }
+
+        pthread_t thread;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&thread, &attr, serveClient, (void *) (intptr_t) client_fd) != 0)
+            close(client_fd); // the client sees the connection closed
+        pthread_attr_destroy(&attr);
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef ASSEMBLER_SERVER_H
+#define ASSEMBLER_SERVER_H
+
+void serverRun(const char *socket_path);
+
+#endif //ASSEMBLER_SERVER_H
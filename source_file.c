@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include <string.h>
+#include "source_file.h"
+#include "errors.h"
+
+
+/* The content of a source file and the offsets of its lines. */
+struct source_file_t {
+    const char *data;
+    size_t size;
+
+    int num_lines;
+    /* Line i is data[line_starts[i]...line_starts[i + 1]), including its '\n'. */
+    size_t *line_starts;
+};
+
+
+/**
+ * It indexes the lines of the source file, in a single scan of its content.
+ *
+ * @param sf The source file.
+ */
+static void indexLines(SourceFile sf) {
+    int capacity = 64;
+    sf->line_starts = malloc(capacity * sizeof(*sf->line_starts));
+    if (!sf->line_starts)
+        memoryAllocationError();
+
+    sf->num_lines = 0;
+    size_t start = 0;
+    while (start < sf->size) {
+        const char *newline = memchr(sf->data + start, '\n', sf->size - start);
+        if (sf->num_lines + 1 >= capacity) {
+            capacity *= 2;
+            sf->line_starts = realloc(sf->line_starts, capacity * sizeof(*sf->line_starts));
+            if (!sf->line_starts)
+                memoryAllocationError();
+        }
+        sf->line_starts[sf->num_lines++] = start;
+        start = newline ? (size_t) (newline - sf->data) + 1 : sf->size;
+    }
+    sf->line_starts[sf->num_lines] = sf->size;
+}
+
+/**
+ * It creates a source file from its content, and indexes its lines.
+ *
+ * @param data The content of the file, which the source file borrows.
+ * @param size The size of the content.
+ */
+SourceFile sourceFileCreate(const char *data, size_t size) {
+    SourceFile sf = malloc(sizeof(*sf));
+    if (!sf)
+        memoryAllocationError();
+
+    sf->data = data;
+    sf->size = size;
+    indexLines(sf);
+    return sf;
+}
+
+/**
+ * It returns the number of lines in the source file.
+ *
+ * @param sf The source file.
+ */
+int sourceFileGetLinesCount(SourceFile sf) {
+    return sf->num_lines;
+}
+
+/**
+ * It returns a line of the source file. The line is a view into the file's content - it isn't null-terminated, and
+ * it is valid until the source file is closed.
+ *
+ * @param sf The source file.
+ * @param index The index of the line, starting from 0.
+ * @param line_len Set to the length of the line, including its '\n' if it has one.
+ */
+const char *sourceFileGetLine(SourceFile sf, int index, size_t *line_len) {
+    *line_len = sf->line_starts[index + 1] - sf->line_starts[index];
+    return sf->data + sf->line_starts[index];
+}
+
+/**
+ * It destroys the source file. Its content is borrowed, so it is left as is.
+ *
+ * @param sf The source file to destroy.
+ */
+void sourceFileDestroy(SourceFile sf) {
+    if (!sf)
+        return;
+
+    free(sf->line_starts);
+    free(sf);
+}
@@ -0,0 +1,16 @@
+#ifndef ASSEMBLER_SOURCE_FILE_H
+#define ASSEMBLER_SOURCE_FILE_H
+
+#include <stddef.h>
+
+typedef struct source_file_t *SourceFile;
+
+SourceFile sourceFileCreate(const char *data, size_t size);
+
+int sourceFileGetLinesCount(SourceFile sf);
+
+const char *sourceFileGetLine(SourceFile sf, int index, size_t *line_len);
+
+void sourceFileDestroy(SourceFile sf);
+
+#endif //ASSEMBLER_SOURCE_FILE_H
@@ -26,49 +26,6 @@ bool strEndsWith(const char *str, const char *suffix) {
     return strcmp(str + (str_len - suffix_len), suffix) == 0;
 }
 
-/**
- * It checks if the string starts with the prefix.
- *
- * @param str The string to check
- * @param prefix The prefix to check for.
- * @param ignore_leading_whitespace If true, the function will ignore leading whitespace in the string.
- */
-bool strStartsWith(const char *str, const char *prefix, bool ignore_leading_whitespace) {
-    size_t str_len = strlen(str);
-    size_t prefix_len = strlen(prefix);
-
-    if (str_len < prefix_len)
-        return false;
-
-    int start_substring_from = 0;
-    if (ignore_leading_whitespace) {
-        start_substring_from = strFindNextNonWhitespace(str, 0);
-    }
-
-    for (size_t i = 0; i < prefix_len; ++i) {
-        if (str[start_substring_from + i] != prefix[i])
-            return false;
-    }
-    return true;
-}
-
-/**
- * Find the next whitespace character in the string, starting at the given index
- *
- * @param str The string to search in
- * @param from_idx The index to start searching from.
- */
-size_t strFindNextWhitespace(const char *str, size_t from_idx) {
-    while (from_idx < strlen(str) && !isspace(str[from_idx])) {
-        from_idx++;
-    }
-
-    if (from_idx == strlen(str))
-        return -1;
-    else
-        return from_idx;
-}
-
 /**
  * Find the next non-whitespace character in the string, starting at the given index
  *
@@ -109,76 +66,46 @@ char *strndup(const char *s, size_t n) {
 }
 
 /**
- * Replace all occurrences of old_substr in s with new_substr.
- * You must free the result if result is non-NULL.
- *
- * @param s The string to search and replace in.
- * @param old_substr The substring you want to replace.
- * @param new_substr The string to replace old_substr with.
+ * It checks if the character is one of the delimiters.
  */
-char *strReplace(const char *s, const char *old_substr, const char *new_substr) {
-    char *result; // the return string
-    char *ins;    // the next insert point
-    char *tmp;    // varies
-    size_t len_rep;  // listLength of old_substr (the string to remove)
-    size_t len_with; // listLength of with (the string to replace old_substr with)
-    size_t len_front; // distance between old_substr and end of last old_substr
-    int count;    // number of replacements
-
-    // sanity checks and initialization
-    if (!s || !old_substr)
-        return NULL;
-    len_rep = strlen(old_substr);
-    if (len_rep == 0)
-        return NULL; // empty old_substr causes infinite loop during count
-    if (!new_substr)
-        new_substr = "";
-    len_with = strlen(new_substr);
-
-    // count the number of replacements needed
-    tmp = strstr(s, old_substr);
-    for (count = 0; tmp; ++count) {
-        ins = tmp + len_rep;
-        tmp = strstr(ins, old_substr);
-    }
-
-    tmp = result = malloc(strlen(s) + (len_with - len_rep) * count + 1);
-
-    if (!result)
-        return NULL;
-
-    // first time through the loop, all the variable are set correctly
-    // from here on,
-    //    tmp points to the end of the result string
-    //    ins points to the next occurrence of old_substr in s
-    //    s points to the remainder of s after "end of old_substr"
-    while (count--) {
-        ins = strstr(s, old_substr);
-        len_front = ins - s;
-        tmp = strncpy(tmp, s, len_front) + len_front;
-        tmp = strcpy(tmp, new_substr) + len_with;
-        s += len_front + len_rep; // move to next "end of old_substr"
-    }
-    strcpy(tmp, s);
-    return result;
+static bool isDelim(char c, const char *delim) {
+    return c != '\0' && strchr(delim, c) != NULL;
 }
 
 /**
- * It splits a string by delimiters into a list of strings.
+ * It finds the tokens of the first len characters of a string separated by delimiters, like strtok does, but without
+ * copying or modifying the string. The string doesn't have to be null-terminated, but a null character ends it early.
+ * Only the first max_spans tokens are written, so calling it with max_spans = 0 just counts the tokens.
  *
- * @param s The string to split.
+ * @param s The string to tokenize.
+ * @param len The length of the string.
  * @param delim a string of delimiters.
+ * @param spans The array to write the tokens spans to.
+ * @param max_spans The size of the spans array.
+ *
+ * @return The number of tokens in the string.
  */
-List strSplit(const char *s, const char *delim) {
-    List l = listCreate((list_eq) strcmp, (list_copy) strdup, free);
-    char *tmp = strdup(s);
-
-    for (char *token = strtok(tmp, delim); token; token = strtok(NULL, delim)) {
-        listAppend(l, token);
+size_t strTokenize(const char *s, size_t len, const char *delim, StrSpan *spans, size_t max_spans) {
+    size_t num_tokens = 0;
+    size_t i = 0;
+    while (true) {
+        while (i < len && isDelim(s[i], delim)) {
+            i++;
+        }
+        if (i == len || s[i] == '\0')
+            break;
+
+        size_t start = i;
+        while (i < len && s[i] != '\0' && !isDelim(s[i], delim)) {
+            i++;
+        }
+        if (num_tokens < max_spans) {
+            spans[num_tokens].offset = start;
+            spans[num_tokens].length = i - start;
+        }
+        num_tokens++;
     }
-
-    free(tmp);
-    return l;
+    return num_tokens;
 }
 
 /**
@@ -199,19 +126,82 @@ char *strConcat(const char *s1, const char *s2) {
 }
 
 /**
- * Counts the number of times a character appears in a string.
+ * Counts the number of times a character appears in the first len characters of a string.
  *
  * @param s The string to search
+ * @param len The length of the string, which doesn't have to be null-terminated
  * @param c The character to count
  */
-int strCountChar(const char *s, char c) {
-    const char *p = s;
+int strCountChar(const char *s, size_t len, char c) {
+    const char *end = s + len;
     int count = 0;
 
-    do {
-        if (*p == c)
-            count++;
-    } while (*(p++));
-
+    for (const char *p = memchr(s, c, len); p; p = memchr(p + 1, c, end - p - 1)) {
+        count++;
+    }
     return count;
 }
+
+/**
+ * It appends len characters to the buffer, doubling its capacity when it is full, so building a string of n
+ * characters takes O(n) time.
+ *
+ * @param buf The buffer to append to.
+ * @param s The characters to append, don't have to be null-terminated.
+ * @param len The number of characters to append.
+ */
+void strBufferAppend(StrBuffer *buf, const char *s, size_t len) {
+    if (buf->length + len + 1 > buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity : 64;
+        while (buf->length + len + 1 > capacity) {
+            capacity *= 2;
+        }
+        buf->data = realloc(buf->data, capacity);
+        if (!buf->data)
+            memoryAllocationError();
+        buf->capacity = capacity;
+    }
+    memcpy(buf->data + buf->length, s, len);
+    buf->length += len;
+    buf->data[buf->length] = '\0';
+}
+
+/**
+ * It replaces count characters of the buffer with len other characters, moving the characters after them.
+ *
+ * @param buf The buffer.
+ * @param offset The offset of the first character to replace.
+ * @param count The number of characters to replace.
+ * @param s The characters to put instead, don't have to be null-terminated.
+ * @param len The number of characters to put instead.
+ */
+void strBufferReplace(StrBuffer *buf, size_t offset, size_t count, const char *s, size_t len) {
+    size_t length = buf->length - count + len;
+    if (length + 1 > buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity : 64;
+        while (length + 1 > capacity) {
+            capacity *= 2;
+        }
+        buf->data = realloc(buf->data, capacity);
+        if (!buf->data)
+            memoryAllocationError();
+        buf->capacity = capacity;
+    }
+    memmove(buf->data + offset + len, buf->data + offset + count, buf->length - offset - count);
+    if (len)
+        memcpy(buf->data + offset, s, len);
+    buf->length = length;
+    buf->data[buf->length] = '\0';
+}
+
+/**
+ * It frees the memory of the buffer.
+ *
+ * @param buf The buffer to free.
+ */
+void strBufferFree(StrBuffer *buf) {
+    free(buf->data);
+    buf->data = NULL;
+    buf->length = 0;
+    buf->capacity = 0;
+}
@@ -7,25 +7,39 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
-#include "linkedlist.h"
 
 
-bool strEndsWith(const char *str, const char *suffix);
+/* A token of a string, given by its offset and length in the string. */
+typedef struct {
+    size_t offset;
+    size_t length;
+} StrSpan;
+
+/* A null-terminated string that grows as it is appended to, with amortized doubling. */
+typedef struct {
+    char *data; // NULL until something is appended
+    size_t length;
+    size_t capacity;
+} StrBuffer;
 
-bool strStartsWith(const char *str, const char *prefix, bool ignore_leading_whitespace);
 
-size_t strFindNextWhitespace(const char *str, size_t from_idx);
+bool strEndsWith(const char *str, const char *suffix);
 
 size_t strFindNextNonWhitespace(const char *str, size_t from_idx);
 
 char *strndup(const char *s, size_t n);
 
-char *strReplace(const char *s, const char *old_substr, const char *new_substr);
 
-List strSplit(const char *s, const char *delim);
+size_t strTokenize(const char *s, size_t len, const char *delim, StrSpan *spans, size_t max_spans);
 
 char *strConcat(const char *s1, const char *s2);
 
-int strCountChar(const char *s, char c);
+int strCountChar(const char *s, size_t len, char c);
+
+void strBufferAppend(StrBuffer *buf, const char *s, size_t len);
+
+void strBufferReplace(StrBuffer *buf, size_t offset, size_t count, const char *s, size_t len);
+
+void strBufferFree(StrBuffer *buf);
 
 #endif //ASSEMBLER_STR_UTILS_H
@@ -8,39 +8,50 @@
 #include "symtab.h"
 #include "errors.h"
 
+#define SYMTAB_INITIAL_CAPACITY 64
+
 
 struct symtab_entry_t {
-    char *name;
+    int name_id;
+    const char *name; // the interned name
     int value;
 
     bool is_entry;
-    // TODO: get rid of this
-    bool is_struct;
 
     int line_num;
     SymbolType type;
 };
 
+/* The symbols are keyed by the interned IDs of their names, so finding a symbol is indexing `by_name_id`. The entries
+ * themselves are kept in insertion order in `entries`. */
+struct symtab_t {
+    SymtabEntry *entries;
+    int size;
+    int entries_capacity;
+
+    SymtabEntry *by_name_id; // NULL for a name that isn't a symbol
+    int by_name_id_capacity;
+};
+
 /**
- * It creates a new symbol table entry with the given name and value.
+ * It creates a new symbol table entry with the given name and value. The entry is allocated from the arena.
  *
- * @param name The name of the symbol.
+ * @param arena The arena to allocate the entry from.
+ * @param names The intern pool of the file.
+ * @param name_id The interned ID of the name of the symbol.
  * @param value The value of the symbol.
  * @param is_entry Whether the symbol is an entry or not.
- * @param is_struct Whether the symbol is a struct or not.
  * @param line_num The line number of the symbol.
  * @param type The type of the symbol.
  *
  * @return A new symbol table entry.
  */
-SymtabEntry
-symtabEntryCreate(const char *name, int value, bool is_entry, bool is_struct, int line_num, SymbolType type) {
-    SymtabEntry e = malloc(sizeof(*e));
-    if (!e) {
-        memoryAllocationError();
-    }
+SymtabEntry symtabEntryCreate(Arena arena, InternPool names, int name_id, int value, bool is_entry, int line_num,
+                              SymbolType type) {
+    SymtabEntry e = arenaAlloc(arena, sizeof(*e));
 
-    e->name = strdup(name);
+    e->name_id = name_id;
+    e->name = internPoolGetString(names, name_id);
     e->value = value;
     e->is_entry = is_entry;
     e->line_num = line_num;
@@ -49,50 +60,41 @@ symtabEntryCreate(const char *name, int value, bool is_entry, bool is_struct, in
 }
 
 /**
- * It compares two entries in the symbol table.
- *
- * @param e1 The first entry to compare
- * @param e2 The second entry to compare.
- */
-int symtabEntryCmp(SymtabEntry e1, SymtabEntry e2) {
-    return strcmp(e1->name, e2->name);
-}
-
-/**
- * It copies the symbol table entry.
+ * It returns the name of the symbol table entry.
  *
- * @param e The entry to copy.
+ * @param e The symbol table entry to get the name of.
  */
-SymtabEntry symtabEntryCopy(SymtabEntry e) {
-    return symtabEntryCreate(e->name, e->value, e->is_entry, e->is_struct, e->line_num, e->type);
+const char *symtabEntryGetName(SymtabEntry e) {
+    return e->name;
 }
 
 /**
- * It destroys the symbol table entry.
+ * It returns the interned ID of the name of the symbol table entry.
  *
- * @param e The entry to destroy.
+ * @param e The symbol table entry.
  */
-void symtabEntryDestroy(SymtabEntry e) {
-    free((void *) e->name);
-    free(e);
+int symtabEntryGetNameId(SymtabEntry e) {
+    return e->name_id;
 }
 
 /**
- * It returns the name of the symbol table entry.
+ * It returns the value of the symbol table entry.
  *
- * @param e The symbol table entry to get the name of.
+ * @param e The symbol table entry to get the value of.
  */
-const char *symtabEntryGetName(SymtabEntry e) {
-    return e->name;
+int symtabEntryGetValue(SymtabEntry e) {
+    return e->value;
 }
 
 /**
- * It returns the value of the symbol table entry.
+ * It returns the address of the symbol. The value of a data symbol is its offset in the data segment, so it is
+ * relocated to where the data segment starts.
  *
- * @param e The symbol table entry to get the value of.
+ * @param e The symbol table entry.
+ * @param data_segment_address The address of the data segment, which is the size of the code.
  */
-int symtabEntryGetValue(SymtabEntry e) {
-    return e->value;
+int symtabEntryGetAddress(SymtabEntry e, int data_segment_address) {
+    return e->type == SYMBOL_DATA ? e->value + data_segment_address : e->value;
 }
 
 /**
@@ -122,15 +124,6 @@ SymbolType symtabEntryGetType(SymtabEntry e) {
     return e->type;
 }
 
-/**
- * It checks if the entry is a struct.
- *
- * @param e The entry to check
- */
-bool symtabEntryIsStruct(SymtabEntry e) {
-    return e->is_struct;
-}
-
 /**
  * It sets the value of the symbol table entry.
  *
@@ -153,18 +146,114 @@ void symtabEntrySetIsEntry(SymtabEntry e, bool is_entry) {
 }
 
 /**
- * It finds the symbol table entry by name.
+ * It creates an empty symbol table.
+ */
+Symtab symtabCreate(void) {
+    Symtab symtab = malloc(sizeof(*symtab));
+    if (!symtab) {
+        memoryAllocationError();
+    }
+
+    symtab->size = 0;
+    symtab->entries_capacity = SYMTAB_INITIAL_CAPACITY;
+    symtab->entries = malloc(sizeof(*symtab->entries) * symtab->entries_capacity);
+    symtab->by_name_id_capacity = SYMTAB_INITIAL_CAPACITY;
+    symtab->by_name_id = calloc(symtab->by_name_id_capacity, sizeof(*symtab->by_name_id));
+    if (!symtab->entries || !symtab->by_name_id) {
+        memoryAllocationError();
+    }
+
+    return symtab;
+}
+
+/**
+ * It destroys the symbol table. The entries live in the arena they were created in.
  *
- * @param symtab The symbol table to search.
- * @param name The name of the symbol to find.
- */
-SymtabEntry symbolTableFindByName(List symtab, const char *name) {
-    // This is a hack to get the entry in the symbol table
-    SymtabEntry dummy_entry = symtabEntryCreate(name, 0, false, false, 0, SYMBOL_DATA);
-    SymtabEntry found_entry;
-    if (listFind(symtab, dummy_entry, (void **) &found_entry) == LIST_NOT_FOUND) {
-        found_entry = NULL;
+ * @param symtab The symbol table to destroy.
+ */
+void symtabDestroy(Symtab symtab) {
+    if (!symtab)
+        return;
+
+    free(symtab->entries);
+    free(symtab->by_name_id);
+    free(symtab);
+}
+
+/**
+ * It inserts the entry into the symbol table, unless a symbol with the same name is already defined.
+ *
+ * @param symtab The symbol table to insert into.
+ * @param e The entry to insert.
+ * @param found If the symbol is already defined, it is set to the previously defined entry.
+ */
+SymtabResult symtabInsert(Symtab symtab, SymtabEntry e, SymtabEntry *found) {
+    if (!symtab || !e)
+        return SYMTAB_NULL_ARGUMENT;
+
+    SymtabEntry found_entry = symtabFind(symtab, e->name_id);
+    if (found_entry) {
+        if (found)
+            *found = found_entry;
+        return SYMTAB_DUPLICATE;
+    }
+
+    if (symtab->size == symtab->entries_capacity) {
+        symtab->entries_capacity *= 2;
+        symtab->entries = realloc(symtab->entries, sizeof(*symtab->entries) * symtab->entries_capacity);
+        if (!symtab->entries) {
+            memoryAllocationError();
+        }
+    }
+    if (e->name_id >= symtab->by_name_id_capacity) {
+        int old_capacity = symtab->by_name_id_capacity;
+        while (e->name_id >= symtab->by_name_id_capacity) {
+            symtab->by_name_id_capacity *= 2;
+        }
+        symtab->by_name_id = realloc(symtab->by_name_id, sizeof(*symtab->by_name_id) * symtab->by_name_id_capacity);
+        if (!symtab->by_name_id) {
+            memoryAllocationError();
+        }
+        memset(symtab->by_name_id + old_capacity, 0,
+               sizeof(*symtab->by_name_id) * (symtab->by_name_id_capacity - old_capacity));
     }
-    symtabEntryDestroy(dummy_entry);
-    return found_entry;
+    symtab->entries[symtab->size++] = e;
+    symtab->by_name_id[e->name_id] = e;
+    return SYMTAB_SUCCESS;
+}
+
+/**
+ * It finds the symbol table entry by the interned ID of its name.
+ *
+ * @param symtab The symbol table to search.
+ * @param name_id The ID of the name of the symbol, or INTERN_POOL_NOT_FOUND.
+ *
+ * @return The entry, or NULL if the symbol is not defined.
+ */
+SymtabEntry symtabFind(Symtab symtab, int name_id) {
+    if (!symtab || name_id < 0 || name_id >= symtab->by_name_id_capacity)
+        return NULL;
+
+    return symtab->by_name_id[name_id];
+}
+
+/**
+ * It returns the number of symbols in the symbol table.
+ *
+ * @param symtab The symbol table.
+ */
+int symtabSize(Symtab symtab) {
+    return symtab->size;
+}
+
+/**
+ * It returns the entry at the given index, in the order the symbols were inserted.
+ *
+ * @param symtab The symbol table.
+ * @param index The index of the entry.
+ */
+SymtabEntry symtabGetEntryAt(Symtab symtab, int index) {
+    if (!symtab || index < 0 || index >= symtab->size)
+        return NULL;
+    return symtab->entries[index];
 }
@@ -5,7 +5,9 @@
 #ifndef ASSEMBLER_SYMTAB_H
 #define ASSEMBLER_SYMTAB_H
 
-#include "linkedlist.h"
+#include <stdbool.h>
+#include "arena.h"
+#include "intern_pool.h"
 
 #define SYMBOL_ADDRESS_NOT_FOUND -1
 
@@ -17,18 +19,24 @@ typedef enum SymbolType {
 
 typedef struct symtab_entry_t *SymtabEntry;
 
-SymtabEntry symtabEntryCreate(const char *name, int value, bool is_entry, bool is_struct, int line_num, SymbolType type);
+typedef struct symtab_t *Symtab;
 
-int symtabEntryCmp(SymtabEntry e1, SymtabEntry e2);
+/** possible return values */
+typedef enum {
+    SYMTAB_SUCCESS, SYMTAB_NULL_ARGUMENT, SYMTAB_DUPLICATE
+} SymtabResult;
 
-SymtabEntry symtabEntryCopy(SymtabEntry e);
-
-void symtabEntryDestroy(SymtabEntry e);
+SymtabEntry symtabEntryCreate(Arena arena, InternPool names, int name_id, int value, bool is_entry, int line_num,
+                              SymbolType type);
 
 const char *symtabEntryGetName(SymtabEntry e);
 
+int symtabEntryGetNameId(SymtabEntry e);
+
 int symtabEntryGetValue(SymtabEntry e);
 
+int symtabEntryGetAddress(SymtabEntry e, int data_segment_address);
+
 bool symtabEntryIsEntry(SymtabEntry e);
 
 int symtabEntryGetLineNum(SymtabEntry e);
@@ -39,6 +47,16 @@ void symtabEntrySetValue(SymtabEntry e, int value);
 
 void symtabEntrySetIsEntry(SymtabEntry e, bool is_entry);
 
-SymtabEntry symbolTableFindByName(List symtab, const char *name);
+Symtab symtabCreate(void);
+
+void symtabDestroy(Symtab symtab);
+
+SymtabResult symtabInsert(Symtab symtab, SymtabEntry e, SymtabEntry *found);
+
+SymtabEntry symtabFind(Symtab symtab, int name_id);
+
+int symtabSize(Symtab symtab);
+
+SymtabEntry symtabGetEntryAt(Symtab symtab, int index);
 
 #endif //ASSEMBLER_SYMTAB_H
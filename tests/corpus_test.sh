@@ -0,0 +1,37 @@
+#!/bin/sh
+# Assembles every source of the regression corpus and compares the log and the output files with the expected ones -
+# a missing output file must be missing, and every other one byte-identical. The corpus is assembled twice, so that
+# options that keep state between runs (like --cache-dir) are checked on their second run as well.
+#
+# usage: corpus_test.sh <assembler> <input dir> <expected dir> [assembler options...]
+# The assembler runs in a temporary directory, which relative paths in the options are relative to.
+
+assembler=$1
+input=$2
+expected=$3
+shift 3
+
+work=$(mktemp -d) || exit 1
+trap 'rm -rf "$work"' EXIT
+failed=0
+
+for run in 1 2; do
+    for source in "$input"/*.as; do
+        name=$(basename "$source" .as)
+        cp "$source" "$work/"
+        (cd "$work" && "$assembler" --keep-am "$@" "$name" > "$name.log")
+        for suffix in log am ob ent ext; do
+            if [ -f "$expected/$name.$suffix" ]; then
+                if ! cmp -s "$expected/$name.$suffix" "$work/$name.$suffix"; then
+                    echo "run $run: $name.$suffix differs from the expected one"
+                    failed=1
+                fi
+            elif [ -f "$work/$name.$suffix" ]; then
+                echo "run $run: $name.$suffix was created, but isn't expected"
+                failed=1
+            fi
+        done
+        rm -f "$work/$name".*
+    done
+done
+exit $failed
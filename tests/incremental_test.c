@@ -0,0 +1,374 @@
+/*
+ * Checks the incremental reassembly of an AssemblySession against assembling the same source from scratch. A generated
+ * source is edited - first with edits that each exercise one rule of the incremental path, then with random edits - and
+ * after every edit the session's result must be the same as assemble()'s: the status, the diagnostics, the .am text,
+ * the .ob/.ent/.ext content, and the object file patched with only the lines the session reports as changed.
+ *
+ * usage: incremental_test <iterations> <seed> [keep-am]
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "assembler.h"
+
+#define GENERATED_STATEMENTS 300
+#define LINE_SIZE 128
+
+
+/* The source being edited, a line at a time - every line ends with a '\n', but the last one may not. */
+typedef struct {
+    char **lines;
+    int count;
+} Source;
+
+/* What the test saw so far. */
+typedef struct {
+    AssemblySession session;
+    AssemblyOptions options;
+    char *object; // the object file of the last successful assembly, patched as a file on disk would be
+    size_t object_size;
+    int assemblies;
+    int incremental;
+} TestState;
+
+/* Lines inserted by the random edits - most of them keep the source valid, so the incremental path stays in use. */
+static const char *const inserted_lines[] = {
+        "        inc r3\n", "        mov K5, r1\n", "        prn #7\n", "        jmp L10\n", "        sub r1 , XT1\n",
+        "        lea S3.2, r4\n", "        get XT2\n", "; a comment\n", "\n", "        cmp #1, K1\n",
+        "        not S1.1\n", "        mm\n", "   mov L20, T4\n", "Q1:    .data 1,2,3\n", "        bogus r1\n",
+        "        add r2,UNDEF\n", ".entry K3\n", "K2:    .data 4,5\n", "        macro m2\n", "        endmacro\n",
+};
+
+
+static char *copyString(const char *s) {
+    char *copy = strdup(s);
+    if (!copy) {
+        perror("strdup");
+        exit(2);
+    }
+    return copy;
+}
+
+static void sourceInsert(Source *src, int at, const char *line) {
+    src->lines = realloc(src->lines, (src->count + 1) * sizeof(*src->lines));
+    if (!src->lines) {
+        perror("realloc");
+        exit(2);
+    }
+    memmove(src->lines + at + 1, src->lines + at, (src->count - at) * sizeof(*src->lines));
+    src->lines[at] = copyString(line);
+    src->count++;
+}
+
+static void sourceDelete(Source *src, int at) {
+    free(src->lines[at]);
+    memmove(src->lines + at, src->lines + at + 1, (src->count - at - 1) * sizeof(*src->lines));
+    src->count--;
+}
+
+static void sourceReplace(Source *src, int at, const char *line) {
+    free(src->lines[at]);
+    src->lines[at] = copyString(line);
+}
+
+static void sourceFree(Source *src) {
+    for (int i = 0; i < src->count; ++i) {
+        free(src->lines[i]);
+    }
+    free(src->lines);
+    src->lines = NULL;
+    src->count = 0;
+}
+
+static void sourceCopy(Source *dst, const Source *src) {
+    sourceFree(dst);
+    for (int i = 0; i < src->count; ++i) {
+        sourceInsert(dst, i, src->lines[i]);
+    }
+}
+
+static char *sourceJoin(const Source *src, size_t *size) {
+    size_t total = 0;
+    for (int i = 0; i < src->count; ++i) {
+        total += strlen(src->lines[i]);
+    }
+    char *buf = malloc(total + 1), *out = buf;
+    for (int i = 0; i < src->count; ++i) {
+        size_t len = strlen(src->lines[i]);
+        memcpy(out, src->lines[i], len);
+        out += len;
+    }
+    *size = total;
+    return buf;
+}
+
+/**
+ * It generates the source the edits start from - the same kind of source bench/gen_source generates, with the last
+ * line left without a '\n'.
+ */
+static void generateSource(Source *src) {
+    char line[LINE_SIZE];
+    const char *header[] = {".extern XT1\n", ".extern XT2\n", "        macro mm\n", "            inc K0\n",
+                            "            mov r1, r2\n", "        endmacro\n"};
+    for (size_t i = 0; i < sizeof(header) / sizeof(*header); ++i) {
+        sourceInsert(src, src->count, header[i]);
+    }
+    int n = GENERATED_STATEMENTS;
+    for (int i = 0; i < n; ++i) {
+        int target = i + 18 < n - 1 ? i + 18 : n - 1;
+        switch (i % 10) {
+            case 0: snprintf(line, sizeof(line), "L%d:    mov S%d.1 ,K%d\n", i, i / 10, i / 10); break;
+            case 1: snprintf(line, sizeof(line), "        add r2,L%d\n", i - 1); break;
+            case 2: snprintf(line, sizeof(line), "        jmp L%d\n", target - target % 10); break;
+            case 3: snprintf(line, sizeof(line), "        mm\n"); break;
+            case 4: snprintf(line, sizeof(line), "        prn #-%d\n", i % 100); break;
+            case 5: snprintf(line, sizeof(line), "        sub r1 , XT1\n"); break;
+            case 6: snprintf(line, sizeof(line), "K%d:    .data %d,-9,15\n", i / 10, i % 50); break;
+            case 7: snprintf(line, sizeof(line), "S%d:    .struct 8, \"ab\"\n", i / 10); break;
+            case 8: snprintf(line, sizeof(line), "T%d:    .string \"abcdef\"\n", i / 10); break;
+            default: snprintf(line, sizeof(line), ".entry K%d\n", i / 10); break;
+        }
+        sourceInsert(src, src->count, line);
+    }
+    sourceInsert(src, src->count, "        hlt");
+}
+
+/**
+ * It compares two rendered outputs, and frees them.
+ */
+static bool sameRendered(char *a, size_t a_size, char *b, size_t b_size) {
+    bool same = a && b && a_size == b_size && memcmp(a, b, a_size) == 0;
+    free(a);
+    free(b);
+    return same;
+}
+
+/**
+ * It patches the object file the test keeps with the lines the session reports as changed, as the command line patches
+ * the .ob on disk, and compares it with the object file of a full assembly.
+ */
+static bool patchObject(TestState *state, AssemblyResult result, size_t first, size_t end, const char *expected,
+                        size_t expected_size) {
+    size_t header_size, lines_size;
+    char *header = assemblyResultRenderObjectLines(result, 0, 1, &header_size);
+    char *lines = assemblyResultRenderObjectLines(result, 1 + first, 1 + end, &lines_size);
+    size_t needed = (1 + first) * header_size + lines_size;
+    size_t capacity = expected_size > needed ? expected_size : needed;
+    state->object = realloc(state->object, capacity > state->object_size ? capacity : state->object_size);
+    memcpy(state->object, header, header_size);
+    memcpy(state->object + (1 + first) * header_size, lines, lines_size);
+    state->object_size = expected_size; // truncated or extended to the new size
+    free(header);
+    free(lines);
+    return memcmp(state->object, expected, expected_size) == 0;
+}
+
+/**
+ * It assembles the source in the session and from scratch, and compares the results.
+ *
+ * @param state The test state.
+ * @param src The source.
+ * @param what The edit, for the message of a mismatch.
+ * @param expect_incremental 1 if the session must have assembled only the edit, 0 if it must have assembled the
+ * source in full, or -1 if either is fine.
+ *
+ * @return The status of the assembly, or -1 if the results differ.
+ */
+static int check(TestState *state, const Source *src, const char *what, int expect_incremental) {
+    size_t size;
+    char *text = sourceJoin(src, &size);
+    AssemblyResult got = assemblySessionAssemble(state->session, text, size);
+    AssemblyResult expected = assemble("test", text, size, &state->options);
+    free(text);
+
+    size_t first = 0, end = 0;
+    bool incremental = assemblySessionGetChangedWords(state->session, &first, &end);
+    state->assemblies++;
+    state->incremental += incremental;
+
+    AssemblyStatus status = assemblyResultGetStatus(expected);
+    bool same = assemblyResultGetStatus(got) == status &&
+                assemblyResultGetDiagnosticsCount(got) == assemblyResultGetDiagnosticsCount(expected);
+    for (int i = 0; same && i < assemblyResultGetDiagnosticsCount(got); ++i) {
+        same = strcmp(assemblyResultGetDiagnosticAt(got, i)->message,
+                      assemblyResultGetDiagnosticAt(expected, i)->message) == 0;
+    }
+
+    size_t got_size, expected_size;
+    if (same && status != ASSEMBLY_PRE_ASSEMBLY_FAILED) {
+        const char *got_am = assemblyResultGetAm(got, &got_size);
+        const char *expected_am = assemblyResultGetAm(expected, &expected_size);
+        same = got_size == expected_size && memcmp(got_am, expected_am, got_size) == 0;
+    }
+    if (same && status == ASSEMBLY_SUCCESS) {
+        char *got_ob = assemblyResultRenderObjectFile(got, &got_size);
+        char *expected_ob = assemblyResultRenderObjectFile(expected, &expected_size);
+        if (incremental && state->object && !patchObject(state, got, first, end, expected_ob, expected_size)) {
+            printf("%s: the patched object file differs (changed words [%zu, %zu))\n", what, first, end);
+            same = false;
+        }
+        free(state->object);
+        state->object = malloc(expected_size);
+        memcpy(state->object, expected_ob, expected_size);
+        state->object_size = expected_size;
+        same = sameRendered(got_ob, got_size, expected_ob, expected_size) && same;
+
+        char *got_ent = assemblyResultRenderEntriesFile(got, &got_size);
+        char *expected_ent = assemblyResultRenderEntriesFile(expected, &expected_size);
+        same = sameRendered(got_ent, got_size, expected_ent, expected_size) && same;
+        char *got_ext = assemblyResultRenderExternalFile(got, &got_size);
+        char *expected_ext = assemblyResultRenderExternalFile(expected, &expected_size);
+        same = sameRendered(got_ext, got_size, expected_ext, expected_size) && same;
+    } else {
+        free(state->object); // the next successful assembly is a full one
+        state->object = NULL;
+    }
+    assemblyResultDestroy(expected);
+
+    if (!same) {
+        printf("%s: the session's result differs from a full assembly (incremental: %d)\n", what, incremental);
+        return -1;
+    }
+    if (expect_incremental != -1 && incremental != expect_incremental) {
+        printf("%s: expected %s assembly\n", what, expect_incremental ? "an incremental" : "a full");
+        return -1;
+    }
+    return (int) status;
+}
+
+/**
+ * It runs the edits that each exercise one rule of the incremental path.
+ *
+ * @return false if a result differs, true otherwise.
+ */
+static bool runTargetedEdits(TestState *state, Source *src) {
+    int first_prn = 0;
+    while (!strstr(src->lines[first_prn], "prn"))
+        first_prn++;
+    int entry_line = 0;
+    while (!strstr(src->lines[entry_line], ".entry"))
+        entry_line++;
+
+    return check(state, src, "the first assembly", 0) == ASSEMBLY_SUCCESS &&
+           check(state, src, "an unchanged source", 1) == ASSEMBLY_SUCCESS &&
+           (sourceReplace(src, first_prn, "        prn #-77\n"),
+                   check(state, src, "an immediate changed in place", 1) == ASSEMBLY_SUCCESS) &&
+           (sourceInsert(src, first_prn, "        inc r1\n"),
+                   check(state, src, "code inserted before labels (the symbols shift)", 1) == ASSEMBLY_SUCCESS) &&
+           (sourceInsert(src, first_prn, "X1:    .data 9,8,7\n"),
+                   check(state, src, "a new symbol", 0) == ASSEMBLY_SUCCESS) &&
+           (sourceDelete(src, first_prn), sourceDelete(src, first_prn),
+                   check(state, src, "the inserted lines deleted again", 0) == ASSEMBLY_SUCCESS) &&
+           (sourceInsert(src, first_prn, "        get r2\n"), sourceInsert(src, first_prn, "        clr r3\n"),
+                   check(state, src, "two lines inserted together", 1) == ASSEMBLY_SUCCESS) &&
+           (sourceDelete(src, first_prn), sourceDelete(src, first_prn),
+                   check(state, src, "two lines deleted together (the symbols shift back)", 1) ==
+                   ASSEMBLY_SUCCESS) &&
+           (sourceReplace(src, first_prn + 2, "K0:    .data 1,2,3,4,5,6\n"),
+                   check(state, src, "data grown in place (the data symbols shift)", -1) == ASSEMBLY_SUCCESS) &&
+           (sourceReplace(src, entry_line, ".entry K1\n"),
+                   check(state, src, "a changed .entry", 0) == ASSEMBLY_SUCCESS) &&
+           (sourceReplace(src, src->count - 1, "        rts"),
+                   check(state, src, "the last line, without a '\\n', changed", 1) == ASSEMBLY_SUCCESS) &&
+           (sourceReplace(src, src->count - 1, "        rts\n"),
+                   check(state, src, "a '\\n' added to the last line", -1) == ASSEMBLY_SUCCESS) &&
+           (sourceInsert(src, src->count, "        hlt"),
+                   check(state, src, "a line appended without a '\\n'", 1) == ASSEMBLY_SUCCESS) &&
+           (sourceReplace(src, first_prn, "        prn #1, #2\n"),
+                   check(state, src, "an error", 0) == ASSEMBLY_FIRST_PASS_FAILED) &&
+           (sourceReplace(src, first_prn, "        prn #3\n"),
+                   check(state, src, "the error fixed", 0) == ASSEMBLY_SUCCESS);
+}
+
+/**
+ * It makes a random edit to the source.
+ *
+ * @param src The source.
+ * @param what Set to the edit, for the message of a mismatch.
+ */
+static void randomEdit(Source *src, const char **what) {
+    int at = rand() % (src->count + 1);
+    char line[LINE_SIZE];
+    switch (rand() % 6) {
+        case 0:
+            *what = "a line inserted";
+            sourceInsert(src, at, inserted_lines[rand() % (sizeof(inserted_lines) / sizeof(*inserted_lines))]);
+            break;
+        case 1:
+            *what = "a line deleted";
+            if (at < src->count)
+                sourceDelete(src, at);
+            break;
+        case 2:
+            *what = "a line duplicated";
+            if (at < src->count)
+                sourceInsert(src, at, src->lines[rand() % src->count]);
+            break;
+        case 3: { // a digit of the line changed - an immediate, a register, a label or the size of the data
+            *what = "a digit changed";
+            char *digit = at < src->count ? strpbrk(src->lines[at], "0123456789") : NULL;
+            if (digit)
+                *digit = (char) ('0' + rand() % 10);
+            break;
+        }
+        case 4:
+            *what = "two edits far apart";
+            if (at < src->count) {
+                snprintf(line, sizeof(line), "        prn #%d\n", rand() % 300);
+                sourceInsert(src, at, line);
+                sourceInsert(src, rand() % src->count, "        inc r2\n");
+            }
+            break;
+        default:
+            *what = "a line replaced";
+            if (at < src->count)
+                sourceReplace(src, at, inserted_lines[rand() % 5]);
+            break;
+    }
+}
+
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <iterations> <seed> [keep-am]\n", argv[0]);
+        return 2;
+    }
+    int iterations = atoi(argv[1]);
+    srand((unsigned) atoi(argv[2]));
+
+    TestState state = {NULL, {argc > 3}, NULL, 0, 0, 0};
+    state.session = assemblySessionCreate("test", &state.options);
+    Source src = {NULL, 0}, good = {NULL, 0};
+    generateSource(&src);
+
+    bool passed = runTargetedEdits(&state, &src);
+    sourceCopy(&good, &src);
+    for (int i = 0; passed && i < iterations; ++i) {
+        const char *what = "";
+        randomEdit(&src, &what);
+        int status = check(&state, &src, what, -1);
+        passed = status != -1;
+        /* Most edits that break the source are undone, so the session keeps assembling incrementally. */
+        if (status == ASSEMBLY_SUCCESS) {
+            sourceCopy(&good, &src);
+        } else if (rand() % 4 != 0) {
+            sourceCopy(&src, &good);
+        }
+    }
+
+    printf("%d assemblies, %d of them incremental\n", state.assemblies, state.incremental);
+    if (passed && state.incremental < state.assemblies / 4) {
+        printf("too few incremental assemblies - the edits don't exercise the incremental path\n");
+        passed = false;
+    }
+    sourceFree(&src);
+    sourceFree(&good);
+    free(state.object);
+    assemblySessionDestroy(state.session);
+    return passed ? 0 : 1;
+}
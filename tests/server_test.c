@@ -0,0 +1,106 @@
+/*
+ * Starts the assembler as a server and checks that a source that used to crash it - a macro without a name - is
+ * answered with a diagnostic, and that the server still answers the next client.
+ *
+ * usage: server_test <assembler>
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "protocol.h"
+
+#define CONNECT_ATTEMPTS 500
+#define CONNECT_INTERVAL_US 10000
+
+
+/**
+ * It connects to the server, waiting for it to start listening.
+ *
+ * @return The connected socket, or -1 if the server doesn't come up.
+ */
+static int connectToServer(const char *socket_path) {
+    struct sockaddr_un addr;
+    if (!protocolSocketAddress(socket_path, &addr))
+        return -1;
+    for (int i = 0; i < CONNECT_ATTEMPTS; ++i) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd != -1 && connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0)
+            return fd;
+        if (fd != -1)
+            close(fd);
+        usleep(CONNECT_INTERVAL_US);
+    }
+    return -1;
+}
+
+/**
+ * It has the server assemble a source, on a connection of its own, and checks its status and diagnostics.
+ *
+ * @return true if the server answered as expected, false otherwise.
+ */
+static bool checkSource(const char *socket_path, const char *source, AssemblyStatus expected_status,
+                        const char *expected_diagnostic) {
+    int fd = connectToServer(socket_path);
+    if (fd == -1) {
+        printf("can't connect to the server\n");
+        return false;
+    }
+
+    Message request, response;
+    protocolMessageInit(&request, REQUEST_ASSEMBLE_SOURCE, 0);
+    protocolMessageAddBlob(&request, "test", strlen("test"));
+    protocolMessageAddBlob(&request, source, strlen(source));
+    bool ok = protocolSend(fd, &request) && protocolReceive(fd, &response);
+    close(fd);
+    if (!ok) {
+        printf("no response to \"%s\" - the server went down\n", source);
+        return false;
+    }
+
+    ok = response.type == (uint32_t) expected_status && response.num_blobs >= 1 &&
+         (!expected_diagnostic || strstr(response.blobs[0], expected_diagnostic));
+    if (!ok)
+        printf("unexpected response to \"%s\": status %u, diagnostics \"%s\"\n", source, response.type,
+               response.num_blobs >= 1 ? response.blobs[0] : "");
+    protocolMessageFree(&response);
+    return ok;
+}
+
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <assembler>\n", argv[0]);
+        return 2;
+    }
+
+    char socket_path[] = "/tmp/assembler_server_test_XXXXXX";
+    int tmp_fd = mkstemp(socket_path);
+    if (tmp_fd == -1)
+        return 2;
+    close(tmp_fd);
+
+    pid_t server = fork();
+    if (server == 0) {
+        freopen("/dev/null", "w", stdout);
+        execl(argv[1], argv[1], "--server", socket_path, (char *) NULL);
+        _exit(127);
+    }
+
+    bool ok = checkSource(socket_path, "macro\n", ASSEMBLY_PRE_ASSEMBLY_FAILED, "Missing macro name") &&
+              checkSource(socket_path, "macro\ninc r1\nendmacro\nhlt\n", ASSEMBLY_PRE_ASSEMBLY_FAILED,
+                          "Missing macro name") &&
+              checkSource(socket_path, "MAIN: inc r1\nhlt\n", ASSEMBLY_SUCCESS, NULL);
+
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    unlink(socket_path);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "thread_pool.h"
+#include "errors.h"
+
+#define NO_JOB -1
+
+
+/* The jobs of one worker, as indices into the args - the worker takes them from the front, and idle workers steal
+ * them from the back. */
+typedef struct {
+    pthread_mutex_t lock;
+    int *jobs;
+    int head;
+    int tail;
+} WorkDeque;
+
+typedef struct {
+    WorkDeque *deques;
+    int num_workers;
+    thread_pool_job job;
+    void **args;
+} ThreadPool;
+
+typedef struct {
+    ThreadPool *pool;
+    int id;
+} Worker;
+
+/**
+ * It takes the first job of a deque.
+ *
+ * @param deque The deque to take the job from.
+ *
+ * @return The index of the job, or NO_JOB if the deque is empty.
+ */
+static int dequePopFront(WorkDeque *deque) {
+    pthread_mutex_lock(&deque->lock);
+    int job_index = deque->head < deque->tail ? deque->jobs[deque->head++] : NO_JOB;
+    pthread_mutex_unlock(&deque->lock);
+    return job_index;
+}
+
+/**
+ * It takes the last job of a deque.
+ *
+ * @param deque The deque to take the job from.
+ *
+ * @return The index of the job, or NO_JOB if the deque is empty.
+ */
+static int dequePopBack(WorkDeque *deque) {
+    pthread_mutex_lock(&deque->lock);
+    int job_index = deque->head < deque->tail ? deque->jobs[--deque->tail] : NO_JOB;
+    pthread_mutex_unlock(&deque->lock);
+    return job_index;
+}
+
+/**
+ * It runs the jobs of a worker, and then steals the jobs of the other workers until there are none left. No jobs are
+ * added once the workers start, so a worker that finds all the deques empty is done.
+ *
+ * @param arg The worker.
+ */
+static void *workerRun(void *arg) {
+    Worker *worker = arg;
+    ThreadPool *pool = worker->pool;
+
+    for (;;) {
+        int job_index = dequePopFront(&pool->deques[worker->id]);
+        for (int i = 1; job_index == NO_JOB && i < pool->num_workers; ++i) {
+            job_index = dequePopBack(&pool->deques[(worker->id + i) % pool->num_workers]);
+        }
+        if (job_index == NO_JOB)
+            return NULL;
+
+        pool->job(pool->args[job_index]);
+    }
+}
+
+/**
+ * It runs a job for each of the args on a work-stealing pool of threads, and waits for all of them to finish. The
+ * args are dealt to the workers in order, and every worker starts from the front of its share, so the args should be
+ * sorted by priority - the most expensive job first.
+ *
+ * @param num_threads The number of threads to run the jobs on, including the calling thread.
+ * @param job The job to run.
+ * @param args The args to run the job for.
+ * @param num_args The number of args.
+ */
+void threadPoolRun(int num_threads, thread_pool_job job, void **args, int num_args) {
+    if (num_args <= 0)
+        return;
+    int num_workers = num_threads < num_args ? num_threads : num_args;
+    if (num_workers < 1)
+        num_workers = 1;
+
+    ThreadPool pool = {NULL, num_workers, job, args};
+    pool.deques = malloc(num_workers * sizeof(*pool.deques));
+    Worker *workers = malloc(num_workers * sizeof(*workers));
+    pthread_t *threads = malloc(num_workers * sizeof(*threads));
+    int *jobs = malloc(num_args * sizeof(*jobs));
+    if (!pool.deques || !workers || !threads || !jobs)
+        memoryAllocationError();
+
+    /* Worker i gets the args i, i + num_workers, i + 2 * num_workers... stored contiguously in jobs. */
+    int next = 0;
+    for (int i = 0; i < num_workers; ++i) {
+        WorkDeque *deque = &pool.deques[i];
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->jobs = &jobs[next];
+        deque->head = 0;
+        deque->tail = 0;
+        for (int j = i; j < num_args; j += num_workers) {
+            deque->jobs[deque->tail++] = j;
+        }
+        next += deque->tail;
+
+        workers[i].pool = &pool;
+        workers[i].id = i;
+    }
+
+    /* The calling thread is worker 0. If a thread can't be started, its jobs are stolen by the others. */
+    int num_started = 0;
+    for (int i = 1; i < num_workers; ++i) {
+        if (pthread_create(&threads[i], NULL, workerRun, &workers[i]) != 0)
+            break;
+        num_started = i;
+    }
+    workerRun(&workers[0]);
+    for (int i = 1; i <= num_started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i < num_workers; ++i) {
+        pthread_mutex_destroy(&pool.deques[i].lock);
+    }
+    free(jobs);
+    free(threads);
+    free(workers);
+    free(pool.deques);
+}
@@ -0,0 +1,8 @@
+#ifndef ASSEMBLER_THREAD_POOL_H
+#define ASSEMBLER_THREAD_POOL_H
+
+typedef void (*thread_pool_job)(void *arg);
+
+void threadPoolRun(int num_threads, thread_pool_job job, void **args, int num_args);
+
+#endif //ASSEMBLER_THREAD_POOL_H
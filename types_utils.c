@@ -15,20 +15,6 @@ bool isString(const char *str) {
     return str[0] == '\"' && str[strlen(str) - 1] == '\"';
 }
 
-/**
- * It checks if the string is alphabetic.
- *
- * @param str The string to check
- */
-bool isAlpha(const char *str) {
-    for (int i = 0; str[i] != '\0'; i++) {
-        if (!isalpha(str[i])) {
-            return false;
-        }
-    }
-    return true;
-}
-
 /**
  * It checks if the string is a number.
  *
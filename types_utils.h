@@ -11,8 +11,6 @@ bool isNumeric(const char *str);
 
 bool isAlphaNumeric(const char *str);
 
-bool isAlpha(const char *str);
-
 bool isString(const char *str);
 
 #endif //ASSEMBLER_TYPES_UTILS_H
@@ -0,0 +1,172 @@
+#include "vector.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "errors.h"
+
+#define VECTOR_INITIAL_CAPACITY 16
+
+
+/* A generic dynamic array of pointers */
+struct vector_t {
+    void **data;
+    int length;
+    int capacity;
+
+    vector_free vfree;
+};
+
+/**
+ * It creates an empty vector.
+ *
+ * @param vfree a function that frees the data in the vector, or NULL if the vector only borrows its data
+ */
+Vector vectorCreate(vector_free vfree) {
+    Vector v = (Vector) malloc(sizeof(*v));
+    if (!v)
+        memoryAllocationError();
+
+    v->data = NULL;
+    v->length = 0;
+    v->capacity = 0;
+    v->vfree = vfree;
+
+    return v;
+}
+
+/**
+ * Adds the data at the end of the vector, doubling the capacity when it is full.
+ *
+ * @param v the vector to append to
+ * @param data the data the vector holds
+ */
+static void vectorPush(Vector v, void *data) {
+    if (v->length == v->capacity) {
+        int new_capacity = v->capacity ? 2 * v->capacity : VECTOR_INITIAL_CAPACITY;
+        void **new_data_array = realloc(v->data, sizeof(*v->data) * new_capacity);
+        if (!new_data_array)
+            memoryAllocationError();
+
+        v->data = new_data_array;
+        v->capacity = new_capacity;
+    }
+    v->data[v->length++] = data;
+}
+
+/**
+ * Adds the data at the end of the vector, without copying it. The vector takes ownership of the data.
+ *
+ * @param v the vector to append to
+ * @param new_data the data to be moved into the vector
+ */
+VectorResult vectorAppendMove(Vector v, void *new_data) {
+    if (!v || !new_data)
+        return VECTOR_NULL_ARGUMENT;
+
+    vectorPush(v, new_data);
+    return VECTOR_SUCCESS;
+}
+
+/**
+ * It returns the number of elements in the vector.
+ *
+ * @param v a pointer to a vector
+ */
+int vectorLength(Vector v) {
+    return v->length;
+}
+
+/**
+ * It returns the data at the given index.
+ *
+ * @param v The vector to get the data from.
+ * @param index the index of the element you want to get the data of
+ */
+void *vectorGetDataAt(Vector v, int index) {
+    if (!v || index < 0 || index >= v->length)
+        return NULL;
+    return v->data[index];
+}
+
+/**
+ * It returns an iterator to the first element of the vector.
+ *
+ * @param v The vector to iterate over.
+ */
+VectorIterator vectorBegin(Vector v) {
+    return v->data;
+}
+
+/**
+ * It returns an iterator past the last element of the vector.
+ *
+ * @param v The vector to iterate over.
+ */
+VectorIterator vectorEnd(Vector v) {
+    return v->data + v->length;
+}
+
+/**
+ * It replaces a range of the elements of the vector with other elements, without copying them. The elements that are
+ * replaced aren't freed, like in a vector that only borrows its data.
+ *
+ * @param v The vector.
+ * @param index The index of the first element to replace.
+ * @param count The number of elements to replace.
+ * @param new_data The elements to put instead, which the vector takes ownership of.
+ * @param new_count The number of new elements.
+ */
+void vectorSplice(Vector v, int index, int count, void *const *new_data, int new_count) {
+    int length = v->length - count + new_count;
+    if (length > v->capacity) {
+        int new_capacity = v->capacity ? v->capacity : VECTOR_INITIAL_CAPACITY;
+        while (length > new_capacity) {
+            new_capacity *= 2;
+        }
+        void **new_data_array = realloc(v->data, sizeof(*v->data) * new_capacity);
+        if (!new_data_array)
+            memoryAllocationError();
+
+        v->data = new_data_array;
+        v->capacity = new_capacity;
+    }
+    memmove(v->data + index + new_count, v->data + index + count, (v->length - index - count) * sizeof(*v->data));
+    if (new_count)
+        memcpy(v->data + index, new_data, new_count * sizeof(*v->data));
+    v->length = length;
+}
+
+/**
+ * It removes all the elements of the vector, keeping its capacity.
+ *
+ * @param v The vector to clear.
+ */
+void vectorClear(Vector v) {
+    if (!v)
+        return;
+
+    if (v->vfree) {
+        for (int i = 0; i < v->length; ++i) {
+            v->vfree(v->data[i]);
+        }
+    }
+    v->length = 0;
+}
+
+/**
+ * It destroys the vector - frees the memory.
+ *
+ * @param v A pointer to a Vector to destroy.
+ */
+void vectorDestroy(Vector v) {
+    if (!v)
+        return;
+
+    if (v->vfree) {
+        for (int i = 0; i < v->length; ++i) {
+            v->vfree(v->data[i]);
+        }
+    }
+    free(v->data);
+    free(v);
+}
@@ -0,0 +1,36 @@
+#ifndef ASSEMBLER_VECTOR_H
+#define ASSEMBLER_VECTOR_H
+
+#include <stdbool.h>
+
+typedef void (*vector_free)(void *);
+
+typedef struct vector_t *Vector;
+
+/** an iterator over the elements of a Vector, valid until the next append */
+typedef void *const *VectorIterator;
+
+/** possible return values */
+typedef enum {
+    VECTOR_SUCCESS, VECTOR_NULL_ARGUMENT
+} VectorResult;
+
+Vector vectorCreate(vector_free vfree);
+
+VectorResult vectorAppendMove(Vector v, void *new_data);
+
+int vectorLength(Vector v);
+
+void *vectorGetDataAt(Vector v, int index);
+
+VectorIterator vectorBegin(Vector v);
+
+VectorIterator vectorEnd(Vector v);
+
+void vectorSplice(Vector v, int index, int count, void *const *new_data, int new_count);
+
+void vectorClear(Vector v);
+
+void vectorDestroy(Vector v);
+
+#endif //ASSEMBLER_VECTOR_H
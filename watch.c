@@ -0,0 +1,159 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "watch.h"
+#include "errors.h"
+#include "str_utils.h"
+#include "file_utils.h"
+
+#define WATCH_DEBOUNCE_MS 20 // how long the directories must be quiet before the changed files are assembled
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO) // a file written in place, or a new version renamed over it
+#define EVENT_BUF_SIZE (64 * (sizeof(struct inotify_event) + NAME_MAX + 1))
+#define ERROR_MSG_SIZE 256
+
+
+/* A file that is watched, and assembled again whenever its source is saved. */
+typedef struct {
+    const char *filename; // without suffix
+    char *dir; // the directory of its source
+    char *source_name; // the name of its source in the directory
+    int wd; // the watch of the directory
+    IncrementalFile file; // the state of its last assembly, kept warm between saves
+    bool changed;
+} WatchedFile;
+
+
+/**
+ * It splits the name of a file to watch into the directory and the name of its source, and watches the directory. The
+ * directory is watched rather than the source itself, since editors often save a file by writing a new version and
+ * renaming it over the old one, which would end a watch on the old one.
+ *
+ * @param fd The inotify instance.
+ * @param watched The file, with its name set.
+ */
+static void watchFile(int fd, WatchedFile *watched) {
+    const char *slash = strrchr(watched->filename, '/');
+    const char *base = slash ? slash + 1 : watched->filename;
+    watched->dir = slash ? strndup(watched->filename, slash == watched->filename ? 1 : slash - watched->filename)
+                         : strdup(".");
+    watched->source_name = strConcat(base, SOURCE_FILE_SUFFIX);
+    if (!watched->dir)
+        memoryAllocationError();
+
+    /* A directory that is already watched gets the same watch back. */
+    if ((watched->wd = inotify_add_watch(fd, watched->dir, WATCH_EVENTS)) == -1) {
+        char msg[ERROR_MSG_SIZE];
+        snprintf(msg, sizeof(msg), "Can't watch the directory %s: %s\n", watched->dir, strerror(errno));
+        errorWithMsg(msg);
+    }
+}
+
+/**
+ * It reads the pending events of the watched directories, and marks the files whose source was saved.
+ *
+ * @param fd The inotify instance.
+ * @param files The watched files.
+ * @param files_count The number of files.
+ *
+ * @return true if a file was marked, false otherwise.
+ */
+static bool readEvents(int fd, WatchedFile *files, int files_count) {
+    char buf[EVENT_BUF_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool marked = false;
+
+    ssize_t len = read(fd, buf, sizeof(buf));
+    if (len == -1 && errno != EINTR && errno != EAGAIN)
+        errorWithMsg("Can't read the events of the watched files!\n");
+    for (char *p = buf; len > 0 && p < buf + len;) {
+        const struct inotify_event *event = (const struct inotify_event *) p;
+        for (int i = 0; i < files_count; ++i) {
+            /* When events were lost, any of the files may have changed. */
+            if ((event->mask & IN_Q_OVERFLOW) ||
+                (event->wd == files[i].wd && event->len && strcmp(event->name, files[i].source_name) == 0)) {
+                files[i].changed = true;
+                marked = true;
+            }
+        }
+        p += sizeof(struct inotify_event) + event->len;
+    }
+    return marked;
+}
+
+/**
+ * It assembles a watched file, printing the messages about it. A source that can't be opened is reported, and the
+ * file is watched on, in case it is saved again.
+ *
+ * @param watched The file.
+ * @param options The options to assemble it with.
+ *
+ * @return false if a file can't be opened, true otherwise.
+ */
+static bool assembleWatchedFile(WatchedFile *watched, const FileAssemblyOptions *options) {
+    const char *failed_suffix;
+    watched->changed = false;
+    bool assembled = assembleFileIncrementally(watched->file, watched->filename, watched->filename, options, stdout,
+                                               &failed_suffix);
+    if (!assembled)
+        printf("File %s%s not found\n", watched->filename, failed_suffix);
+    fflush(stdout);
+    return assembled;
+}
+
+/**
+ * It assembles the files, and then watches their sources, until the process is killed. Whenever a source is saved, its
+ * file is assembled again, with the same messages and output files as assembling it from the command line. The events
+ * of a burst of saves are coalesced - the files are assembled once the directories are quiet for WATCH_DEBOUNCE_MS -
+ * and every file keeps the state of its last assembly, so that usually only the lines that were edited are assembled
+ * again. A source doesn't depend on any other file, as macros are defined in the source itself, so only the sources
+ * are watched.
+ *
+ * @param files The names of the files to compile (without suffix).
+ * @param files_count The number of files.
+ * @param options The options to assemble the files with.
+ */
+void watchRun(const char **files, int files_count, const FileAssemblyOptions *options) {
+    fileUtilsDisableMapping(); // an editor may truncate a source while it is assembled
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd == -1)
+        errorWithMsg("Can't watch the files! inotify isn't available.\n");
+
+    WatchedFile *watched = calloc(files_count, sizeof(*watched));
+    if (!watched)
+        memoryAllocationError();
+    for (int i = 0; i < files_count; ++i) {
+        watched[i].filename = files[i];
+        watchFile(fd, &watched[i]);
+        watched[i].file = incrementalFileCreate(files[i], &options->assembly);
+    }
+
+    /* The files are watched before they are first assembled, so a save during the first assembly isn't missed. */
+    for (int i = 0; i < files_count; ++i) {
+        const char *failed_suffix;
+        if (!assembleFileIncrementally(watched[i].file, files[i], files[i], options, stdout, &failed_suffix))
+            fileNotFoundError(strConcat(files[i], failed_suffix)); // like assembling the files from the command line
+    }
+    printf("Watching %d file%s for changes\n", files_count, files_count == 1 ? "" : "s");
+    fflush(stdout);
+
+    struct pollfd pfd = {fd, POLLIN, 0};
+    for (;;) {
+        if (poll(&pfd, 1, -1) <= 0 || !readEvents(fd, watched, files_count))
+            continue;
+        while (poll(&pfd, 1, WATCH_DEBOUNCE_MS) > 0) {
+            readEvents(fd, watched, files_count);
+        }
+
+        for (int i = 0; i < files_count; ++i) {
+            if (watched[i].changed)
+                assembleWatchedFile(&watched[i], options);
+        }
+    }
+}
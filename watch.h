@@ -0,0 +1,8 @@
+#ifndef ASSEMBLER_WATCH_H
+#define ASSEMBLER_WATCH_H
+
+#include "file_assembly.h"
+
+void watchRun(const char **files, int files_count, const FileAssemblyOptions *options);
+
+#endif //ASSEMBLER_WATCH_H